@@ -31,6 +31,8 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 //#define DEBUG(args...)    fprintf(stderr,"debug: " args) /* diagnostic message that is destined to the user */
 #define DEBUG(args...)
 
+#define CODE_INVALID        0xFF
+
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE CONSTANTS ---------------------------------------------------- */
 
@@ -50,7 +52,7 @@ static char code_pad = '=';    /* RFC 1421 padding character if padding */
 char code_to_char(uint8_t x);
 
 /**
-@brief Convert an ASCII character to a code in the range 0-63
+@brief Convert an ASCII character to a code in the range 0-63, CODE_INVALID if the character is not base64
 */
 uint8_t char_to_code(char x);
 
@@ -87,8 +89,8 @@ uint8_t char_to_code(char x) {
         return 63;
     } else {
         DEBUG("ERROR: %c (0x%x) IS INVALID CHARACTER FOR BASE64 DECODING\n", x, x);
-        exit(EXIT_FAILURE);
-    } //TODO: improve error management
+        return CODE_INVALID; /* the input comes from outside, let the caller fail instead of exiting */
+    }
 }
 
 /* -------------------------------------------------------------------------- */
@@ -175,7 +177,6 @@ int b64_to_bin_nopad(const char * in, int size, uint8_t * out, int max_len) {
     int last_chars; /* number of characters <4 in the last block */
     int last_bytes; /* number of unsigned chars <3 in the last block */
     uint32_t b;
-    ;
 
     /* check input values */
     if ((out == NULL) || (in == NULL)) {
@@ -213,6 +214,13 @@ int b64_to_bin_nopad(const char * in, int size, uint8_t * out, int max_len) {
         return -1;
     }
 
+    /* check all the characters before writing anything */
+    for (i=0; i < size; ++i) {
+        if (char_to_code(in[i]) == CODE_INVALID) {
+            return -1;
+        }
+    }
+
     /* process all the full blocks */
     for (i=0; i < full_blocks; ++i) {
         b  = (0x3F & char_to_code(in[4*i]    )) << 18;
@@ -206,6 +206,29 @@ static unsigned char* cJSON_strdup(const unsigned char* string, const internal_h
     return copy;
 }
 
+/* convert user supplied hooks into internal hooks, missing functions fall back to the stdlib */
+static void hooks_from_public(internal_hooks * const internal, const cJSON_Hooks * const hooks)
+{
+    internal->allocate = malloc;
+    if (hooks->malloc_fn != NULL)
+    {
+        internal->allocate = hooks->malloc_fn;
+    }
+
+    internal->deallocate = free;
+    if (hooks->free_fn != NULL)
+    {
+        internal->deallocate = hooks->free_fn;
+    }
+
+    /* use realloc only if both free and malloc are used */
+    internal->reallocate = NULL;
+    if ((internal->allocate == malloc) && (internal->deallocate == free))
+    {
+        internal->reallocate = realloc;
+    }
+}
+
 CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks)
 {
     if (hooks == NULL)
@@ -217,23 +240,20 @@ CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks)
         return;
     }
 
-    global_hooks.allocate = malloc;
-    if (hooks->malloc_fn != NULL)
-    {
-        global_hooks.allocate = hooks->malloc_fn;
-    }
+    hooks_from_public(&global_hooks, hooks);
+}
 
-    global_hooks.deallocate = free;
-    if (hooks->free_fn != NULL)
+CJSON_PUBLIC(void) cJSON_InitContext(cJSON_Context * const context, const cJSON_Hooks * const hooks)
+{
+    if (context == NULL)
     {
-        global_hooks.deallocate = hooks->free_fn;
+        return;
     }
 
-    /* use realloc only if both free and malloc are used */
-    global_hooks.reallocate = NULL;
-    if ((global_hooks.allocate == malloc) && (global_hooks.deallocate == free))
+    memset(context, '\0', sizeof(cJSON_Context));
+    if (hooks != NULL)
     {
-        global_hooks.reallocate = realloc;
+        context->hooks = *hooks;
     }
 }
 
@@ -249,8 +269,8 @@ static cJSON *cJSON_New_Item(const internal_hooks * const hooks)
     return node;
 }
 
-/* Delete a cJSON structure. */
-CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
+/* Delete a cJSON structure with the hooks it was allocated with. */
+static void delete_item(cJSON *item, const internal_hooks * const hooks)
 {
     cJSON *next = NULL;
     while (item != NULL)
@@ -258,23 +278,43 @@ CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
         next = item->next;
         if (!(item->type & cJSON_IsReference) && (item->child != NULL))
         {
-            cJSON_Delete(item->child);
+            delete_item(item->child, hooks);
         }
         if (!(item->type & cJSON_IsReference) && (item->valuestring != NULL))
         {
-            global_hooks.deallocate(item->valuestring);
+            hooks->deallocate(item->valuestring);
             item->valuestring = NULL;
         }
         if (!(item->type & cJSON_StringIsConst) && (item->string != NULL))
         {
-            global_hooks.deallocate(item->string);
+            hooks->deallocate(item->string);
             item->string = NULL;
         }
-        global_hooks.deallocate(item);
+        hooks->deallocate(item);
         item = next;
     }
 }
 
+/* Delete a cJSON structure. */
+CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
+{
+    delete_item(item, &global_hooks);
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteWithContext(const cJSON_Context * const context, cJSON *item)
+{
+    internal_hooks hooks;
+
+    if (context == NULL)
+    {
+        cJSON_Delete(item);
+        return;
+    }
+
+    hooks_from_public(&hooks, &context->hooks);
+    delete_item(item, &hooks);
+}
+
 /* get the decimal point character of the current locale */
 static unsigned char get_decimal_point(void)
 {
@@ -303,6 +343,144 @@ typedef struct
 /* get a pointer to the buffer at the position */
 #define buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
 
+/* Numbers with at most 15 significant digits and a decimal exponent within +-22 can be converted exactly
+ * with a single multiplication or division (Clinger's fast path), short integers need no floating point
+ * at all. This covers nearly every number found in real documents, everything else goes through strtod. */
+static const double exact_powers_of_ten[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define is_decimal_digit(c) (((c) >= '0') && ((c) <= '9'))
+#define is_number_character(c) (is_decimal_digit(c) || ((c) == '+') || ((c) == '-') || ((c) == '.') || ((c) == 'e') || ((c) == 'E'))
+
+/* Convert a well formed number without strtod. Returns false if the number is malformed or can't be
+ * converted exactly this way, the caller has to fall back to strtod then. */
+static cJSON_bool parse_number_fast(const unsigned char * const input, size_t length, double * const number, size_t * const consumed)
+{
+    size_t i = 0;
+    cJSON_bool negative = false;
+    cJSON_bool is_integer = true;
+    cJSON_bool exponent_negative = false;
+    unsigned long integer = 0;
+    double mantissa = 0;
+    int digits = 0; /* significant digits in mantissa */
+    int exponent = 0;
+    int explicit_exponent = 0;
+
+    if ((i < length) && (input[i] == '-'))
+    {
+        negative = true;
+        i++;
+    }
+
+    if ((i >= length) || !is_decimal_digit(input[i]))
+    {
+        return false;
+    }
+
+    for (; (i < length) && is_decimal_digit(input[i]); i++)
+    {
+        if ((digits == 0) && (input[i] == '0'))
+        {
+            continue; /* leading zero */
+        }
+        if (++digits > 15)
+        {
+            return false;
+        }
+        mantissa = (mantissa * 10) + (input[i] - '0');
+        if (digits <= 9)
+        {
+            /* 9 digits always fit into an unsigned long */
+            integer = (integer * 10) + (unsigned long)(input[i] - '0');
+        }
+    }
+
+    if ((i < length) && (input[i] == '.'))
+    {
+        is_integer = false;
+        i++;
+        if ((i >= length) || !is_decimal_digit(input[i]))
+        {
+            return false;
+        }
+        for (; (i < length) && is_decimal_digit(input[i]); i++)
+        {
+            exponent--;
+            if ((digits == 0) && (input[i] == '0'))
+            {
+                continue;
+            }
+            if (++digits > 15)
+            {
+                return false;
+            }
+            mantissa = (mantissa * 10) + (input[i] - '0');
+        }
+    }
+
+    if ((i < length) && ((input[i] == 'e') || (input[i] == 'E')))
+    {
+        is_integer = false;
+        i++;
+        if ((i < length) && ((input[i] == '+') || (input[i] == '-')))
+        {
+            exponent_negative = (input[i] == '-');
+            i++;
+        }
+        if ((i >= length) || !is_decimal_digit(input[i]))
+        {
+            return false;
+        }
+        for (; (i < length) && is_decimal_digit(input[i]); i++)
+        {
+            if (explicit_exponent > 1000)
+            {
+                return false;
+            }
+            explicit_exponent = (explicit_exponent * 10) + (input[i] - '0');
+        }
+        exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+    }
+
+    /* leave malformed numbers like "1.2.3" to strtod */
+    if ((i < length) && is_number_character(input[i]))
+    {
+        return false;
+    }
+
+    if (is_integer && (digits <= 9))
+    {
+        *number = (double)integer;
+    }
+    else if (mantissa == 0)
+    {
+        *number = 0;
+    }
+    else if ((exponent >= 0) && (exponent <= 22))
+    {
+        *number = mantissa * exact_powers_of_ten[exponent];
+    }
+    else if ((exponent < 0) && (exponent >= -22))
+    {
+        *number = mantissa / exact_powers_of_ten[-exponent];
+    }
+    else
+    {
+        return false;
+    }
+
+    if (negative)
+    {
+        *number = -*number;
+    }
+    *consumed = i;
+
+    return true;
+}
+
 /* Parse the input text to generate a number, and populate the result into item. */
 static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_buffer)
 {
@@ -319,6 +497,14 @@ static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_bu
         return false;
     }
 
+    if (parse_number_fast(buffer_at_offset(input_buffer), input_buffer->length - input_buffer->offset, &number, &number_string_length))
+    {
+        cJSON_SetNumberHelper(item, number);
+        item->type = cJSON_Number;
+        input_buffer->offset += number_string_length;
+        return true;
+    }
+
     /* copy the number into a temporary buffer and replace '.' with the decimal point
      * of the current locale (for strtod)
      * This also takes care of '\0' not necessarily being available for marking the end of the input */
@@ -587,44 +773,432 @@ static cJSON_bool compare_double(double a, double b)
     return (fabs(a - b) <= maxVal * DBL_EPSILON);
 }
 
-/* Render the number nicely from the given item into a string. */
-static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer)
+/* write an unsigned integer without terminating it, returns the number of characters */
+static int format_unsigned(unsigned long value, unsigned char * const buffer)
 {
-    unsigned char *output_pointer = NULL;
-    double d = item->valuedouble;
+    unsigned char reversed[10];
     int length = 0;
-    size_t i = 0;
-    unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
-    unsigned char decimal_point = get_decimal_point();
-    double test = 0.0;
+    int i = 0;
 
-    if (output_buffer == NULL)
+    do
     {
-        return false;
+        reversed[length++] = (unsigned char)('0' + (value % 10));
+        value /= 10;
     }
+    while (value != 0);
 
-    /* This checks for NaN and Infinity */
-    if (isnan(d) || isinf(d))
+    for (i = 0; i < length; i++)
+    {
+        buffer[i] = reversed[length - 1 - i];
+    }
+
+    return length;
+}
+
+/* print an integral double with an absolute value below 1e15 */
+static int format_integral(double number, unsigned char * const buffer)
+{
+    int length = 0;
+    int low_length = 0;
+    double high = 0;
+    unsigned long low = 0;
+
+    if (number < 0)
+    {
+        buffer[length++] = '-';
+        number = -number;
+    }
+
+    /* split into two halves that fit into 32 bits */
+    high = floor(number / 1e9);
+    low = (unsigned long)(number - (high * 1e9));
+    if (high == 0)
+    {
+        return length + format_unsigned(low, buffer + length);
+    }
+
+    length += format_unsigned((unsigned long)high, buffer + length);
+    /* the lower half has to be padded to 9 digits */
+    low_length = format_unsigned(low, buffer + length);
+    memmove(buffer + length + (9 - low_length), buffer + length, (size_t)low_length);
+    memset(buffer + length, '0', (size_t)(9 - low_length));
+
+    return length + 9;
+}
+
+/* Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers") finds a
+ * digit string that reads back as the same double using 64 bit integer arithmetic only. It is the shortest one
+ * for almost all values, about 0.01% of random doubles get one or more extra digits (1e23 prints as
+ * 9.999999999999999e+22), the round-trip is always exact.
+ * Needs unsigned long long, plain C89 builds keep using sprintf. */
+#if defined(ULLONG_MAX)
+#define CJSON_GRISU2
+
+typedef struct
+{
+    unsigned long long f;
+    int e;
+} diy_fp;
+
+/* 10^k for k = -348, -340, ..., 340 as normalized 64 bit significand and binary exponent */
+static const unsigned long long cached_powers_significand[] =
+{
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+    0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+    0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+    0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+    0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+    0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+    0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+    0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+    0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+    0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+    0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+    0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+    0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+    0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+    0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+static const short cached_powers_exponent[] =
+{
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066
+};
+
+static const unsigned long long integer_powers_of_ten[] =
+{
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL
+};
+
+#define double_significand_mask 0x000FFFFFFFFFFFFFULL
+#define double_hidden_bit 0x0010000000000000ULL
+#define double_exponent_bias (0x3FF + 52)
+
+static diy_fp diy_fp_multiply(const diy_fp x, const diy_fp y)
+{
+    const unsigned long long low_mask = 0xFFFFFFFFULL;
+    const unsigned long long a = x.f >> 32;
+    const unsigned long long b = x.f & low_mask;
+    const unsigned long long c = y.f >> 32;
+    const unsigned long long d = y.f & low_mask;
+    const unsigned long long ad = a * d;
+    const unsigned long long bc = b * c;
+    unsigned long long middle = ((b * d) >> 32) + (ad & low_mask) + (bc & low_mask);
+    diy_fp product;
+
+    middle += 1ULL << 31; /* round */
+    product.f = (a * c) + (ad >> 32) + (bc >> 32) + (middle >> 32);
+    product.e = x.e + y.e + 64;
+
+    return product;
+}
+
+static diy_fp diy_fp_normalize(diy_fp value)
+{
+    while (!(value.f & 0x8000000000000000ULL))
+    {
+        value.f <<= 1;
+        value.e--;
+    }
+
+    return value;
+}
+
+/* move the last digit closer to the exact value while staying inside the rounding interval */
+static void grisu_round(unsigned char * const digits, int length, unsigned long long delta, unsigned long long rest, unsigned long long ten_kappa, unsigned long long distance)
+{
+    while ((rest < distance) && ((delta - rest) >= ten_kappa)
+           && (((rest + ten_kappa) < distance) || ((distance - rest) > ((rest + ten_kappa) - distance))))
+    {
+        digits[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static int count_decimal_digits(unsigned long value)
+{
+    int count = 1;
+
+    while ((count < 10) && (value >= (unsigned long)integer_powers_of_ten[count]))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+static int generate_digits(const diy_fp w, const diy_fp upper, unsigned long long delta, unsigned char * const digits, int * const decimal_exponent)
+{
+    const int shift = -upper.e;
+    const unsigned long long one = 1ULL << shift;
+    const unsigned long long distance = upper.f - w.f;
+    unsigned long integral = (unsigned long)(upper.f >> shift);
+    unsigned long long fraction = upper.f & (one - 1);
+    unsigned long long rest = 0;
+    unsigned long digit = 0;
+    int kappa = count_decimal_digits(integral);
+    int length = 0;
+
+    while (kappa > 0)
     {
-        length = sprintf((char*)number_buffer, "null");
+        digit = integral / (unsigned long)integer_powers_of_ten[kappa - 1];
+        integral %= (unsigned long)integer_powers_of_ten[kappa - 1];
+        if ((digit != 0) || (length != 0))
+        {
+            digits[length++] = (unsigned char)('0' + digit);
+        }
+        kappa--;
+
+        rest = ((unsigned long long)integral << shift) + fraction;
+        if (rest <= delta)
+        {
+            *decimal_exponent += kappa;
+            grisu_round(digits, length, delta, rest, integer_powers_of_ten[kappa] << shift, distance);
+            return length;
+        }
     }
-    else if(d == (double)item->valueint)
+
+    for (;;)
     {
-        length = sprintf((char*)number_buffer, "%d", item->valueint);
+        fraction *= 10;
+        delta *= 10;
+        digit = (unsigned long)(fraction >> shift);
+        if ((digit != 0) || (length != 0))
+        {
+            digits[length++] = (unsigned char)('0' + digit);
+        }
+        fraction &= one - 1;
+        kappa--;
+
+        if (fraction < delta)
+        {
+            *decimal_exponent += kappa;
+            grisu_round(digits, length, delta, fraction, one, (-kappa < 20) ? (distance * integer_powers_of_ten[-kappa]) : 0);
+            return length;
+        }
+    }
+}
+
+/* digits of a positive, finite, non zero double, so that value = digits * 10^decimal_exponent */
+static int grisu2(double value, unsigned char * const digits, int * const decimal_exponent)
+{
+    unsigned long long bits = 0;
+    int biased_exponent = 0;
+    diy_fp v;
+    diy_fp upper;
+    diy_fp lower;
+    diy_fp cached;
+    diy_fp w;
+    double dk = 0;
+    int k = 0;
+    unsigned int index = 0;
+
+    memcpy(&bits, &value, sizeof(bits));
+    biased_exponent = (int)((bits >> 52) & 0x7FF);
+    v.f = bits & double_significand_mask;
+    if (biased_exponent != 0)
+    {
+        v.f += double_hidden_bit;
+        v.e = biased_exponent - double_exponent_bias;
+    }
+    else
+    {
+        /* subnormal */
+        v.e = 1 - double_exponent_bias;
+    }
+
+    /* boundaries of the rounding interval, with the same exponent */
+    upper.f = (v.f << 1) + 1;
+    upper.e = v.e - 1;
+    while (!(upper.f & (double_hidden_bit << 1)))
+    {
+        upper.f <<= 1;
+        upper.e--;
+    }
+    upper.f <<= 64 - 52 - 2;
+    upper.e -= 64 - 52 - 2;
+
+    if (v.f == double_hidden_bit)
+    {
+        lower.f = (v.f << 2) - 1;
+        lower.e = v.e - 2;
     }
     else
     {
-        /* Try 15 decimal places of precision to avoid nonsignificant nonzero digits */
-        length = sprintf((char*)number_buffer, "%1.15g", d);
+        lower.f = (v.f << 1) - 1;
+        lower.e = v.e - 1;
+    }
+    lower.f <<= lower.e - upper.e;
+    lower.e = upper.e;
+
+    /* pick the cached power of ten that scales the binary exponent into [-60, -32] */
+    dk = ((-61 - upper.e) * 0.30102999566398114) + 347;
+    k = (int)dk;
+    if ((dk - k) > 0.0)
+    {
+        k++;
+    }
+    index = (unsigned int)((k >> 3) + 1);
+    *decimal_exponent = 348 - (int)(index * 8);
+    cached.f = cached_powers_significand[index];
+    cached.e = cached_powers_exponent[index];
+
+    w = diy_fp_multiply(diy_fp_normalize(v), cached);
+    upper = diy_fp_multiply(upper, cached);
+    lower = diy_fp_multiply(lower, cached);
+    upper.f--;
+    lower.f++;
 
-        /* Check whether the original double can be recovered */
-        if ((sscanf((char*)number_buffer, "%lg", &test) != 1) || !compare_double((double)test, d))
+    return generate_digits(w, upper, upper.f - lower.f, digits, decimal_exponent);
+}
+
+/* lay out digits * 10^decimal_exponent the way %g does */
+static int format_digits(unsigned char * const buffer, const unsigned char * const digits, int length, int decimal_exponent)
+{
+    const int point = length + decimal_exponent; /* position of the decimal point after the first digit */
+    int exponent = point - 1;
+    int offset = 0;
+
+    if ((point > 0) && (point <= 15))
+    {
+        if (decimal_exponent >= 0)
         {
-            /* If not, print with 17 decimal places of precision */
-            length = sprintf((char*)number_buffer, "%1.17g", d);
+            /* ddd000 */
+            memcpy(buffer, digits, (size_t)length);
+            memset(buffer + length, '0', (size_t)decimal_exponent);
+            return point;
         }
+
+        /* ddd.ddd */
+        memcpy(buffer, digits, (size_t)point);
+        buffer[point] = '.';
+        memcpy(buffer + point + 1, digits + point, (size_t)(length - point));
+        return length + 1;
+    }
+
+    if ((point <= 0) && (point > -4))
+    {
+        /* 0.000ddd */
+        buffer[offset++] = '0';
+        buffer[offset++] = '.';
+        memset(buffer + offset, '0', (size_t)-point);
+        offset += -point;
+        memcpy(buffer + offset, digits, (size_t)length);
+        return offset + length;
     }
 
+    /* d.ddde+XX */
+    buffer[offset++] = digits[0];
+    if (length > 1)
+    {
+        buffer[offset++] = '.';
+        memcpy(buffer + offset, digits + 1, (size_t)(length - 1));
+        offset += length - 1;
+    }
+    buffer[offset++] = 'e';
+    if (exponent < 0)
+    {
+        buffer[offset++] = '-';
+        exponent = -exponent;
+    }
+    else
+    {
+        buffer[offset++] = '+';
+    }
+    if (exponent < 10)
+    {
+        buffer[offset++] = '0';
+    }
+
+    return offset + format_unsigned((unsigned long)exponent, buffer + offset);
+}
+#endif /* ULLONG_MAX */
+
+/* render a number into buffer (CJSON_NUMBER_BUFFER_SIZE bytes, not terminated), returns the length or -1 */
+static int format_number(double d, unsigned char * const buffer)
+{
+#ifdef CJSON_GRISU2
+    unsigned char digits[20];
+    int digit_count = 0;
+    int decimal_exponent = 0;
+    int length = 0;
+#else
+    double test = 0.0;
+    int length = 0;
+#endif
+
+    /* This checks for NaN and Infinity */
+    if (isnan(d) || isinf(d))
+    {
+        memcpy(buffer, "null", 4);
+        return 4;
+    }
+
+    if ((fabs(d) < 1e15) && (d == floor(d)))
+    {
+        /* the comparison turns -0 into 0 */
+        return format_integral((d == 0) ? 0 : d, buffer);
+    }
+
+#ifdef CJSON_GRISU2
+    if (d < 0)
+    {
+        buffer[length++] = '-';
+        d = -d;
+    }
+
+    digit_count = grisu2(d, digits, &decimal_exponent);
+
+    return length + format_digits(buffer + length, digits, digit_count, decimal_exponent);
+#else
+    /* Try 15 decimal places of precision to avoid nonsignificant nonzero digits */
+    length = sprintf((char*)buffer, "%1.15g", d);
+
+    /* Check whether the original double can be recovered */
+    if ((sscanf((char*)buffer, "%lg", &test) != 1) || !compare_double((double)test, d))
+    {
+        /* If not, print with 17 decimal places of precision */
+        length = sprintf((char*)buffer, "%1.17g", d);
+    }
+
+    return length;
+#endif
+}
+
+/* Render the number nicely from the given item into a string. */
+static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer)
+{
+    unsigned char *output_pointer = NULL;
+    double d = item->valuedouble;
+    int length = 0;
+    size_t i = 0;
+    unsigned char number_buffer[CJSON_NUMBER_BUFFER_SIZE] = {0}; /* temporary buffer to print the number into */
+    unsigned char decimal_point = get_decimal_point();
+
+    if (output_buffer == NULL)
+    {
+        return false;
+    }
+
+    length = format_number(d, number_buffer);
+
     /* sprintf failed or buffer overrun occurred */
     if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
     {
@@ -657,6 +1231,82 @@ static cJSON_bool print_number(const cJSON * const item, printbuffer * const out
     return true;
 }
 
+CJSON_PUBLIC(int) cJSON_FormatNumber(double number, char *buffer)
+{
+    unsigned char decimal_point = get_decimal_point();
+    int length = 0;
+    int i = 0;
+
+    if (buffer == NULL)
+    {
+        return 0;
+    }
+
+    length = format_number(number, (unsigned char*)buffer);
+    if ((length < 0) || (length > (CJSON_NUMBER_BUFFER_SIZE - 1)))
+    {
+        return 0;
+    }
+
+    /* replace the locale dependent decimal point of the sprintf fallback with '.' */
+    for (i = 0; i < length; i++)
+    {
+        if ((unsigned char)buffer[i] == decimal_point)
+        {
+            buffer[i] = '.';
+        }
+    }
+    buffer[length] = '\0';
+
+    return length;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ScanNumber(const char *text, size_t length, double *number)
+{
+    unsigned char local[64];
+    unsigned char *copy = local;
+    unsigned char *after_end = NULL;
+    unsigned char decimal_point = get_decimal_point();
+    size_t consumed = 0;
+    size_t i = 0;
+    cJSON_bool valid = false;
+
+    if ((text == NULL) || (number == NULL) || (length == 0))
+    {
+        return false;
+    }
+
+    if (parse_number_fast((const unsigned char*)text, length, number, &consumed))
+    {
+        return consumed == length;
+    }
+
+    /* strtod needs a terminated copy with the decimal point of the current locale */
+    if (length >= sizeof(local))
+    {
+        copy = (unsigned char*)global_hooks.allocate(length + 1);
+        if (copy == NULL)
+        {
+            return false;
+        }
+    }
+    for (i = 0; i < length; i++)
+    {
+        copy[i] = (text[i] == '.') ? decimal_point : (unsigned char)text[i];
+    }
+    copy[length] = '\0';
+
+    *number = strtod((const char*)copy, (char**)&after_end);
+    valid = (after_end == (copy + length));
+
+    if (copy != local)
+    {
+        global_hooks.deallocate(copy);
+    }
+
+    return valid;
+}
+
 /* parse 4 digit hexadecimal number */
 static unsigned parse_hex4(const unsigned char * const input)
 {
@@ -1138,15 +1788,15 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return
     return cJSON_ParseWithLengthOpts(value, buffer_length, return_parse_end, require_null_terminated);
 }
 
-/* Parse an object - create a new root, and populate. */
-CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+/* Parse an object - create a new root, and populate. The error position is stored in parse_error. */
+static cJSON *parse_with_hooks(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated, const internal_hooks * const hooks, error * const parse_error)
 {
     parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
     cJSON *item = NULL;
 
     /* reset error position */
-    global_error.json = NULL;
-    global_error.position = 0;
+    parse_error->json = NULL;
+    parse_error->position = 0;
 
     if (value == NULL || 0 == buffer_length)
     {
@@ -1156,9 +1806,9 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer
     buffer.content = (const unsigned char*)value;
     buffer.length = buffer_length;
     buffer.offset = 0;
-    buffer.hooks = global_hooks;
+    buffer.hooks = *hooks;
 
-    item = cJSON_New_Item(&global_hooks);
+    item = cJSON_New_Item(hooks);
     if (item == NULL) /* memory fail */
     {
         goto fail;
@@ -1189,7 +1839,7 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer
 fail:
     if (item != NULL)
     {
-        cJSON_Delete(item);
+        delete_item(item, hooks);
     }
 
     if (value != NULL)
@@ -1212,12 +1862,40 @@ fail:
             *return_parse_end = (const char*)local_error.json + local_error.position;
         }
 
-        global_error = local_error;
+        *parse_error = local_error;
     }
 
     return NULL;
 }
 
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    return parse_with_hooks(value, buffer_length, return_parse_end, require_null_terminated, &global_hooks, &global_error);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithContext(cJSON_Context * const context, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    internal_hooks hooks;
+    error parse_error = { NULL, 0 };
+    cJSON *item = NULL;
+
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    hooks_from_public(&hooks, &context->hooks);
+    item = parse_with_hooks(value, buffer_length, return_parse_end, require_null_terminated, &hooks, &parse_error);
+
+    context->error_ptr = NULL;
+    if (parse_error.json != NULL)
+    {
+        context->error_ptr = (const char*)(parse_error.json + parse_error.position);
+    }
+
+    return item;
+}
+
 /* Default options for cJSON_Parse */
 CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
 {
@@ -1309,6 +1987,19 @@ CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item)
     return (char*)print(item, false, &global_hooks);
 }
 
+CJSON_PUBLIC(char *) cJSON_PrintWithContext(const cJSON_Context * const context, const cJSON *item, cJSON_bool format)
+{
+    internal_hooks hooks;
+
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    hooks_from_public(&hooks, &context->hooks);
+    return (char*)print(item, format, &hooks);
+}
+
 CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt)
 {
     printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
@@ -1580,7 +2271,7 @@ success:
 fail:
     if (head != NULL)
     {
-        cJSON_Delete(head);
+        delete_item(head, &input_buffer->hooks);
     }
 
     return false;
@@ -1760,7 +2451,7 @@ success:
 fail:
     if (head != NULL)
     {
-        cJSON_Delete(head);
+        delete_item(head, &input_buffer->hooks);
     }
 
     return false;
@@ -1950,34 +2641,300 @@ static cJSON *get_object_item(const cJSON * const object, const char * const nam
             current_element = current_element->next;
         }
     }
-    else
+    else
+    {
+        while ((current_element != NULL) && (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)(current_element->string)) != 0))
+        {
+            current_element = current_element->next;
+        }
+    }
+
+    if ((current_element == NULL) || (current_element->string == NULL)) {
+        return NULL;
+    }
+
+    return current_element;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON * const object, const char * const string)
+{
+    return get_object_item(object, string, false);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string)
+{
+    return get_object_item(object, string, true);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string)
+{
+    return cJSON_GetObjectItem(object, string) ? 1 : 0;
+}
+
+struct cJSON_Index
+{
+    const cJSON *node;
+    /* element pointer vector, built on the first array access */
+    cJSON **elements;
+    size_t element_count;
+    cJSON_bool elements_built;
+    /* open addressing key table (power of two sized), built on the first key lookup */
+    cJSON **slots;
+    unsigned int *hashes;
+    size_t slot_count;
+};
+
+/* FNV-1a over the lower case key, so case sensitive and insensitive lookups share one table */
+static unsigned int index_hash(const unsigned char *string)
+{
+    unsigned int hash = 2166136261U;
+
+    for (; *string != '\0'; string++)
+    {
+        hash ^= (unsigned int)tolower(*string);
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+static void index_release(cJSON_Index * const index)
+{
+    if (index->elements != NULL)
+    {
+        global_hooks.deallocate(index->elements);
+        index->elements = NULL;
+    }
+    if (index->slots != NULL)
+    {
+        global_hooks.deallocate(index->slots);
+        index->slots = NULL;
+    }
+    if (index->hashes != NULL)
+    {
+        global_hooks.deallocate(index->hashes);
+        index->hashes = NULL;
+    }
+    index->element_count = 0;
+    index->elements_built = false;
+    index->slot_count = 0;
+}
+
+static cJSON_bool index_build_elements(cJSON_Index * const index)
+{
+    cJSON *child = NULL;
+    size_t count = 0;
+
+    if (index->elements_built)
+    {
+        return true;
+    }
+
+    for (child = index->node->child; child != NULL; child = child->next)
+    {
+        count++;
+    }
+
+    if (count > 0)
+    {
+        index->elements = (cJSON**)global_hooks.allocate(count * sizeof(cJSON*));
+        if (index->elements == NULL)
+        {
+            return false;
+        }
+
+        count = 0;
+        for (child = index->node->child; child != NULL; child = child->next)
+        {
+            index->elements[count++] = child;
+        }
+    }
+    index->element_count = count;
+    index->elements_built = true;
+
+    return true;
+}
+
+static cJSON_bool index_build_slots(cJSON_Index * const index)
+{
+    size_t slot_count = 4;
+    size_t i = 0;
+    size_t slot = 0;
+    unsigned int hash = 0;
+    cJSON *element = NULL;
+
+    if (index->slot_count > 0)
+    {
+        return true;
+    }
+
+    if (!index_build_elements(index))
+    {
+        return false;
+    }
+
+    /* keep the load factor at or below 1/2 */
+    while (slot_count < (index->element_count * 2))
+    {
+        slot_count *= 2;
+    }
+
+    index->slots = (cJSON**)global_hooks.allocate(slot_count * sizeof(cJSON*));
+    index->hashes = (unsigned int*)global_hooks.allocate(slot_count * sizeof(unsigned int));
+    if ((index->slots == NULL) || (index->hashes == NULL))
+    {
+        index_release(index);
+        return false;
+    }
+    memset(index->slots, '\0', slot_count * sizeof(cJSON*));
+
+    /* insert in document order, so that probing finds the first of several matching keys first */
+    for (i = 0; i < index->element_count; i++)
+    {
+        element = index->elements[i];
+        if (element->string == NULL)
+        {
+            continue;
+        }
+
+        hash = index_hash((const unsigned char*)element->string);
+        for (slot = hash & (slot_count - 1); index->slots[slot] != NULL; slot = (slot + 1) & (slot_count - 1))
+        {
+            if ((index->hashes[slot] == hash) && (strcmp(index->slots[slot]->string, element->string) == 0))
+            {
+                /* exact duplicate key, lookups return the first one */
+                break;
+            }
+        }
+
+        if (index->slots[slot] == NULL)
+        {
+            index->slots[slot] = element;
+            index->hashes[slot] = hash;
+        }
+    }
+    index->slot_count = slot_count;
+
+    return true;
+}
+
+static cJSON *index_get_object_item(cJSON_Index * const index, const char * const name, const cJSON_bool case_sensitive)
+{
+    size_t slot = 0;
+    unsigned int hash = 0;
+    cJSON *element = NULL;
+
+    if ((index == NULL) || (name == NULL))
+    {
+        return NULL;
+    }
+
+    if (!index_build_slots(index))
+    {
+        /* out of memory, fall back to the linear search */
+        return get_object_item(index->node, name, case_sensitive);
+    }
+
+    hash = index_hash((const unsigned char*)name);
+    for (slot = hash & (index->slot_count - 1); index->slots[slot] != NULL; slot = (slot + 1) & (index->slot_count - 1))
+    {
+        element = index->slots[slot];
+        if (index->hashes[slot] != hash)
+        {
+            continue;
+        }
+
+        if (case_sensitive ? (strcmp(name, element->string) == 0) : (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)element->string) == 0))
+        {
+            return element;
+        }
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON_Index *) cJSON_CreateIndex(const cJSON * const node)
+{
+    cJSON_Index *index = NULL;
+
+    if ((node == NULL) || !(node->type & (cJSON_Array | cJSON_Object)))
+    {
+        return NULL;
+    }
+
+    index = (cJSON_Index*)global_hooks.allocate(sizeof(cJSON_Index));
+    if (index == NULL)
+    {
+        return NULL;
+    }
+    memset(index, '\0', sizeof(cJSON_Index));
+    index->node = node;
+
+    return index;
+}
+
+CJSON_PUBLIC(void) cJSON_ResetIndex(cJSON_Index * const index)
+{
+    if (index != NULL)
+    {
+        index_release(index);
+    }
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteIndex(cJSON_Index * const index)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+
+    index_release(index);
+    global_hooks.deallocate(index);
+}
+
+CJSON_PUBLIC(int) cJSON_IndexGetArraySize(cJSON_Index * const index)
+{
+    if (index == NULL)
+    {
+        return 0;
+    }
+
+    if (!index_build_elements(index))
+    {
+        return cJSON_GetArraySize(index->node);
+    }
+
+    return (int)index->element_count;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_IndexGetArrayItem(cJSON_Index * const index, int which)
+{
+    if ((index == NULL) || (which < 0))
+    {
+        return NULL;
+    }
+
+    if (!index_build_elements(index))
     {
-        while ((current_element != NULL) && (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)(current_element->string)) != 0))
-        {
-            current_element = current_element->next;
-        }
+        return get_array_item(index->node, (size_t)which);
     }
 
-    if ((current_element == NULL) || (current_element->string == NULL)) {
+    if ((size_t)which >= index->element_count)
+    {
         return NULL;
     }
 
-    return current_element;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON * const object, const char * const string)
-{
-    return get_object_item(object, string, false);
+    return index->elements[which];
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string)
+CJSON_PUBLIC(cJSON *) cJSON_IndexGetObjectItem(cJSON_Index * const index, const char * const string)
 {
-    return get_object_item(object, string, true);
+    return index_get_object_item(index, string, false);
 }
 
-CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string)
+CJSON_PUBLIC(cJSON *) cJSON_IndexGetObjectItemCaseSensitive(cJSON_Index * const index, const char * const string)
 {
-    return cJSON_GetObjectItem(object, string) ? 1 : 0;
+    return index_get_object_item(index, string, true);
 }
 
 /* Utility for array list handling. */
@@ -2857,95 +3814,184 @@ fail:
     return NULL;
 }
 
-static void skip_oneline_comment(char **input)
+/* SWAR (SIMD within a register) helpers: classify 4 input bytes with a few integer operations instead of
+ * testing them one by one. Only whether any of the 4 bytes matches is exact, not which one. */
+#if UINT_MAX == 0xFFFFFFFFUL
+#define CJSON_SWAR
+typedef unsigned int swar_word;
+#define swar_ones 0x01010101U
+#define swar_highs 0x80808080U
+/* any byte zero */
+#define swar_has_zero(word) ((((word) - swar_ones) & ~(word) & swar_highs) != 0)
+/* any byte equal to character */
+#define swar_has_byte(word, character) swar_has_zero((word) ^ (swar_ones * (swar_word)(character)))
+/* any byte less than n, n <= 128 */
+#define swar_has_less(word, n) ((((word) - (swar_ones * (swar_word)(n))) & ~(word) & swar_highs) != 0)
+
+static swar_word swar_load(const unsigned char * const bytes)
 {
-    *input += static_strlen("//");
+    swar_word word = 0;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+#endif
+
+static void skip_oneline_comment(unsigned char **input, const unsigned char * const end)
+{
+    const unsigned char *newline = NULL;
 
-    for (; (*input)[0] != '\0'; ++(*input))
+    *input += static_strlen("//");
+    if (*input >= end)
     {
-        if ((*input)[0] == '\n') {
-            *input += static_strlen("\n");
-            return;
-        }
+        *input = (unsigned char*)end;
+        return;
     }
+
+    newline = (const unsigned char*)memchr(*input, '\n', (size_t)(end - *input));
+    *input = (newline != NULL) ? ((unsigned char*)newline + static_strlen("\n")) : (unsigned char*)end;
 }
 
-static void skip_multiline_comment(char **input)
+static void skip_multiline_comment(unsigned char **input, const unsigned char * const end)
 {
-    *input += static_strlen("/*");
+    const unsigned char *star = NULL;
 
-    for (; (*input)[0] != '\0'; ++(*input))
+    *input += static_strlen("/*");
+    while (*input < end)
     {
-        if (((*input)[0] == '*') && ((*input)[1] == '/'))
+        star = (const unsigned char*)memchr(*input, '*', (size_t)(end - *input));
+        if (star == NULL)
+        {
+            break;
+        }
+        if (((star + 1) < end) && (star[1] == '/'))
         {
-            *input += static_strlen("*/");
+            *input = (unsigned char*)star + static_strlen("*/");
             return;
         }
+        *input = (unsigned char*)star + 1;
     }
+
+    *input = (unsigned char*)end;
 }
 
-static void minify_string(char **input, char **output) {
+static void minify_string(unsigned char **input, unsigned char **output, const unsigned char * const end)
+{
+#ifdef CJSON_SWAR
+    swar_word word = 0;
+#endif
+
     (*output)[0] = (*input)[0];
     *input += static_strlen("\"");
     *output += static_strlen("\"");
 
+    while (*input < end)
+    {
+#ifdef CJSON_SWAR
+        /* copy 4 bytes at a time until a quote or backslash shows up */
+        while ((end - *input) >= (ptrdiff_t)sizeof(word))
+        {
+            word = swar_load(*input);
+            if (swar_has_byte(word, '\"') || swar_has_byte(word, '\\'))
+            {
+                break;
+            }
+            memcpy(*output, &word, sizeof(word));
+            *input += sizeof(word);
+            *output += sizeof(word);
+        }
+        if (*input >= end)
+        {
+            return;
+        }
+#endif
 
-    for (; (*input)[0] != '\0'; (void)++(*input), ++(*output)) {
         (*output)[0] = (*input)[0];
-
-        if ((*input)[0] == '\"') {
-            (*output)[0] = '\"';
+        if ((*input)[0] == '\"')
+        {
             *input += static_strlen("\"");
             *output += static_strlen("\"");
             return;
-        } else if (((*input)[0] == '\\') && ((*input)[1] == '\"')) {
+        }
+        else if (((*input)[0] == '\\') && ((*input + 1) < end))
+        {
+            /* copy the escaped character too, so neither \" nor \\ is mistaken for anything else */
             (*output)[1] = (*input)[1];
-            *input += static_strlen("\"");
-            *output += static_strlen("\"");
+            *input += 1;
+            *output += 1;
         }
+        *input += 1;
+        *output += 1;
     }
 }
 
 CJSON_PUBLIC(void) cJSON_Minify(char *json)
 {
-    char *into = json;
+    unsigned char *input = (unsigned char*)json;
+    unsigned char *into = input;
+    const unsigned char *end = NULL;
+#ifdef CJSON_SWAR
+    swar_word word = 0;
+#endif
 
     if (json == NULL)
     {
         return;
     }
 
-    while (json[0] != '\0')
+    end = input + strlen(json);
+    while (input < end)
     {
-        switch (json[0])
+#ifdef CJSON_SWAR
+        /* copy structural characters, numbers and literals 4 at a time until whitespace (or any other
+         * control character), a comment or a string starts */
+        while ((end - input) >= (ptrdiff_t)sizeof(word))
+        {
+            word = swar_load(input);
+            if (swar_has_less(word, ' ' + 1) || swar_has_byte(word, '\"') || swar_has_byte(word, '/'))
+            {
+                break;
+            }
+            memcpy(into, &word, sizeof(word));
+            input += sizeof(word);
+            into += sizeof(word);
+        }
+        if (input >= end)
+        {
+            break;
+        }
+#endif
+
+        switch (input[0])
         {
             case ' ':
             case '\t':
             case '\r':
             case '\n':
-                json++;
+                input++;
                 break;
 
             case '/':
-                if (json[1] == '/')
+                if (((input + 1) < end) && (input[1] == '/'))
+                {
+                    skip_oneline_comment(&input, end);
+                }
+                else if (((input + 1) < end) && (input[1] == '*'))
                 {
-                    skip_oneline_comment(&json);
+                    skip_multiline_comment(&input, end);
                 }
-                else if (json[1] == '*')
+                else
                 {
-                    skip_multiline_comment(&json);
-                } else {
-                    json++;
+                    input++;
                 }
                 break;
 
             case '\"':
-                minify_string(&json, (char**)&into);
+                minify_string(&input, &into, end);
                 break;
 
             default:
-                into[0] = json[0];
-                json++;
+                into[0] = input[0];
+                input++;
                 into++;
         }
     }
@@ -2954,6 +4000,347 @@ CJSON_PUBLIC(void) cJSON_Minify(char *json)
     *into = '\0';
 }
 
+/* skip insignificant whitespace, returns the new offset */
+static size_t validate_skip_whitespace(const unsigned char * const input, size_t length, size_t offset)
+{
+    while ((offset < length) && ((input[offset] == ' ') || (input[offset] == '\t') || (input[offset] == '\r') || (input[offset] == '\n')))
+    {
+        offset++;
+    }
+
+    return offset;
+}
+
+static cJSON_bool validate_hex4(const unsigned char * const input, size_t length, size_t offset, unsigned int * const code)
+{
+    if ((offset + 4) > length)
+    {
+        return false;
+    }
+
+    *code = parse_hex4(input + offset);
+    /* parse_hex4 returns 0 for invalid digits, which is also a valid value */
+    return (*code != 0) || ((input[offset] == '0') && (input[offset + 1] == '0') && (input[offset + 2] == '0') && (input[offset + 3] == '0'));
+}
+
+/* offset points behind the opening quote, returns the offset behind the closing quote or 0 */
+static size_t validate_string(const unsigned char * const input, size_t length, size_t offset)
+{
+    unsigned int code = 0;
+#ifdef CJSON_SWAR
+    swar_word word = 0;
+#endif
+
+    while (offset < length)
+    {
+#ifdef CJSON_SWAR
+        /* skip 4 bytes at a time until a quote, backslash or control character shows up */
+        while ((length - offset) >= sizeof(word))
+        {
+            word = swar_load(input + offset);
+            if (swar_has_less(word, ' ') || swar_has_byte(word, '\"') || swar_has_byte(word, '\\'))
+            {
+                break;
+            }
+            offset += sizeof(word);
+        }
+        if (offset >= length)
+        {
+            return 0;
+        }
+#endif
+
+        if (input[offset] == '\"')
+        {
+            return offset + 1;
+        }
+        if (input[offset] < ' ')
+        {
+            return 0;
+        }
+        if (input[offset] != '\\')
+        {
+            offset++;
+            continue;
+        }
+
+        offset++;
+        if (offset >= length)
+        {
+            return 0;
+        }
+        switch (input[offset])
+        {
+            case 'b':
+            case 'f':
+            case 'n':
+            case 'r':
+            case 't':
+            case '\"':
+            case '\\':
+            case '/':
+                offset++;
+                break;
+
+            case 'u':
+                /* same surrogate rules as the parser */
+                if (!validate_hex4(input, length, offset + 1, &code) || ((code >= 0xDC00) && (code <= 0xDFFF)))
+                {
+                    return 0;
+                }
+                offset += 5;
+                if ((code >= 0xD800) && (code <= 0xDBFF))
+                {
+                    if (((offset + 2) > length) || (input[offset] != '\\') || (input[offset + 1] != 'u')
+                        || !validate_hex4(input, length, offset + 2, &code) || (code < 0xDC00) || (code > 0xDFFF))
+                    {
+                        return 0;
+                    }
+                    offset += 6;
+                }
+                break;
+
+            default:
+                return 0;
+        }
+    }
+
+    return 0;
+}
+
+#define validate_is_digit(c) (((c) >= '0') && ((c) <= '9'))
+/* whether the innermost open container is an object */
+#define validate_in_object(bits, depth) ((((bits)[((depth) - 1) / 8] >> (((depth) - 1) % 8)) & 1) != 0)
+
+/* RFC 8259 number, returns the offset behind it or 0 */
+static size_t validate_number(const unsigned char * const input, size_t length, size_t offset)
+{
+    if ((offset < length) && (input[offset] == '-'))
+    {
+        offset++;
+    }
+
+    if ((offset < length) && (input[offset] == '0'))
+    {
+        offset++;
+    }
+    else if ((offset < length) && validate_is_digit(input[offset]))
+    {
+        while ((offset < length) && validate_is_digit(input[offset]))
+        {
+            offset++;
+        }
+    }
+    else
+    {
+        return 0;
+    }
+
+    if ((offset < length) && (input[offset] == '.'))
+    {
+        offset++;
+        if ((offset >= length) || !validate_is_digit(input[offset]))
+        {
+            return 0;
+        }
+        while ((offset < length) && validate_is_digit(input[offset]))
+        {
+            offset++;
+        }
+    }
+
+    if ((offset < length) && ((input[offset] == 'e') || (input[offset] == 'E')))
+    {
+        offset++;
+        if ((offset < length) && ((input[offset] == '+') || (input[offset] == '-')))
+        {
+            offset++;
+        }
+        if ((offset >= length) || !validate_is_digit(input[offset]))
+        {
+            return 0;
+        }
+        while ((offset < length) && validate_is_digit(input[offset]))
+        {
+            offset++;
+        }
+    }
+
+    return offset;
+}
+
+static size_t validate_literal(const unsigned char * const input, size_t length, size_t offset, const char * const literal)
+{
+    size_t literal_length = strlen(literal);
+
+    if (((length - offset) < literal_length) || (strncmp((const char*)input + offset, literal, literal_length) != 0))
+    {
+        return 0;
+    }
+
+    return offset + literal_length;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ValidateWithLength(const char *value, size_t buffer_length)
+{
+    const unsigned char *input = (const unsigned char*)value;
+    /* one bit per nesting level, set for objects */
+    unsigned char is_object[(CJSON_NESTING_LIMIT + 7) / 8];
+    size_t depth = 0;
+    size_t offset = 0;
+    unsigned char opening = '\0';
+    enum { expect_value, expect_key, after_value } state = expect_value;
+
+    if (value == NULL)
+    {
+        return false;
+    }
+
+    /* a terminating '\0' included in the length is allowed, like for cJSON_ParseWithLength */
+    if ((buffer_length > 0) && (input[buffer_length - 1] == '\0'))
+    {
+        buffer_length--;
+    }
+
+    if ((buffer_length >= 3) && (strncmp(value, "\xEF\xBB\xBF", 3) == 0))
+    {
+        offset = 3;
+    }
+
+    for (;;)
+    {
+        offset = validate_skip_whitespace(input, buffer_length, offset);
+
+        if (state == after_value)
+        {
+            if (depth == 0)
+            {
+                /* nothing but whitespace may follow the document */
+                return offset == buffer_length;
+            }
+            if (offset >= buffer_length)
+            {
+                return false;
+            }
+
+            if (input[offset] == ',')
+            {
+                offset++;
+                state = validate_in_object(is_object, depth) ? expect_key : expect_value;
+                continue;
+            }
+            if (input[offset] == (validate_in_object(is_object, depth) ? '}' : ']'))
+            {
+                offset++;
+                depth--;
+                continue;
+            }
+            return false;
+        }
+
+        if (offset >= buffer_length)
+        {
+            return false;
+        }
+
+        if (state == expect_key)
+        {
+            if (input[offset] != '\"')
+            {
+                return false;
+            }
+            offset = validate_string(input, buffer_length, offset + 1);
+            if (offset == 0)
+            {
+                return false;
+            }
+            offset = validate_skip_whitespace(input, buffer_length, offset);
+            if ((offset >= buffer_length) || (input[offset] != ':'))
+            {
+                return false;
+            }
+            offset++;
+            state = expect_value;
+            continue;
+        }
+
+        /* expect_value */
+        switch (input[offset])
+        {
+            case '{':
+            case '[':
+                if (depth >= CJSON_NESTING_LIMIT)
+                {
+                    return false; /* too deeply nested */
+                }
+                opening = input[offset];
+                if (opening == '{')
+                {
+                    is_object[depth / 8] = (unsigned char)(is_object[depth / 8] | (1 << (depth % 8)));
+                }
+                else
+                {
+                    is_object[depth / 8] = (unsigned char)(is_object[depth / 8] & ~(1 << (depth % 8)));
+                }
+                depth++;
+
+                offset = validate_skip_whitespace(input, buffer_length, offset + 1);
+                if ((offset < buffer_length) && (input[offset] == ((opening == '{') ? '}' : ']')))
+                {
+                    /* empty object or array */
+                    offset++;
+                    depth--;
+                    state = after_value;
+                }
+                else
+                {
+                    state = (opening == '{') ? expect_key : expect_value;
+                }
+                break;
+
+            case '\"':
+                offset = validate_string(input, buffer_length, offset + 1);
+                state = after_value;
+                break;
+
+            case 't':
+                offset = validate_literal(input, buffer_length, offset, "true");
+                state = after_value;
+                break;
+
+            case 'f':
+                offset = validate_literal(input, buffer_length, offset, "false");
+                state = after_value;
+                break;
+
+            case 'n':
+                offset = validate_literal(input, buffer_length, offset, "null");
+                state = after_value;
+                break;
+
+            default:
+                offset = validate_number(input, buffer_length, offset);
+                state = after_value;
+                break;
+        }
+
+        if (offset == 0)
+        {
+            return false;
+        }
+    }
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_Validate(const char *value)
+{
+    if (value == NULL)
+    {
+        return false;
+    }
+
+    return cJSON_ValidateWithLength(value, strlen(value));
+}
+
 CJSON_PUBLIC(cJSON_bool) cJSON_IsInvalid(const cJSON * const item)
 {
     if (item == NULL)
@@ -131,6 +131,17 @@ typedef struct cJSON_Hooks
 
 typedef int cJSON_bool;
 
+/* Per-call parse context. Carries the allocation hooks and the error position of a parse, so several tasks
+ * can parse at the same time without sharing the global hooks or the global error pointer.
+ * Initialize with cJSON_InitContext before use. */
+typedef struct cJSON_Context
+{
+    /* NULL members fall back to malloc/free */
+    cJSON_Hooks hooks;
+    /* Set by cJSON_ParseWithContext: points to the parse error, NULL when the parse succeeded. */
+    const char *error_ptr;
+} cJSON_Context;
+
 /* Limits how deeply nested arrays/objects can be before cJSON rejects to parse them.
  * This is to prevent stack overflows. */
 #ifndef CJSON_NESTING_LIMIT
@@ -143,6 +154,9 @@ typedef int cJSON_bool;
 #define CJSON_CIRCULAR_LIMIT 10000
 #endif
 
+/* Size of the buffer cJSON_FormatNumber writes into, including the terminating '\0'. */
+#define CJSON_NUMBER_BUFFER_SIZE 32
+
 /* returns the version of cJSON as a string */
 CJSON_PUBLIC(const char*) cJSON_Version(void);
 
@@ -158,6 +172,14 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLength(const char *value, size_t buffer_len
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
 
+/* Reentrant variants: hooks and error position come from (and go to) the context instead of global state.
+ * Items returned by cJSON_ParseWithContext must be deleted with cJSON_DeleteWithContext using the same hooks,
+ * strings returned by cJSON_PrintWithContext must be released with the context's free function. */
+CJSON_PUBLIC(void) cJSON_InitContext(cJSON_Context * const context, const cJSON_Hooks * const hooks);
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithContext(cJSON_Context * const context, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
+CJSON_PUBLIC(char *) cJSON_PrintWithContext(const cJSON_Context * const context, const cJSON *item, cJSON_bool format);
+CJSON_PUBLIC(void) cJSON_DeleteWithContext(const cJSON_Context * const context, cJSON *item);
+
 /* Render a cJSON entity to text for transfer/storage. */
 CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item);
 /* Render a cJSON entity to text for transfer/storage without any formatting. */
@@ -178,6 +200,19 @@ CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int index);
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON * const object, const char * const string);
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string);
 CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string);
+
+/* Lookup index for large arrays/objects: an element vector and a key hash table, each built lazily on the first
+ * lookup that needs it, so repeated GetArrayItem/GetArraySize/GetObjectItem calls are O(1).
+ * The index does not own the node. It is only valid while the node's children are unchanged, call
+ * cJSON_ResetIndex after modifying them and cJSON_DeleteIndex before deleting the node. */
+typedef struct cJSON_Index cJSON_Index;
+CJSON_PUBLIC(cJSON_Index *) cJSON_CreateIndex(const cJSON * const node);
+CJSON_PUBLIC(void) cJSON_ResetIndex(cJSON_Index * const index);
+CJSON_PUBLIC(void) cJSON_DeleteIndex(cJSON_Index * const index);
+CJSON_PUBLIC(int) cJSON_IndexGetArraySize(cJSON_Index * const index);
+CJSON_PUBLIC(cJSON *) cJSON_IndexGetArrayItem(cJSON_Index * const index, int which);
+CJSON_PUBLIC(cJSON *) cJSON_IndexGetObjectItem(cJSON_Index * const index, const char * const string);
+CJSON_PUBLIC(cJSON *) cJSON_IndexGetObjectItemCaseSensitive(cJSON_Index * const index, const char * const string);
 /* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when cJSON_Parse() returns 0. 0 when cJSON_Parse() succeeds. */
 CJSON_PUBLIC(const char *) cJSON_GetErrorPtr(void);
 
@@ -265,6 +300,11 @@ CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON * const a, const cJSON * cons
  * but should point to a readable and writable address area. */
 CJSON_PUBLIC(void) cJSON_Minify(char *json);
 
+/* Check that a buffer holds exactly one well-formed JSON document (RFC 8259, surrounding whitespace allowed)
+ * without allocating anything. Stricter than cJSON_Parse about numbers and trailing characters. */
+CJSON_PUBLIC(cJSON_bool) cJSON_Validate(const char *value);
+CJSON_PUBLIC(cJSON_bool) cJSON_ValidateWithLength(const char *value, size_t buffer_length);
+
 /* Helper functions for creating and adding items to an object at the same time.
  * They return the added item or NULL on failure. */
 CJSON_PUBLIC(cJSON*) cJSON_AddNullToObject(cJSON * const object, const char * const name);
@@ -285,6 +325,12 @@ CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number);
 /* Change the valuestring of a cJSON_String object, only takes effect when type of object is cJSON_String */
 CJSON_PUBLIC(char*) cJSON_SetValuestring(cJSON *object, const char *valuestring);
 
+/* Render a number the way cJSON_Print does: short text that reads back as the same double (the shortest for
+ * almost all values), NaN and Infinity as null. buffer must hold CJSON_NUMBER_BUFFER_SIZE bytes. Returns the length, 0 on failure. */
+CJSON_PUBLIC(int) cJSON_FormatNumber(double number, char *buffer);
+/* Convert length characters of JSON number text. Returns false unless all of them form a number. */
+CJSON_PUBLIC(cJSON_bool) cJSON_ScanNumber(const char *text, size_t length, double *number);
+
 /* If the object is not a boolean type this does nothing and returns cJSON_Invalid else it returns the new type*/
 #define cJSON_SetBoolValue(object, boolValue) ( \
     (object != NULL && ((object)->type & (cJSON_False|cJSON_True))) ? \
@@ -0,0 +1,656 @@
+/*
+ * cJSON_Bind.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <string.h>
+#include <limits.h>
+
+#include "cJSON_Bind.h"
+
+/* define our own boolean type */
+#ifdef true
+#undef true
+#endif
+#define true ((cJSON_bool)1)
+
+#ifdef false
+#undef false
+#endif
+#define false ((cJSON_bool)0)
+
+/* widest member an integer can be bound to */
+#if defined(ULLONG_MAX)
+typedef unsigned long long bind_uint;
+#else
+typedef unsigned long bind_uint;
+#endif
+
+/* raw bits of an integer member, fails for sizes no integer type has */
+static cJSON_bool store_bits(void *destination, size_t size, bind_uint bits)
+{
+    if (size == sizeof(unsigned char))
+    {
+        *(unsigned char*)destination = (unsigned char)bits;
+    }
+    else if (size == sizeof(unsigned short))
+    {
+        *(unsigned short*)destination = (unsigned short)bits;
+    }
+    else if (size == sizeof(unsigned int))
+    {
+        *(unsigned int*)destination = (unsigned int)bits;
+    }
+    else if (size == sizeof(unsigned long))
+    {
+        *(unsigned long*)destination = (unsigned long)bits;
+    }
+    else if (size == sizeof(bind_uint))
+    {
+        *(bind_uint*)destination = bits;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+static cJSON_bool load_bits(const void *source, size_t size, bind_uint *bits)
+{
+    if (size == sizeof(unsigned char))
+    {
+        *bits = *(const unsigned char*)source;
+    }
+    else if (size == sizeof(unsigned short))
+    {
+        *bits = *(const unsigned short*)source;
+    }
+    else if (size == sizeof(unsigned int))
+    {
+        *bits = *(const unsigned int*)source;
+    }
+    else if (size == sizeof(unsigned long))
+    {
+        *bits = *(const unsigned long*)source;
+    }
+    else if (size == sizeof(bind_uint))
+    {
+        *bits = *(const bind_uint*)source;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/* largest magnitude of a member: unsigned 2^n - 1, signed 2^(n-1) - 1 and 2^(n-1) for negative values */
+static bind_uint integer_limit(size_t size, cJSON_bool is_signed, cJSON_bool negative)
+{
+    const bind_uint top = (bind_uint)1 << ((size * CHAR_BIT) - 1);
+
+    if (!is_signed)
+    {
+        return negative ? 0 : (top - 1) + top;
+    }
+
+    return negative ? top : top - 1;
+}
+
+/* The value of a number token as sign and magnitude. Plain integers are read from the text, so 64 bit
+ * members keep every digit; fractions and exponents go through the double and must be integral. */
+static cJSON_bool scan_integer(double value, const char *text, size_t length, cJSON_bool *negative, bind_uint *magnitude)
+{
+    const double range = (double)((bind_uint)1 << ((sizeof(bind_uint) * CHAR_BIT) - 1)) * 2.0;
+    size_t digits = 0;
+    size_t i = 0;
+
+    *negative = false;
+    *magnitude = 0;
+
+    if ((length > 0) && (text[0] == '-'))
+    {
+        *negative = true;
+        i = 1;
+    }
+    digits = i;
+    while ((digits < length) && (text[digits] >= '0') && (text[digits] <= '9'))
+    {
+        digits++;
+    }
+    if ((digits > i) && (digits == length))
+    {
+        for (; i < length; i++)
+        {
+            if (*magnitude > ((bind_uint)-1 - (bind_uint)(text[i] - '0')) / 10)
+            {
+                return false;
+            }
+            *magnitude = (*magnitude * 10) + (bind_uint)(text[i] - '0');
+        }
+        return true;
+    }
+
+    *negative = value < 0;
+    if (*negative)
+    {
+        value = -value;
+    }
+    /* refuse fractions and values no member can hold, NaN fails every comparison */
+    if (!(value < range) || (value != (double)(bind_uint)value))
+    {
+        return false;
+    }
+    *magnitude = (bind_uint)value;
+
+    return true;
+}
+
+static cJSON_bool store_integer(void *destination, size_t size, cJSON_bool is_signed, cJSON_bool negative, bind_uint magnitude)
+{
+    if ((size == 0) || (size > sizeof(bind_uint)) || (magnitude > integer_limit(size, is_signed, negative)))
+    {
+        return false;
+    }
+
+    return store_bits(destination, size, negative ? (bind_uint)0 - magnitude : magnitude);
+}
+
+static cJSON_bool load_integer(const void *source, size_t size, cJSON_bool is_signed, cJSON_bool *negative, bind_uint *magnitude)
+{
+    bind_uint bits = 0;
+
+    if ((size == 0) || (size > sizeof(bind_uint)) || !load_bits(source, size, &bits))
+    {
+        return false;
+    }
+
+    *negative = is_signed && (bits > integer_limit(size, true, false));
+    /* two's complement of the member width */
+    *magnitude = *negative ? (integer_limit(size, false, false) - bits) + 1 : bits;
+
+    return true;
+}
+
+/* Integers below 2^53 are exact in a double and go out as numbers. Larger ones are written from their
+ * digits since a double would round them, a CBOR writer has no raw text and fails on those. */
+static cJSON_bool write_integer(cJSON_Writer * const writer, const void *source, size_t size, cJSON_bool is_signed)
+{
+    char buffer[(sizeof(bind_uint) * 3) + 2];
+    char *digit = buffer + sizeof(buffer) - 1;
+    cJSON_bool negative = false;
+    bind_uint magnitude = 0;
+
+    if (!load_integer(source, size, is_signed, &negative, &magnitude))
+    {
+        return false;
+    }
+
+    if (((magnitude >> 26) >> 27) == 0)
+    {
+        return cJSON_WriterNumber(writer, negative ? -(double)magnitude : (double)magnitude);
+    }
+
+    *digit = '\0';
+    do
+    {
+        *--digit = (char)('0' + (magnitude % 10));
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (negative)
+    {
+        *--digit = '-';
+    }
+
+    return cJSON_WriterRaw(writer, digit);
+}
+
+typedef struct
+{
+    char *destination;
+    cJSON_BindType type;
+    size_t size;
+    const cJSON_BindField *fields;
+    size_t field_count;
+    const cJSON_BindField *array; /* set when the slot itself is an array */
+} bind_slot;
+
+/* work out where the next value goes. Returns false on errors, sets slot->destination to NULL for ignored values. */
+static cJSON_bool next_slot(cJSON_BindState * const state, bind_slot * const slot)
+{
+    const cJSON_BindField *field = NULL;
+    size_t *count = NULL;
+
+    memset(slot, '\0', sizeof(bind_slot));
+
+    if (state->skip_depth > 0)
+    {
+        return true;
+    }
+
+    /* the document itself */
+    if (state->depth == 0)
+    {
+        slot->destination = state->root;
+        slot->type = cJSON_BindObject;
+        slot->fields = state->root_fields;
+        slot->field_count = state->root_field_count;
+        return true;
+    }
+
+    /* array element */
+    field = state->frames[state->depth - 1].array;
+    if (field != NULL)
+    {
+        count = (size_t*)(state->frames[state->depth - 1].base + field->count_offset);
+        if (*count >= field->capacity)
+        {
+            return false;
+        }
+        slot->destination = state->frames[state->depth - 1].base + field->offset + (*count * field->size);
+        slot->type = field->element_type;
+        slot->size = field->size;
+        slot->fields = field->fields;
+        slot->field_count = field->field_count;
+        (*count)++;
+        return true;
+    }
+
+    /* object member */
+    field = state->pending;
+    state->pending = NULL;
+    if (field == NULL)
+    {
+        return true;
+    }
+
+    slot->destination = state->frames[state->depth - 1].base + field->offset;
+    slot->type = field->type;
+    slot->size = field->size;
+    slot->fields = field->fields;
+    slot->field_count = field->field_count;
+    if (field->type == cJSON_BindArray)
+    {
+        slot->array = field;
+        slot->destination = state->frames[state->depth - 1].base;
+    }
+
+    return true;
+}
+
+static cJSON_bool push_frame(cJSON_BindState * const state, const bind_slot * const slot)
+{
+    if (state->depth >= CJSON_SAX_NESTING_LIMIT)
+    {
+        return false;
+    }
+
+    state->frames[state->depth].fields = slot->fields;
+    state->frames[state->depth].field_count = slot->field_count;
+    state->frames[state->depth].array = slot->array;
+    state->frames[state->depth].base = slot->destination;
+    state->depth++;
+
+    return true;
+}
+
+static cJSON_bool bind_start_object(void *user)
+{
+    cJSON_BindState *state = (cJSON_BindState*)user;
+    bind_slot slot;
+
+    if (!next_slot(state, &slot))
+    {
+        return false;
+    }
+
+    if (slot.destination == NULL)
+    {
+        state->skip_depth++;
+        return true;
+    }
+
+    if ((slot.type != cJSON_BindObject) || (slot.array != NULL))
+    {
+        return false;
+    }
+
+    return push_frame(state, &slot);
+}
+
+static cJSON_bool bind_start_array(void *user)
+{
+    cJSON_BindState *state = (cJSON_BindState*)user;
+    bind_slot slot;
+
+    if (!next_slot(state, &slot))
+    {
+        return false;
+    }
+
+    if (slot.destination == NULL)
+    {
+        state->skip_depth++;
+        return true;
+    }
+
+    if (slot.array == NULL)
+    {
+        return false;
+    }
+    *(size_t*)(slot.destination + slot.array->count_offset) = 0;
+
+    return push_frame(state, &slot);
+}
+
+static cJSON_bool bind_end(void *user)
+{
+    cJSON_BindState *state = (cJSON_BindState*)user;
+
+    if (state->skip_depth > 0)
+    {
+        state->skip_depth--;
+        return true;
+    }
+
+    state->depth--;
+    return true;
+}
+
+static cJSON_bool bind_key(void *user, const char *key, size_t length)
+{
+    cJSON_BindState *state = (cJSON_BindState*)user;
+    const cJSON_BindField *fields = NULL;
+    size_t i = 0;
+
+    if (state->skip_depth > 0)
+    {
+        return true;
+    }
+
+    state->pending = NULL;
+    fields = state->frames[state->depth - 1].fields;
+    for (i = 0; i < state->frames[state->depth - 1].field_count; i++)
+    {
+        if ((fields[i].name_length == length) && (memcmp(fields[i].name, key, length) == 0))
+        {
+            state->pending = &fields[i];
+            break;
+        }
+    }
+
+    return true;
+}
+
+static cJSON_bool bind_string(void *user, const char *value, size_t length)
+{
+    cJSON_BindState *state = (cJSON_BindState*)user;
+    bind_slot slot;
+
+    if (!next_slot(state, &slot))
+    {
+        return false;
+    }
+
+    if (slot.destination == NULL)
+    {
+        return true;
+    }
+
+    if ((slot.type != cJSON_BindString) || (slot.array != NULL) || (length >= slot.size))
+    {
+        return false;
+    }
+    memcpy(slot.destination, value, length + 1);
+
+    return true;
+}
+
+static cJSON_bool bind_number(void *user, double value, const char *text, size_t length)
+{
+    cJSON_BindState *state = (cJSON_BindState*)user;
+    cJSON_bool negative = false;
+    bind_uint magnitude = 0;
+    bind_slot slot;
+
+    if (!next_slot(state, &slot))
+    {
+        return false;
+    }
+
+    if (slot.destination == NULL)
+    {
+        return true;
+    }
+
+    if (slot.array != NULL)
+    {
+        return false;
+    }
+
+    switch (slot.type)
+    {
+        case cJSON_BindInt:
+        case cJSON_BindUint:
+            /* refuse fractions and values out of range of the member instead of truncating them */
+            if (!scan_integer(value, text, length, &negative, &magnitude))
+            {
+                return false;
+            }
+            return store_integer(slot.destination, slot.size, slot.type == cJSON_BindInt, negative, magnitude);
+
+        case cJSON_BindDouble:
+            if (slot.size == sizeof(float))
+            {
+                *(float*)slot.destination = (float)value;
+            }
+            else
+            {
+                *(double*)slot.destination = value;
+            }
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static cJSON_bool bind_boolean(void *user, cJSON_bool value)
+{
+    cJSON_BindState *state = (cJSON_BindState*)user;
+    bind_slot slot;
+
+    if (!next_slot(state, &slot))
+    {
+        return false;
+    }
+
+    if (slot.destination == NULL)
+    {
+        return true;
+    }
+
+    if ((slot.type != cJSON_BindBool) || (slot.array != NULL))
+    {
+        return false;
+    }
+
+    return store_integer(slot.destination, slot.size, false, false, value ? 1 : 0);
+}
+
+static cJSON_bool bind_null(void *user)
+{
+    cJSON_BindState *state = (cJSON_BindState*)user;
+    bind_slot slot;
+    cJSON_bool element = (state->skip_depth == 0) && (state->depth > 0) && (state->frames[state->depth - 1].array != NULL);
+
+    if (!next_slot(state, &slot))
+    {
+        return false;
+    }
+
+    /* null keeps the current value of a member, an array element has none and is zeroed */
+    if (element && (slot.destination != NULL))
+    {
+        memset(slot.destination, '\0', slot.size);
+    }
+
+    return true;
+}
+
+static const cJSON_SaxCallbacks bind_callbacks =
+{
+    bind_start_object,
+    bind_end,
+    bind_start_array,
+    bind_end,
+    bind_key,
+    bind_string,
+    bind_number,
+    bind_boolean,
+    bind_null,
+    NULL
+};
+
+CJSON_PUBLIC(void) cJSON_BindInit(cJSON_BindState * const state, const cJSON_BindField * const fields, size_t field_count, void *object)
+{
+    if (state == NULL)
+    {
+        return;
+    }
+
+    memset(state, '\0', sizeof(cJSON_BindState));
+    state->root_fields = fields;
+    state->root_field_count = field_count;
+    state->root = (char*)object;
+}
+
+CJSON_PUBLIC(const cJSON_SaxCallbacks *) cJSON_BindCallbacks(void)
+{
+    return &bind_callbacks;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_BindParse(const cJSON_BindField * const fields, size_t field_count, void *object, const char *json, size_t length)
+{
+    cJSON_BindState state;
+    cJSON_SaxParser parser;
+
+    if ((fields == NULL) || (object == NULL) || (json == NULL))
+    {
+        return false;
+    }
+
+    cJSON_BindInit(&state, fields, field_count, object);
+    cJSON_SaxInit(&parser, &bind_callbacks, &state);
+    if (cJSON_SaxFeed(&parser, json, length) < 0)
+    {
+        return false;
+    }
+
+    return cJSON_SaxFinish(&parser) == cJSON_SaxDone;
+}
+
+static cJSON_bool write_value(cJSON_Writer * const writer, cJSON_BindType type, size_t size, const cJSON_BindField * const fields, size_t field_count, const char *source)
+{
+    bind_uint bits = 0;
+
+    switch (type)
+    {
+        case cJSON_BindBool:
+            if (!load_bits(source, size, &bits))
+            {
+                return false;
+            }
+            return cJSON_WriterBool(writer, bits != 0);
+
+        case cJSON_BindInt:
+        case cJSON_BindUint:
+            return write_integer(writer, source, size, type == cJSON_BindInt);
+
+        case cJSON_BindDouble:
+            if (size == sizeof(float))
+            {
+                return cJSON_WriterNumber(writer, (double)*(const float*)source);
+            }
+            return cJSON_WriterNumber(writer, *(const double*)source);
+
+        case cJSON_BindString:
+            /* refuse members that are not terminated */
+            if (memchr(source, '\0', size) == NULL)
+            {
+                return false;
+            }
+            return cJSON_WriterString(writer, source);
+
+        case cJSON_BindObject:
+            return cJSON_BindWrite(writer, fields, field_count, source);
+
+        default:
+            return false;
+    }
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_BindWrite(cJSON_Writer * const writer, const cJSON_BindField * const fields, size_t field_count, const void *object)
+{
+    const char *base = (const char*)object;
+    const cJSON_BindField *field = NULL;
+    size_t count = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    if ((writer == NULL) || (fields == NULL) || (object == NULL))
+    {
+        return false;
+    }
+
+    if (!cJSON_WriterBeginObject(writer))
+    {
+        return false;
+    }
+
+    for (i = 0; i < field_count; i++)
+    {
+        field = &fields[i];
+        if (!cJSON_WriterKey(writer, field->name))
+        {
+            return false;
+        }
+
+        if (field->type != cJSON_BindArray)
+        {
+            if (!write_value(writer, field->type, field->size, field->fields, field->field_count, base + field->offset))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        count = *(const size_t*)(base + field->count_offset);
+        if (count > field->capacity)
+        {
+            return false;
+        }
+
+        if (!cJSON_WriterBeginArray(writer))
+        {
+            return false;
+        }
+        for (j = 0; j < count; j++)
+        {
+            if (!write_value(writer, field->element_type, field->size, field->fields, field->field_count, base + field->offset + (j * field->size)))
+            {
+                return false;
+            }
+        }
+        if (!cJSON_WriterEndArray(writer))
+        {
+            return false;
+        }
+    }
+
+    return cJSON_WriterEndObject(writer);
+}
@@ -0,0 +1,128 @@
+/*
+ * cJSON_Bind.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef cJSON_Bind__h
+#define cJSON_Bind__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "cJSON.h"
+#include "cJSON_Sax.h"
+#include "cJSON_Writer.h"
+
+/* Schema driven struct <-> JSON binding.
+ * A struct is described once by a constant table of fields, built at compile time with the CJSON_BIND_* macros.
+ * Decoding runs on the SAX tokenizer and writes straight into the struct, encoding runs on the streaming writer,
+ * no cJSON nodes are created in either direction. Keys are matched case sensitively.
+ *
+ * Example:
+ *
+ *     typedef struct {
+ *         char ssid[33];
+ *         int channel;
+ *         int dns[2];
+ *         size_t dns_count;
+ *     } wifi_cfg_t;
+ *
+ *     static const cJSON_BindField s_wifi_cfg_fields[] = {
+ *         CJSON_BIND_STRING(wifi_cfg_t, ssid),
+ *         CJSON_BIND_INT(wifi_cfg_t, channel),
+ *         CJSON_BIND_ARRAY(wifi_cfg_t, dns, dns_count, cJSON_BindInt),
+ *     };
+ *
+ *     cJSON_BindParse(s_wifi_cfg_fields, CJSON_BIND_COUNT(s_wifi_cfg_fields), &cfg, json, json_length);
+ */
+
+typedef enum
+{
+    cJSON_BindBool,   /* cJSON_bool, int or 1 byte bool */
+    cJSON_BindInt,    /* signed integer of 1, 2, 4 or 8 bytes */
+    cJSON_BindUint,   /* unsigned integer of 1, 2, 4 or 8 bytes */
+    cJSON_BindDouble, /* float or double */
+    cJSON_BindString, /* char array, value must fit including '\0' */
+    cJSON_BindObject, /* nested struct described by fields */
+    cJSON_BindArray   /* fixed capacity array, number of elements in a size_t member */
+} cJSON_BindType;
+
+typedef struct cJSON_BindField
+{
+    const char *name;
+    size_t name_length;
+    cJSON_BindType type;
+    size_t offset;
+    size_t size;                          /* member size, for arrays the size of one element */
+    const struct cJSON_BindField *fields; /* members of an object (or of object array elements) */
+    size_t field_count;
+    cJSON_BindType element_type;          /* arrays only */
+    size_t capacity;                      /* arrays only: number of elements */
+    size_t count_offset;                  /* arrays only: offset of the size_t element counter */
+} cJSON_BindField;
+
+#define CJSON_BIND_COUNT(fields) (sizeof(fields) / sizeof((fields)[0]))
+#define CJSON_BIND_MEMBER_SIZE(type, member) sizeof(((type*)0)->member)
+
+#define CJSON_BIND_SCALAR(type, member, bind_type) \
+    { #member, sizeof(#member) - 1, bind_type, offsetof(type, member), CJSON_BIND_MEMBER_SIZE(type, member), NULL, 0, cJSON_BindBool, 0, 0 }
+
+#define CJSON_BIND_BOOL(type, member)   CJSON_BIND_SCALAR(type, member, cJSON_BindBool)
+#define CJSON_BIND_INT(type, member)    CJSON_BIND_SCALAR(type, member, cJSON_BindInt)
+#define CJSON_BIND_UINT(type, member)   CJSON_BIND_SCALAR(type, member, cJSON_BindUint)
+#define CJSON_BIND_DOUBLE(type, member) CJSON_BIND_SCALAR(type, member, cJSON_BindDouble)
+#define CJSON_BIND_STRING(type, member) CJSON_BIND_SCALAR(type, member, cJSON_BindString)
+
+#define CJSON_BIND_OBJECT(type, member, member_fields) \
+    { #member, sizeof(#member) - 1, cJSON_BindObject, offsetof(type, member), CJSON_BIND_MEMBER_SIZE(type, member), \
+      member_fields, CJSON_BIND_COUNT(member_fields), cJSON_BindBool, 0, 0 }
+
+/* array of bool/int/double/string elements */
+#define CJSON_BIND_ARRAY(type, member, count_member, elem_type) \
+    { #member, sizeof(#member) - 1, cJSON_BindArray, offsetof(type, member), CJSON_BIND_MEMBER_SIZE(type, member[0]), NULL, 0, \
+      elem_type, CJSON_BIND_MEMBER_SIZE(type, member) / CJSON_BIND_MEMBER_SIZE(type, member[0]), offsetof(type, count_member) }
+
+/* array of structs described by elem_fields */
+#define CJSON_BIND_OBJECT_ARRAY(type, member, count_member, elem_fields) \
+    { #member, sizeof(#member) - 1, cJSON_BindArray, offsetof(type, member), CJSON_BIND_MEMBER_SIZE(type, member[0]), \
+      elem_fields, CJSON_BIND_COUNT(elem_fields), cJSON_BindObject, \
+      CJSON_BIND_MEMBER_SIZE(type, member) / CJSON_BIND_MEMBER_SIZE(type, member[0]), offsetof(type, count_member) }
+
+/* Decoder state, used as the user pointer of cJSON_BindCallbacks(). Treat as opaque. */
+typedef struct cJSON_BindState
+{
+    struct
+    {
+        const cJSON_BindField *fields; /* object: members, array: NULL */
+        size_t field_count;
+        const cJSON_BindField *array;  /* array: the array field */
+        char *base;
+    } frames[CJSON_SAX_NESTING_LIMIT];
+    size_t depth;
+    const cJSON_BindField *root_fields;
+    size_t root_field_count;
+    char *root;
+    const cJSON_BindField *pending; /* field the next value is stored into, NULL for unknown keys */
+    size_t skip_depth;              /* > 0 while skipping the value of an unknown key */
+} cJSON_BindState;
+
+/* Prepare decoding into object. Members missing from the input are left untouched, unknown keys are ignored. */
+CJSON_PUBLIC(void) cJSON_BindInit(cJSON_BindState * const state, const cJSON_BindField * const fields, size_t field_count, void *object);
+/* SAX callbacks that decode into the struct given to cJSON_BindInit. A type mismatch, a fraction or a number
+ * out of range of its integer member, a member of unsupported size or an overflowing string/array aborts the parse. */
+CJSON_PUBLIC(const cJSON_SaxCallbacks *) cJSON_BindCallbacks(void);
+/* Decode a complete JSON text into object. */
+CJSON_PUBLIC(cJSON_bool) cJSON_BindParse(const cJSON_BindField * const fields, size_t field_count, void *object, const char *json, size_t length);
+/* Encode object as a JSON object value. Fails on a member of unsupported size. */
+CJSON_PUBLIC(cJSON_bool) cJSON_BindWrite(cJSON_Writer * const writer, const cJSON_BindField * const fields, size_t field_count, const void *object);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
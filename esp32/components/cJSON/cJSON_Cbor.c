@@ -0,0 +1,578 @@
+/*
+ * cJSON_Cbor.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "cJSON_Cbor.h"
+
+/* define our own boolean type */
+#ifdef true
+#undef true
+#endif
+#define true ((cJSON_bool)1)
+
+#ifdef false
+#undef false
+#endif
+#define false ((cJSON_bool)0)
+
+#ifndef NAN
+#ifdef _WIN32
+#define NAN sqrt(-1.0)
+#else
+#define NAN 0.0/0.0
+#endif
+#endif
+
+/* major types */
+#define cbor_unsigned 0
+#define cbor_negative 1
+#define cbor_bytes 2
+#define cbor_text 3
+#define cbor_array 4
+#define cbor_map 5
+#define cbor_tag 6
+#define cbor_simple 7
+
+#define cbor_false 0xF4
+#define cbor_true 0xF5
+#define cbor_null 0xF6
+#define cbor_float32 0xFA
+#define cbor_float64 0xFB
+#define cbor_break 0xFF
+#define cbor_indefinite 31
+
+/* integers of up to 53 bits are exact in a double, larger ones are sent as floats */
+#define cbor_exact_integer 9007199254740992.0
+#define cbor_two_to_32 4294967296.0
+
+typedef struct
+{
+    unsigned char *buffer; /* NULL: only count */
+    size_t size;
+    size_t offset;
+} cbor_encoder;
+
+typedef struct
+{
+    const unsigned char *content;
+    size_t length;
+    size_t offset;
+} cbor_decoder;
+
+static cJSON_bool host_is_little_endian(void)
+{
+    unsigned int one = 1;
+
+    return *(unsigned char*)&one == 1;
+}
+
+/* copy a float/double between host order and the big endian order CBOR uses */
+static void copy_big_endian(unsigned char *output, const unsigned char *input, size_t length)
+{
+    size_t i = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        output[i] = host_is_little_endian() ? input[length - 1 - i] : input[i];
+    }
+}
+
+static void put_byte(cbor_encoder * const encoder, unsigned char byte)
+{
+    if ((encoder->buffer != NULL) && (encoder->offset < encoder->size))
+    {
+        encoder->buffer[encoder->offset] = byte;
+    }
+    encoder->offset++;
+}
+
+static void put_bytes(cbor_encoder * const encoder, const unsigned char *data, size_t length)
+{
+    if ((encoder->buffer != NULL) && (encoder->offset < encoder->size) && (length <= (encoder->size - encoder->offset)))
+    {
+        memcpy(encoder->buffer + encoder->offset, data, length);
+    }
+    encoder->offset += length;
+}
+
+static void put_big_endian(cbor_encoder * const encoder, unsigned long value, size_t length)
+{
+    while (length > 0)
+    {
+        length--;
+        put_byte(encoder, (unsigned char)((value >> (length * 8)) & 0xFF));
+    }
+}
+
+/* initial byte with the shortest argument encoding, high carries bits 32..63 */
+static void put_head(cbor_encoder * const encoder, unsigned char major, unsigned long high, unsigned long low)
+{
+    major = (unsigned char)(major << 5);
+
+    if (high != 0)
+    {
+        put_byte(encoder, (unsigned char)(major | 27));
+        put_big_endian(encoder, high, 4);
+        put_big_endian(encoder, low, 4);
+    }
+    else if (low < 24)
+    {
+        put_byte(encoder, (unsigned char)(major | low));
+    }
+    else if (low <= 0xFF)
+    {
+        put_byte(encoder, (unsigned char)(major | 24));
+        put_big_endian(encoder, low, 1);
+    }
+    else if (low <= 0xFFFF)
+    {
+        put_byte(encoder, (unsigned char)(major | 25));
+        put_big_endian(encoder, low, 2);
+    }
+    else
+    {
+        put_byte(encoder, (unsigned char)(major | 26));
+        put_big_endian(encoder, low, 4);
+    }
+}
+
+static cJSON_bool put_text(cbor_encoder * const encoder, const char *text)
+{
+    size_t length = strlen(text);
+
+    if (length > 0xFFFFFFFFUL)
+    {
+        return false;
+    }
+    put_head(encoder, cbor_text, 0, (unsigned long)length);
+    put_bytes(encoder, (const unsigned char*)text, length);
+
+    return true;
+}
+
+static void put_number(cbor_encoder * const encoder, double number)
+{
+    unsigned char bytes[8];
+    double magnitude = 0;
+    unsigned long high = 0;
+    unsigned long low = 0;
+    float single = 0;
+
+    /* integers, but not -0 */
+    if ((number > -cbor_exact_integer) && (number < cbor_exact_integer) && ((number >= 0) || (number <= -1.0))
+        && !((number == 0) && ((1.0 / number) < 0)))
+    {
+        magnitude = (number < 0) ? (-number - 1.0) : number;
+        high = (unsigned long)(magnitude / cbor_two_to_32);
+        low = (unsigned long)(magnitude - ((double)high * cbor_two_to_32));
+        if ((((double)high * cbor_two_to_32) + (double)low) == magnitude)
+        {
+            put_head(encoder, (number < 0) ? cbor_negative : cbor_unsigned, high, low);
+            return;
+        }
+    }
+
+    if ((number >= -FLT_MAX) && (number <= FLT_MAX) && ((double)(float)number == number))
+    {
+        single = (float)number;
+        put_byte(encoder, cbor_float32);
+        copy_big_endian(bytes, (const unsigned char*)&single, sizeof(single));
+        put_bytes(encoder, bytes, sizeof(single));
+        return;
+    }
+
+    put_byte(encoder, cbor_float64);
+    copy_big_endian(bytes, (const unsigned char*)&number, sizeof(number));
+    put_bytes(encoder, bytes, sizeof(number));
+}
+
+static cJSON_bool encode_item(cbor_encoder * const encoder, const cJSON * const item, size_t depth)
+{
+    const cJSON *child = NULL;
+    unsigned long count = 0;
+
+    switch (item->type & 0xFF)
+    {
+        case cJSON_False:
+            put_byte(encoder, cbor_false);
+            return true;
+
+        case cJSON_True:
+            put_byte(encoder, cbor_true);
+            return true;
+
+        case cJSON_NULL:
+            put_byte(encoder, cbor_null);
+            return true;
+
+        case cJSON_Number:
+            put_number(encoder, item->valuedouble);
+            return true;
+
+        case cJSON_String:
+            return (item->valuestring != NULL) && put_text(encoder, item->valuestring);
+
+        case cJSON_Array:
+        case cJSON_Object:
+            if (depth >= CJSON_CBOR_NESTING_LIMIT)
+            {
+                return false;
+            }
+            for (child = item->child; child != NULL; child = child->next)
+            {
+                count++;
+            }
+            put_head(encoder, cJSON_IsArray(item) ? cbor_array : cbor_map, 0, count);
+            for (child = item->child; child != NULL; child = child->next)
+            {
+                if (cJSON_IsObject(item) && ((child->string == NULL) || !put_text(encoder, child->string)))
+                {
+                    return false;
+                }
+                if (!encode_item(encoder, child, depth + 1))
+                {
+                    return false;
+                }
+            }
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+CJSON_PUBLIC(size_t) cJSON_CborEncode(const cJSON * const item, unsigned char *buffer, size_t size)
+{
+    cbor_encoder encoder = { NULL, 0, 0 };
+
+    if (item == NULL)
+    {
+        return 0;
+    }
+
+    encoder.buffer = buffer;
+    encoder.size = size;
+    if (!encode_item(&encoder, item, 0))
+    {
+        return 0;
+    }
+
+    if ((buffer != NULL) && (encoder.offset > size))
+    {
+        return 0;
+    }
+
+    return encoder.offset;
+}
+
+static cJSON_bool get_big_endian(cbor_decoder * const decoder, size_t length, unsigned long *value)
+{
+    *value = 0;
+    if ((decoder->length - decoder->offset) < length)
+    {
+        return false;
+    }
+    while (length > 0)
+    {
+        *value = (*value << 8) | decoder->content[decoder->offset++];
+        length--;
+    }
+
+    return true;
+}
+
+/* argument following an initial byte, high receives bits 32..63 */
+static cJSON_bool get_argument(cbor_decoder * const decoder, unsigned char info, unsigned long *high, unsigned long *low)
+{
+    *high = 0;
+    *low = 0;
+
+    switch (info)
+    {
+        case 24:
+            return get_big_endian(decoder, 1, low);
+        case 25:
+            return get_big_endian(decoder, 2, low);
+        case 26:
+            return get_big_endian(decoder, 4, low);
+        case 27:
+            return get_big_endian(decoder, 4, high) && get_big_endian(decoder, 4, low);
+        default:
+            if (info < 24)
+            {
+                *low = info;
+                return true;
+            }
+            return false;
+    }
+}
+
+static cJSON_bool get_float(cbor_decoder * const decoder, size_t length, double *number)
+{
+    unsigned char bytes[8];
+    unsigned long half = 0;
+    unsigned long exponent = 0;
+    unsigned long mantissa = 0;
+    float single = 0;
+
+    if (length == 2)
+    {
+        if (!get_big_endian(decoder, 2, &half))
+        {
+            return false;
+        }
+        exponent = (half >> 10) & 0x1F;
+        mantissa = half & 0x3FF;
+        if (exponent == 0)
+        {
+            *number = ldexp((double)mantissa, -24);
+        }
+        else if (exponent != 31)
+        {
+            *number = ldexp((double)(mantissa + 1024), (int)exponent - 25);
+        }
+        else
+        {
+            *number = (mantissa == 0) ? HUGE_VAL : NAN;
+        }
+        if (half & 0x8000)
+        {
+            *number = -*number;
+        }
+        return true;
+    }
+
+    if ((decoder->length - decoder->offset) < length)
+    {
+        return false;
+    }
+    copy_big_endian(bytes, decoder->content + decoder->offset, length);
+    decoder->offset += length;
+
+    if (length == sizeof(single))
+    {
+        memcpy(&single, bytes, sizeof(single));
+        *number = (double)single;
+    }
+    else
+    {
+        memcpy(number, bytes, sizeof(*number));
+    }
+
+    return true;
+}
+
+/* definite length text string as a '\0' terminated copy, strings containing '\0' are rejected */
+static char *get_text(cbor_decoder * const decoder, unsigned char info)
+{
+    unsigned long high = 0;
+    unsigned long length = 0;
+    char *text = NULL;
+
+    if ((info == cbor_indefinite) || !get_argument(decoder, info, &high, &length))
+    {
+        return NULL;
+    }
+    if ((high != 0) || (length > (decoder->length - decoder->offset))
+        || (memchr(decoder->content + decoder->offset, '\0', length) != NULL))
+    {
+        return NULL;
+    }
+
+    text = (char*)cJSON_malloc(length + 1);
+    if (text == NULL)
+    {
+        return NULL;
+    }
+    memcpy(text, decoder->content + decoder->offset, length);
+    text[length] = '\0';
+    decoder->offset += length;
+
+    return text;
+}
+
+static cJSON *decode_item(cbor_decoder * const decoder, size_t depth);
+
+/* children of an array or map, count is ignored for indefinite length containers */
+static cJSON_bool decode_children(cbor_decoder * const decoder, cJSON * const item, cJSON_bool indefinite, unsigned long count, size_t depth)
+{
+    unsigned char initial = 0;
+    char *key = NULL;
+    cJSON *child = NULL;
+
+    for (;;)
+    {
+        if (!indefinite && (count == 0))
+        {
+            break;
+        }
+        if (decoder->offset >= decoder->length)
+        {
+            return false;
+        }
+        if (indefinite && (decoder->content[decoder->offset] == cbor_break))
+        {
+            break;
+        }
+        count--;
+
+        if (cJSON_IsObject(item))
+        {
+            initial = decoder->content[decoder->offset++];
+            if ((initial >> 5) != cbor_text)
+            {
+                return false;
+            }
+            key = get_text(decoder, (unsigned char)(initial & 0x1F));
+            if (key == NULL)
+            {
+                return false;
+            }
+        }
+
+        child = decode_item(decoder, depth + 1);
+        if (child == NULL)
+        {
+            cJSON_free(key);
+            return false;
+        }
+        /* members are appended with the key already in place, no copy */
+        child->string = key;
+        key = NULL;
+        cJSON_AddItemToArray(item, child);
+    }
+
+    if (indefinite)
+    {
+        decoder->offset++;
+    }
+
+    return true;
+}
+
+static cJSON *decode_item(cbor_decoder * const decoder, size_t depth)
+{
+    unsigned char initial = 0;
+    unsigned char major = 0;
+    unsigned char info = 0;
+    unsigned long high = 0;
+    unsigned long low = 0;
+    double number = 0;
+    char *text = NULL;
+    cJSON *item = NULL;
+
+    /* tags only add semantics JSON can't carry, skip them */
+    do
+    {
+        if (decoder->offset >= decoder->length)
+        {
+            return NULL;
+        }
+        initial = decoder->content[decoder->offset++];
+        major = (unsigned char)(initial >> 5);
+        info = (unsigned char)(initial & 0x1F);
+        if ((major == cbor_tag) && !get_argument(decoder, info, &high, &low))
+        {
+            return NULL;
+        }
+    } while (major == cbor_tag);
+
+    switch (major)
+    {
+        case cbor_unsigned:
+        case cbor_negative:
+            if (!get_argument(decoder, info, &high, &low))
+            {
+                return NULL;
+            }
+            number = ((double)high * cbor_two_to_32) + (double)low;
+            return cJSON_CreateNumber((major == cbor_negative) ? (-1.0 - number) : number);
+
+        case cbor_text:
+            text = get_text(decoder, info);
+            if (text == NULL)
+            {
+                return NULL;
+            }
+            item = cJSON_CreateStringReference(text);
+            if (item == NULL)
+            {
+                cJSON_free(text);
+                return NULL;
+            }
+            /* the item owns the copy */
+            item->type &= ~cJSON_IsReference;
+            return item;
+
+        case cbor_array:
+        case cbor_map:
+            if (depth >= CJSON_CBOR_NESTING_LIMIT)
+            {
+                return NULL;
+            }
+            if ((info != cbor_indefinite) && (!get_argument(decoder, info, &high, &low) || (high != 0)))
+            {
+                return NULL;
+            }
+            item = (major == cbor_array) ? cJSON_CreateArray() : cJSON_CreateObject();
+            if ((item != NULL) && !decode_children(decoder, item, info == cbor_indefinite, low, depth))
+            {
+                cJSON_Delete(item);
+                return NULL;
+            }
+            return item;
+
+        case cbor_simple:
+            switch (info)
+            {
+                case 20:
+                    return cJSON_CreateFalse();
+                case 21:
+                    return cJSON_CreateTrue();
+                case 22:
+                case 23:
+                    return cJSON_CreateNull();
+                case 25:
+                case 26:
+                case 27:
+                    if (!get_float(decoder, (size_t)1 << (info - 24), &number))
+                    {
+                        return NULL;
+                    }
+                    return cJSON_CreateNumber(number);
+                default:
+                    return NULL;
+            }
+
+        default:
+            return NULL;
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CborDecode(const unsigned char *data, size_t length, size_t *consumed)
+{
+    cbor_decoder decoder = { NULL, 0, 0 };
+    cJSON *item = NULL;
+
+    if (data == NULL)
+    {
+        return NULL;
+    }
+
+    decoder.content = data;
+    decoder.length = length;
+    item = decode_item(&decoder, 0);
+
+    if ((item != NULL) && (consumed != NULL))
+    {
+        *consumed = decoder.offset;
+    }
+
+    return item;
+}
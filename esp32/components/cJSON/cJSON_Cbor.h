@@ -0,0 +1,41 @@
+/*
+ * cJSON_Cbor.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef cJSON_Cbor__h
+#define cJSON_Cbor__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "cJSON.h"
+
+/* CBOR (RFC 8949) encoding of cJSON items, the binary twin of cJSON_PrintUnformatted/cJSON_Parse.
+ * Integral numbers are encoded as CBOR integers, other numbers as single precision floats when that is
+ * lossless and double precision otherwise. Objects become maps with text string keys.
+ *
+ * Decoding accepts the subset that maps onto JSON: integers, floats (half/single/double), definite length
+ * text strings, definite and indefinite length arrays and maps with text string keys, true/false/null
+ * (undefined reads as null). Tags are skipped. Byte strings and other simple values are rejected. */
+
+/* Limits how deeply nested arrays/maps can be, both ways. */
+#ifndef CJSON_CBOR_NESTING_LIMIT
+#define CJSON_CBOR_NESTING_LIMIT 32
+#endif
+
+/* Encode item into buffer. Returns the number of bytes written, or 0 if the buffer is too small or the
+ * item can't be encoded (raw or invalid items, too deep). With buffer NULL only the size is computed. */
+CJSON_PUBLIC(size_t) cJSON_CborEncode(const cJSON * const item, unsigned char *buffer, size_t size);
+/* Decode one CBOR data item. Returns NULL on malformed or unsupported input.
+ * If consumed isn't NULL it receives the number of bytes used, trailing data is left to the caller. */
+CJSON_PUBLIC(cJSON *) cJSON_CborDecode(const unsigned char *data, size_t length, size_t *consumed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,713 @@
+/*
+ * cJSON_Compact.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <string.h>
+#include <math.h>
+
+#include "cJSON_Compact.h"
+
+/* define our own boolean type */
+#ifdef true
+#undef true
+#endif
+#define true ((cJSON_bool)1)
+
+#ifdef false
+#undef false
+#endif
+#define false ((cJSON_bool)0)
+
+#ifndef NAN
+#ifdef _WIN32
+#define NAN sqrt(-1.0)
+#else
+#define NAN 0.0/0.0
+#endif
+#endif
+
+/* largest node index and string pool offset, CJSON_COMPACT_NONE itself is reserved */
+#define compact_limit 0xFFFFu
+
+/* initial capacities, grown by half each time they are exceeded */
+#define compact_initial_nodes 16
+#define compact_initial_strings 128
+#define compact_initial_keys 16
+
+typedef struct
+{
+    union
+    {
+        double number;
+        struct
+        {
+            unsigned short offset; /* into the string pool */
+            unsigned short length;
+        } string;
+        unsigned short count; /* elements/members of arrays and objects */
+    } value;
+    unsigned short key;  /* pool offset of the interned key for object members, CJSON_COMPACT_NONE otherwise */
+    unsigned short next; /* next sibling, CJSON_COMPACT_NONE for the last one */
+    unsigned char type;
+} compact_node;
+
+struct cJSON_CompactDoc
+{
+    compact_node *nodes;
+    size_t node_count;
+    size_t node_capacity;
+    char *strings; /* '\0' terminated keys and values */
+    size_t string_length;
+    size_t string_capacity;
+    unsigned short *keys; /* open addressing table of interned keys (pool offsets), CJSON_COMPACT_NONE when free */
+    size_t key_count;
+    size_t key_capacity; /* power of two */
+    /* only used while building */
+    struct
+    {
+        unsigned short node;
+        unsigned short last; /* last child so far */
+    } stack[CJSON_SAX_NESTING_LIMIT];
+    size_t depth;
+    unsigned short pending_key;
+    cJSON_bool failed;
+};
+
+static unsigned long hash_key(const char *key, size_t length)
+{
+    unsigned long hash = 2166136261UL;
+    size_t i = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        hash = ((hash ^ (unsigned char)key[i]) * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    return hash;
+}
+
+/* resize a block to capacity elements, keeping the first used ones */
+static cJSON_bool resize_block(void **block, size_t used, size_t capacity, size_t element_size)
+{
+    void *resized = cJSON_malloc(capacity * element_size);
+
+    if (resized == NULL)
+    {
+        return false;
+    }
+
+    if (*block != NULL)
+    {
+        memcpy(resized, *block, used * element_size);
+        cJSON_free(*block);
+    }
+    *block = resized;
+
+    return true;
+}
+
+/* make room for needed more elements, never past compact_limit of them */
+static cJSON_bool reserve(void **block, size_t used, size_t * const capacity, size_t needed, size_t initial, size_t element_size)
+{
+    size_t new_capacity = *capacity;
+
+    if ((used + needed) <= *capacity)
+    {
+        return true;
+    }
+
+    if ((used + needed) > compact_limit)
+    {
+        return false;
+    }
+
+    if (new_capacity == 0)
+    {
+        new_capacity = initial;
+    }
+    while (new_capacity < (used + needed))
+    {
+        new_capacity += new_capacity / 2;
+    }
+    if (new_capacity > compact_limit)
+    {
+        new_capacity = compact_limit;
+    }
+
+    if (!resize_block(block, used, new_capacity, element_size))
+    {
+        return false;
+    }
+    *capacity = new_capacity;
+
+    return true;
+}
+
+/* slot of key in the key table: either the interned key or the free slot it would go into */
+static size_t find_key_slot(const cJSON_CompactDoc * const doc, const char *key, size_t length)
+{
+    size_t mask = doc->key_capacity - 1;
+    size_t slot = (size_t)hash_key(key, length) & mask;
+    const char *interned = NULL;
+
+    while (doc->keys[slot] != CJSON_COMPACT_NONE)
+    {
+        interned = doc->strings + doc->keys[slot];
+        if ((strncmp(interned, key, length) == 0) && (interned[length] == '\0'))
+        {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+static cJSON_bool grow_key_table(cJSON_CompactDoc * const doc)
+{
+    unsigned short *old_keys = doc->keys;
+    size_t old_capacity = doc->key_capacity;
+    size_t capacity = (old_capacity == 0) ? compact_initial_keys : (old_capacity * 2);
+    const char *key = NULL;
+    size_t i = 0;
+
+    doc->keys = (unsigned short*)cJSON_malloc(capacity * sizeof(unsigned short));
+    if (doc->keys == NULL)
+    {
+        doc->keys = old_keys;
+        return false;
+    }
+    for (i = 0; i < capacity; i++)
+    {
+        doc->keys[i] = CJSON_COMPACT_NONE;
+    }
+    doc->key_capacity = capacity;
+
+    for (i = 0; i < old_capacity; i++)
+    {
+        if (old_keys[i] != CJSON_COMPACT_NONE)
+        {
+            key = doc->strings + old_keys[i];
+            doc->keys[find_key_slot(doc, key, strlen(key))] = old_keys[i];
+        }
+    }
+    cJSON_free(old_keys);
+
+    return true;
+}
+
+/* copy a string into the pool, returns its offset or CJSON_COMPACT_NONE */
+static unsigned short add_string(cJSON_CompactDoc * const doc, const char *string, size_t length)
+{
+    size_t offset = doc->string_length;
+
+    if (!reserve((void**)&doc->strings, doc->string_length, &doc->string_capacity, length + 1, compact_initial_strings, sizeof(char)))
+    {
+        return CJSON_COMPACT_NONE;
+    }
+
+    memcpy(doc->strings + offset, string, length);
+    doc->strings[offset + length] = '\0';
+    doc->string_length += length + 1;
+
+    return (unsigned short)offset;
+}
+
+static unsigned short intern_key(cJSON_CompactDoc * const doc, const char *key, size_t length)
+{
+    size_t slot = 0;
+    unsigned short offset = 0;
+
+    /* keep the load factor below 3/4 */
+    if ((((doc->key_count + 1) * 4) > (doc->key_capacity * 3)) && !grow_key_table(doc))
+    {
+        return CJSON_COMPACT_NONE;
+    }
+
+    slot = find_key_slot(doc, key, length);
+    if (doc->keys[slot] != CJSON_COMPACT_NONE)
+    {
+        return doc->keys[slot];
+    }
+
+    offset = add_string(doc, key, length);
+    if (offset != CJSON_COMPACT_NONE)
+    {
+        doc->keys[slot] = offset;
+        doc->key_count++;
+    }
+
+    return offset;
+}
+
+/* append a node for the next value and link it to its parent, returns NULL on failure */
+static compact_node *add_node(cJSON_CompactDoc * const doc, unsigned char type)
+{
+    compact_node *node = NULL;
+    size_t index = doc->node_count;
+
+    if (doc->failed)
+    {
+        return NULL;
+    }
+
+    /* only one value at the top level */
+    if ((doc->depth == 0) && (doc->node_count != 0))
+    {
+        doc->failed = true;
+        return NULL;
+    }
+
+    if (!reserve((void**)&doc->nodes, doc->node_count, &doc->node_capacity, 1, compact_initial_nodes, sizeof(compact_node)))
+    {
+        doc->failed = true;
+        return NULL;
+    }
+
+    node = &doc->nodes[index];
+    memset(node, '\0', sizeof(compact_node));
+    node->type = type;
+    node->key = doc->pending_key;
+    node->next = CJSON_COMPACT_NONE;
+    doc->pending_key = CJSON_COMPACT_NONE;
+    doc->node_count++;
+
+    if (doc->depth > 0)
+    {
+        if (doc->stack[doc->depth - 1].last != CJSON_COMPACT_NONE)
+        {
+            doc->nodes[doc->stack[doc->depth - 1].last].next = (unsigned short)index;
+        }
+        doc->stack[doc->depth - 1].last = (unsigned short)index;
+        doc->nodes[doc->stack[doc->depth - 1].node].value.count++;
+    }
+
+    return node;
+}
+
+static cJSON_bool compact_open(cJSON_CompactDoc * const doc, unsigned char type)
+{
+    size_t index = doc->node_count;
+
+    if (doc->depth >= CJSON_SAX_NESTING_LIMIT)
+    {
+        doc->failed = true;
+        return false;
+    }
+
+    if (add_node(doc, type) == NULL)
+    {
+        return false;
+    }
+
+    doc->stack[doc->depth].node = (unsigned short)index;
+    doc->stack[doc->depth].last = CJSON_COMPACT_NONE;
+    doc->depth++;
+
+    return true;
+}
+
+static cJSON_bool compact_start_object(void *user)
+{
+    return compact_open((cJSON_CompactDoc*)user, cJSON_Object);
+}
+
+static cJSON_bool compact_start_array(void *user)
+{
+    return compact_open((cJSON_CompactDoc*)user, cJSON_Array);
+}
+
+static cJSON_bool compact_end(void *user)
+{
+    cJSON_CompactDoc *doc = (cJSON_CompactDoc*)user;
+
+    if (doc->depth == 0)
+    {
+        doc->failed = true;
+        return false;
+    }
+    doc->depth--;
+
+    return true;
+}
+
+static cJSON_bool compact_key(void *user, const char *key, size_t length)
+{
+    cJSON_CompactDoc *doc = (cJSON_CompactDoc*)user;
+
+    /* keys are C strings, like in cJSON an escaped '\0' ends them */
+    (void)length;
+    doc->pending_key = intern_key(doc, key, strlen(key));
+    if (doc->pending_key == CJSON_COMPACT_NONE)
+    {
+        doc->failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+static cJSON_bool compact_string(void *user, const char *value, size_t length)
+{
+    cJSON_CompactDoc *doc = (cJSON_CompactDoc*)user;
+    compact_node *node = NULL;
+    unsigned short offset = add_string(doc, value, length);
+
+    if (offset == CJSON_COMPACT_NONE)
+    {
+        doc->failed = true;
+        return false;
+    }
+
+    /* add_node after add_string, the pool may have moved but nodes didn't */
+    node = add_node(doc, cJSON_String);
+    if (node == NULL)
+    {
+        return false;
+    }
+    node->value.string.offset = offset;
+    node->value.string.length = (unsigned short)length;
+
+    return true;
+}
+
+static cJSON_bool compact_number(void *user, double value, const char *text, size_t length)
+{
+    compact_node *node = add_node((cJSON_CompactDoc*)user, cJSON_Number);
+
+    (void)text;
+    (void)length;
+
+    if (node == NULL)
+    {
+        return false;
+    }
+    node->value.number = value;
+
+    return true;
+}
+
+static cJSON_bool compact_boolean(void *user, cJSON_bool value)
+{
+    return add_node((cJSON_CompactDoc*)user, value ? cJSON_True : cJSON_False) != NULL;
+}
+
+static cJSON_bool compact_null(void *user)
+{
+    return add_node((cJSON_CompactDoc*)user, cJSON_NULL) != NULL;
+}
+
+static const cJSON_SaxCallbacks compact_callbacks =
+{
+    compact_start_object,
+    compact_end,
+    compact_start_array,
+    compact_end,
+    compact_key,
+    compact_string,
+    compact_number,
+    compact_boolean,
+    compact_null,
+    NULL
+};
+
+CJSON_PUBLIC(cJSON_CompactDoc *) cJSON_CompactCreate(void)
+{
+    cJSON_CompactDoc *doc = (cJSON_CompactDoc*)cJSON_malloc(sizeof(cJSON_CompactDoc));
+
+    if (doc == NULL)
+    {
+        return NULL;
+    }
+
+    memset(doc, '\0', sizeof(cJSON_CompactDoc));
+    doc->pending_key = CJSON_COMPACT_NONE;
+
+    return doc;
+}
+
+CJSON_PUBLIC(const cJSON_SaxCallbacks *) cJSON_CompactCallbacks(void)
+{
+    return &compact_callbacks;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_CompactFinish(cJSON_CompactDoc * const doc)
+{
+    if ((doc == NULL) || doc->failed || (doc->depth != 0) || (doc->node_count == 0))
+    {
+        return false;
+    }
+
+    /* documents are read only from here on, drop the spare capacity */
+    if ((doc->node_count < doc->node_capacity) && resize_block((void**)&doc->nodes, doc->node_count, doc->node_count, sizeof(compact_node)))
+    {
+        doc->node_capacity = doc->node_count;
+    }
+    if ((doc->string_length != 0) && (doc->string_length < doc->string_capacity)
+        && resize_block((void**)&doc->strings, doc->string_length, doc->string_length, sizeof(char)))
+    {
+        doc->string_capacity = doc->string_length;
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_CompactDoc *) cJSON_CompactParse(const char *json, size_t length)
+{
+    cJSON_CompactDoc *doc = NULL;
+    cJSON_SaxParser parser;
+
+    if (json == NULL)
+    {
+        return NULL;
+    }
+
+    doc = cJSON_CompactCreate();
+    if (doc == NULL)
+    {
+        return NULL;
+    }
+
+    cJSON_SaxInit(&parser, &compact_callbacks, doc);
+    if ((cJSON_SaxFeed(&parser, json, length) < 0) || (cJSON_SaxFinish(&parser) != cJSON_SaxDone) || !cJSON_CompactFinish(doc))
+    {
+        cJSON_CompactDelete(doc);
+        return NULL;
+    }
+
+    return doc;
+}
+
+CJSON_PUBLIC(void) cJSON_CompactDelete(cJSON_CompactDoc *doc)
+{
+    if (doc == NULL)
+    {
+        return;
+    }
+
+    if (doc->nodes != NULL)
+    {
+        cJSON_free(doc->nodes);
+    }
+    if (doc->strings != NULL)
+    {
+        cJSON_free(doc->strings);
+    }
+    if (doc->keys != NULL)
+    {
+        cJSON_free(doc->keys);
+    }
+    cJSON_free(doc);
+}
+
+CJSON_PUBLIC(size_t) cJSON_CompactMemoryUsage(const cJSON_CompactDoc * const doc)
+{
+    if (doc == NULL)
+    {
+        return 0;
+    }
+
+    return sizeof(cJSON_CompactDoc) + (doc->node_capacity * sizeof(compact_node))
+           + doc->string_capacity + (doc->key_capacity * sizeof(unsigned short));
+}
+
+/* node behind a reference, NULL for CJSON_COMPACT_NONE and out of range references */
+static const compact_node *get_node(const cJSON_CompactDoc * const doc, cJSON_CompactRef node)
+{
+    if ((doc == NULL) || (node >= doc->node_count))
+    {
+        return NULL;
+    }
+
+    return &doc->nodes[node];
+}
+
+CJSON_PUBLIC(cJSON_CompactRef) cJSON_CompactRoot(const cJSON_CompactDoc * const doc)
+{
+    return ((doc != NULL) && (doc->node_count != 0)) ? 0 : CJSON_COMPACT_NONE;
+}
+
+CJSON_PUBLIC(int) cJSON_CompactType(const cJSON_CompactDoc * const doc, cJSON_CompactRef node)
+{
+    const compact_node *item = get_node(doc, node);
+
+    return (item != NULL) ? item->type : cJSON_Invalid;
+}
+
+CJSON_PUBLIC(cJSON_CompactRef) cJSON_CompactChild(const cJSON_CompactDoc * const doc, cJSON_CompactRef node)
+{
+    const compact_node *item = get_node(doc, node);
+
+    /* nodes are stored in document order, so the first child follows its parent */
+    if ((item == NULL) || ((item->type != cJSON_Array) && (item->type != cJSON_Object)) || (item->value.count == 0))
+    {
+        return CJSON_COMPACT_NONE;
+    }
+
+    return (cJSON_CompactRef)(node + 1);
+}
+
+CJSON_PUBLIC(cJSON_CompactRef) cJSON_CompactNext(const cJSON_CompactDoc * const doc, cJSON_CompactRef node)
+{
+    const compact_node *item = get_node(doc, node);
+
+    return (item != NULL) ? item->next : CJSON_COMPACT_NONE;
+}
+
+CJSON_PUBLIC(const char *) cJSON_CompactKey(const cJSON_CompactDoc * const doc, cJSON_CompactRef node)
+{
+    const compact_node *item = get_node(doc, node);
+
+    if ((item == NULL) || (item->key == CJSON_COMPACT_NONE))
+    {
+        return NULL;
+    }
+
+    return doc->strings + item->key;
+}
+
+CJSON_PUBLIC(int) cJSON_CompactGetArraySize(const cJSON_CompactDoc * const doc, cJSON_CompactRef array)
+{
+    const compact_node *item = get_node(doc, array);
+
+    if ((item == NULL) || ((item->type != cJSON_Array) && (item->type != cJSON_Object)))
+    {
+        return 0;
+    }
+
+    return item->value.count;
+}
+
+CJSON_PUBLIC(cJSON_CompactRef) cJSON_CompactGetArrayItem(const cJSON_CompactDoc * const doc, cJSON_CompactRef array, int index)
+{
+    cJSON_CompactRef child = CJSON_COMPACT_NONE;
+
+    if ((index < 0) || (index >= cJSON_CompactGetArraySize(doc, array)))
+    {
+        return CJSON_COMPACT_NONE;
+    }
+
+    child = cJSON_CompactChild(doc, array);
+    while ((index > 0) && (child != CJSON_COMPACT_NONE))
+    {
+        child = doc->nodes[child].next;
+        index--;
+    }
+
+    return child;
+}
+
+CJSON_PUBLIC(cJSON_CompactRef) cJSON_CompactGetObjectItem(const cJSON_CompactDoc * const doc, cJSON_CompactRef object, const char * const key)
+{
+    const compact_node *item = get_node(doc, object);
+    cJSON_CompactRef child = CJSON_COMPACT_NONE;
+    unsigned short interned = CJSON_COMPACT_NONE;
+
+    if ((item == NULL) || (item->type != cJSON_Object) || (key == NULL) || (doc->key_capacity == 0))
+    {
+        return CJSON_COMPACT_NONE;
+    }
+
+    /* a key that was never interned can't be a member, otherwise members are compared by offset */
+    interned = doc->keys[find_key_slot(doc, key, strlen(key))];
+    if (interned == CJSON_COMPACT_NONE)
+    {
+        return CJSON_COMPACT_NONE;
+    }
+
+    for (child = cJSON_CompactChild(doc, object); child != CJSON_COMPACT_NONE; child = doc->nodes[child].next)
+    {
+        if (doc->nodes[child].key == interned)
+        {
+            return child;
+        }
+    }
+
+    return CJSON_COMPACT_NONE;
+}
+
+CJSON_PUBLIC(const char *) cJSON_CompactGetStringValue(const cJSON_CompactDoc * const doc, cJSON_CompactRef node)
+{
+    const compact_node *item = get_node(doc, node);
+
+    if ((item == NULL) || (item->type != cJSON_String))
+    {
+        return NULL;
+    }
+
+    return doc->strings + item->value.string.offset;
+}
+
+CJSON_PUBLIC(double) cJSON_CompactGetNumberValue(const cJSON_CompactDoc * const doc, cJSON_CompactRef node)
+{
+    const compact_node *item = get_node(doc, node);
+
+    if ((item == NULL) || (item->type != cJSON_Number))
+    {
+        return (double) NAN;
+    }
+
+    return item->value.number;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_CompactWrite(cJSON_Writer * const writer, const cJSON_CompactDoc * const doc, cJSON_CompactRef node)
+{
+    const compact_node *item = get_node(doc, node);
+    cJSON_CompactRef child = CJSON_COMPACT_NONE;
+
+    if ((writer == NULL) || (item == NULL))
+    {
+        return false;
+    }
+
+    switch (item->type)
+    {
+        case cJSON_NULL:
+            return cJSON_WriterNull(writer);
+
+        case cJSON_False:
+            return cJSON_WriterBool(writer, false);
+
+        case cJSON_True:
+            return cJSON_WriterBool(writer, true);
+
+        case cJSON_Number:
+            return cJSON_WriterNumber(writer, item->value.number);
+
+        case cJSON_String:
+            return cJSON_WriterString(writer, doc->strings + item->value.string.offset);
+
+        case cJSON_Array:
+            if (!cJSON_WriterBeginArray(writer))
+            {
+                return false;
+            }
+            for (child = cJSON_CompactChild(doc, node); child != CJSON_COMPACT_NONE; child = doc->nodes[child].next)
+            {
+                if (!cJSON_CompactWrite(writer, doc, child))
+                {
+                    return false;
+                }
+            }
+            return cJSON_WriterEndArray(writer);
+
+        case cJSON_Object:
+            if (!cJSON_WriterBeginObject(writer))
+            {
+                return false;
+            }
+            for (child = cJSON_CompactChild(doc, node); child != CJSON_COMPACT_NONE; child = doc->nodes[child].next)
+            {
+                if (!cJSON_WriterKey(writer, doc->strings + doc->nodes[child].key) || !cJSON_CompactWrite(writer, doc, child))
+                {
+                    return false;
+                }
+            }
+            return cJSON_WriterEndObject(writer);
+
+        default:
+            return false;
+    }
+}
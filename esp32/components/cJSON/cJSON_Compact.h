@@ -0,0 +1,68 @@
+/*
+ * cJSON_Compact.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef cJSON_Compact__h
+#define cJSON_Compact__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "cJSON.h"
+#include "cJSON_Sax.h"
+#include "cJSON_Writer.h"
+
+/* Compact read-only document.
+ * A cJSON tree costs a node of about 40 bytes plus a heap block for the key and one for the string value
+ * per member. A compact document keeps all nodes in one array and all strings in one pool: a node is a
+ * 16 byte tagged union addressed by a 16 bit index, keys are interned, so objects of the same shape
+ * (arrays of records, telemetry samples) store every key name once and compare keys as integers.
+ * A document holds at most 65534 nodes and 64 KiB of string data.
+ *
+ * Nodes are referenced by cJSON_CompactRef, the root is cJSON_CompactRoot(doc). Every accessor accepts
+ * CJSON_COMPACT_NONE and returns CJSON_COMPACT_NONE (or 0/NULL) for it, so lookups can be chained. */
+
+typedef unsigned short cJSON_CompactRef;
+#define CJSON_COMPACT_NONE ((cJSON_CompactRef)0xFFFF)
+
+typedef struct cJSON_CompactDoc cJSON_CompactDoc;
+
+/* Parse a complete JSON text. Returns NULL on malformed input, allocation failure or exceeded limits. */
+CJSON_PUBLIC(cJSON_CompactDoc *) cJSON_CompactParse(const char *json, size_t length);
+/* For streaming: create an empty document, feed it through a SAX parser using cJSON_CompactCallbacks()
+ * with the document as user pointer, then call cJSON_CompactFinish. */
+CJSON_PUBLIC(cJSON_CompactDoc *) cJSON_CompactCreate(void);
+CJSON_PUBLIC(const cJSON_SaxCallbacks *) cJSON_CompactCallbacks(void);
+/* Check that a complete document was built and release unused capacity. */
+CJSON_PUBLIC(cJSON_bool) cJSON_CompactFinish(cJSON_CompactDoc * const doc);
+CJSON_PUBLIC(void) cJSON_CompactDelete(cJSON_CompactDoc *doc);
+/* Bytes of heap used by the document. */
+CJSON_PUBLIC(size_t) cJSON_CompactMemoryUsage(const cJSON_CompactDoc * const doc);
+
+CJSON_PUBLIC(cJSON_CompactRef) cJSON_CompactRoot(const cJSON_CompactDoc * const doc);
+/* cJSON_False, cJSON_True, cJSON_NULL, cJSON_Number, cJSON_String, cJSON_Array or cJSON_Object,
+ * cJSON_Invalid for CJSON_COMPACT_NONE. */
+CJSON_PUBLIC(int) cJSON_CompactType(const cJSON_CompactDoc * const doc, cJSON_CompactRef node);
+/* Iterate over array elements or object members. */
+CJSON_PUBLIC(cJSON_CompactRef) cJSON_CompactChild(const cJSON_CompactDoc * const doc, cJSON_CompactRef node);
+CJSON_PUBLIC(cJSON_CompactRef) cJSON_CompactNext(const cJSON_CompactDoc * const doc, cJSON_CompactRef node);
+/* Key of an object member, NULL otherwise. */
+CJSON_PUBLIC(const char *) cJSON_CompactKey(const cJSON_CompactDoc * const doc, cJSON_CompactRef node);
+CJSON_PUBLIC(int) cJSON_CompactGetArraySize(const cJSON_CompactDoc * const doc, cJSON_CompactRef array);
+CJSON_PUBLIC(cJSON_CompactRef) cJSON_CompactGetArrayItem(const cJSON_CompactDoc * const doc, cJSON_CompactRef array, int index);
+/* Keys are matched case sensitively. */
+CJSON_PUBLIC(cJSON_CompactRef) cJSON_CompactGetObjectItem(const cJSON_CompactDoc * const doc, cJSON_CompactRef object, const char * const key);
+CJSON_PUBLIC(const char *) cJSON_CompactGetStringValue(const cJSON_CompactDoc * const doc, cJSON_CompactRef node);
+CJSON_PUBLIC(double) cJSON_CompactGetNumberValue(const cJSON_CompactDoc * const doc, cJSON_CompactRef node);
+/* Write a node and everything below it. */
+CJSON_PUBLIC(cJSON_bool) cJSON_CompactWrite(cJSON_Writer * const writer, const cJSON_CompactDoc * const doc, cJSON_CompactRef node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,377 @@
+/*
+ * cJSON_Pointer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <string.h>
+#include <limits.h>
+
+#include "cJSON_Pointer.h"
+
+/* define our own boolean type */
+#ifdef true
+#undef true
+#endif
+#define true ((cJSON_bool)1)
+
+#ifdef false
+#undef false
+#endif
+#define false ((cJSON_bool)0)
+
+typedef struct
+{
+    const char *key; /* unescaped, '\0' terminated */
+    size_t length;
+    unsigned long hash;
+    int index; /* array index, -1 if the token can't be one */
+} pointer_token;
+
+struct cJSON_Pointer
+{
+    size_t count;
+    pointer_token *tokens;
+};
+
+static unsigned long hash_key(const char *key, size_t length)
+{
+    unsigned long hash = 2166136261UL;
+    size_t i = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        hash = ((hash ^ (unsigned char)key[i]) * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    return hash;
+}
+
+/* array index of an escaped token: "0" or digits without leading zero, -1 otherwise ("-" included) */
+static int token_index(const char *token, size_t length)
+{
+    int index = 0;
+    size_t i = 0;
+
+    if ((length == 0) || ((token[0] == '0') && (length > 1)))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        if ((token[i] < '0') || (token[i] > '9') || (index > ((INT_MAX - (token[i] - '0')) / 10)))
+        {
+            return -1;
+        }
+        index = (index * 10) + (token[i] - '0');
+    }
+
+    return index;
+}
+
+/* length of the token at the start of pointer, which points behind a '/' */
+static size_t token_length(const char *pointer)
+{
+    const char *end = strchr(pointer, '/');
+
+    return (end != NULL) ? (size_t)(end - pointer) : strlen(pointer);
+}
+
+/* unescape ~0 and ~1, returns false for any other use of '~' */
+static cJSON_bool unescape_token(const char *token, size_t length, char *output, size_t * const output_length)
+{
+    size_t i = 0;
+    size_t written = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        if (token[i] != '~')
+        {
+            output[written++] = token[i];
+            continue;
+        }
+
+        if ((i + 1) >= length)
+        {
+            return false;
+        }
+        i++;
+        if (token[i] == '0')
+        {
+            output[written++] = '~';
+        }
+        else if (token[i] == '1')
+        {
+            output[written++] = '/';
+        }
+        else
+        {
+            return false;
+        }
+    }
+    output[written] = '\0';
+    *output_length = written;
+
+    return true;
+}
+
+/* whether an object member has the given key */
+static cJSON_bool key_equals(const cJSON * const item, const char *key, size_t length)
+{
+    return (item->string != NULL) && (item->string[0] == key[0]) && (strncmp(item->string, key, length) == 0) && (item->string[length] == '\0');
+}
+
+static cJSON *get_child(const cJSON * const node, const pointer_token * const token)
+{
+    cJSON *child = NULL;
+    int index = 0;
+
+    if (cJSON_IsObject(node))
+    {
+        for (child = node->child; child != NULL; child = child->next)
+        {
+            if (key_equals(child, token->key, token->length))
+            {
+                return child;
+            }
+        }
+        return NULL;
+    }
+
+    if (cJSON_IsArray(node) && (token->index >= 0))
+    {
+        for (child = node->child; (child != NULL) && (index < token->index); child = child->next)
+        {
+            index++;
+        }
+        return child;
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON_Pointer *) cJSON_PointerCompile(const char *pointer)
+{
+    cJSON_Pointer *compiled = NULL;
+    char *keys = NULL;
+    const char *token = NULL;
+    size_t count = 0;
+    size_t length = 0;
+    size_t i = 0;
+
+    if ((pointer == NULL) || ((pointer[0] != '\0') && (pointer[0] != '/')))
+    {
+        return NULL;
+    }
+
+    for (token = pointer; *token != '\0'; token++)
+    {
+        if (*token == '/')
+        {
+            count++;
+        }
+    }
+
+    /* one block: header, tokens, then the unescaped keys (never longer than the pointer) */
+    compiled = (cJSON_Pointer*)cJSON_malloc(sizeof(cJSON_Pointer) + (count * sizeof(pointer_token)) + strlen(pointer) + 1);
+    if (compiled == NULL)
+    {
+        return NULL;
+    }
+    compiled->count = count;
+    compiled->tokens = (pointer_token*)(compiled + 1);
+    keys = (char*)(compiled->tokens + count);
+
+    token = pointer;
+    for (i = 0; i < count; i++)
+    {
+        token++; /* skip '/' */
+        length = token_length(token);
+        if (!unescape_token(token, length, keys, &compiled->tokens[i].length))
+        {
+            cJSON_free(compiled);
+            return NULL;
+        }
+        compiled->tokens[i].key = keys;
+        compiled->tokens[i].hash = hash_key(keys, compiled->tokens[i].length);
+        compiled->tokens[i].index = token_index(token, length);
+
+        keys += compiled->tokens[i].length + 1;
+        token += length;
+    }
+
+    return compiled;
+}
+
+CJSON_PUBLIC(void) cJSON_PointerDelete(cJSON_Pointer *pointer)
+{
+    if (pointer != NULL)
+    {
+        cJSON_free(pointer);
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_PointerGet(const cJSON_Pointer * const pointer, const cJSON * const root)
+{
+    const cJSON *node = root;
+    size_t i = 0;
+
+    if ((pointer == NULL) || (root == NULL))
+    {
+        return NULL;
+    }
+
+    for (i = 0; (i < pointer->count) && (node != NULL); i++)
+    {
+        node = get_child(node, &pointer->tokens[i]);
+    }
+
+    return (cJSON*)node;
+}
+
+/* Resolve the pointers listed in active (indexes into pointers) below node, which all matched the first
+ * depth tokens. Members of an object are hashed once and compared against every pending token. */
+static void resolve_many(const cJSON * const node, size_t depth, const cJSON_Pointer * const *pointers, const unsigned char * const active, size_t active_count, cJSON **results, size_t * const found)
+{
+    unsigned char pending[CJSON_POINTER_BATCH_LIMIT];
+    unsigned char matched[CJSON_POINTER_BATCH_LIMIT];
+    size_t pending_count = 0;
+    size_t matched_count = 0;
+    const pointer_token *token = NULL;
+    const cJSON *child = NULL;
+    unsigned long hash = 0;
+    size_t length = 0;
+    int index = 0;
+    size_t i = 0;
+
+    for (i = 0; i < active_count; i++)
+    {
+        if (pointers[active[i]]->count == depth)
+        {
+            results[active[i]] = (cJSON*)node;
+            (*found)++;
+        }
+        else
+        {
+            pending[pending_count++] = active[i];
+        }
+    }
+
+    if (!cJSON_IsObject(node) && !cJSON_IsArray(node))
+    {
+        return;
+    }
+
+    /* stop as soon as every pending pointer found its child, the first match wins like in cJSON_GetObjectItem */
+    for (child = node->child; (child != NULL) && (pending_count > 0); child = child->next, index++)
+    {
+        if (cJSON_IsObject(node))
+        {
+            if (child->string == NULL)
+            {
+                continue;
+            }
+            length = strlen(child->string);
+            hash = hash_key(child->string, length);
+        }
+
+        matched_count = 0;
+        for (i = 0; i < pending_count; i++)
+        {
+            token = &pointers[pending[i]]->tokens[depth];
+            if (cJSON_IsObject(node)
+                ? ((token->hash == hash) && (token->length == length) && (memcmp(token->key, child->string, length) == 0))
+                : (token->index == index))
+            {
+                matched[matched_count++] = pending[i];
+                pending[i] = pending[--pending_count];
+                i--;
+            }
+        }
+
+        if (matched_count > 0)
+        {
+            resolve_many(child, depth + 1, pointers, matched, matched_count, results, found);
+        }
+    }
+}
+
+CJSON_PUBLIC(size_t) cJSON_PointerGetMany(const cJSON_Pointer * const *pointers, size_t count, const cJSON * const root, cJSON **results)
+{
+    unsigned char active[CJSON_POINTER_BATCH_LIMIT];
+    size_t active_count = 0;
+    size_t found = 0;
+    size_t batch = 0;
+    size_t i = 0;
+
+    if ((pointers == NULL) || (results == NULL))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        results[i] = NULL;
+    }
+
+    if (root == NULL)
+    {
+        return 0;
+    }
+
+    for (batch = 0; batch < count; batch += CJSON_POINTER_BATCH_LIMIT)
+    {
+        active_count = 0;
+        for (i = 0; (i < CJSON_POINTER_BATCH_LIMIT) && ((batch + i) < count); i++)
+        {
+            if (pointers[batch + i] != NULL)
+            {
+                active[active_count++] = (unsigned char)i;
+            }
+        }
+        resolve_many(root, 0, pointers + batch, active, active_count, results + batch, &found);
+    }
+
+    return found;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_PointerGetItem(const cJSON * const root, const char *pointer)
+{
+    const cJSON *node = root;
+    char key[64];
+    pointer_token token;
+    size_t length = 0;
+
+    if ((root == NULL) || (pointer == NULL) || ((pointer[0] != '\0') && (pointer[0] != '/')))
+    {
+        return NULL;
+    }
+
+    while ((*pointer != '\0') && (node != NULL))
+    {
+        pointer++; /* skip '/' */
+        length = token_length(pointer);
+        /* longer keys than the local buffer take the compiled path */
+        if (length >= sizeof(key))
+        {
+            cJSON_Pointer *compiled = cJSON_PointerCompile(pointer - 1);
+            node = cJSON_PointerGet(compiled, node);
+            cJSON_PointerDelete(compiled);
+            return (cJSON*)node;
+        }
+
+        if (!unescape_token(pointer, length, key, &token.length))
+        {
+            return NULL;
+        }
+        token.key = key;
+        token.hash = 0;
+        token.index = token_index(pointer, length);
+
+        node = get_child(node, &token);
+        pointer += length;
+    }
+
+    return (cJSON*)node;
+}
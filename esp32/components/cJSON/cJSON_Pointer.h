@@ -0,0 +1,53 @@
+/*
+ * cJSON_Pointer.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef cJSON_Pointer__h
+#define cJSON_Pointer__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "cJSON.h"
+
+/* JSON Pointer (RFC 6901) accessors.
+ * A pointer such as "/network/dns/0" is compiled once into tokens with unescaped keys, their lengths and
+ * hashes, and array indexes already converted, then evaluated against any number of documents.
+ * Keys are matched case sensitively, as the RFC requires. "" refers to the whole document.
+ *
+ * Example:
+ *
+ *     static cJSON_Pointer *s_ip = NULL;
+ *
+ *     s_ip = cJSON_PointerCompile("/network/ip");
+ *     ...
+ *     ip = cJSON_GetStringValue(cJSON_PointerGet(s_ip, config));
+ */
+
+/* Most pointers cJSON_PointerGetMany resolves in one traversal, longer lists are split. */
+#ifndef CJSON_POINTER_BATCH_LIMIT
+#define CJSON_POINTER_BATCH_LIMIT 32
+#endif
+
+typedef struct cJSON_Pointer cJSON_Pointer;
+
+/* Returns NULL for malformed pointers (not starting with '/', bad '~' escapes) or on allocation failure. */
+CJSON_PUBLIC(cJSON_Pointer *) cJSON_PointerCompile(const char *pointer);
+CJSON_PUBLIC(void) cJSON_PointerDelete(cJSON_Pointer *pointer);
+/* Item the pointer refers to, NULL if it doesn't exist. */
+CJSON_PUBLIC(cJSON *) cJSON_PointerGet(const cJSON_Pointer * const pointer, const cJSON * const root);
+/* Resolve count pointers, walking the members of each object on the way only once.
+ * results[i] receives the item for pointers[i] or NULL. Returns the number of pointers resolved. */
+CJSON_PUBLIC(size_t) cJSON_PointerGetMany(const cJSON_Pointer * const *pointers, size_t count, const cJSON * const root, cJSON **results);
+/* Evaluate a pointer string directly, without compiling it. */
+CJSON_PUBLIC(cJSON *) cJSON_PointerGetItem(const cJSON * const root, const char *pointer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,709 @@
+/*
+ * cJSON_Sax.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <string.h>
+
+#include "cJSON_Sax.h"
+
+/* define our own boolean type */
+#ifdef true
+#undef true
+#endif
+#define true ((cJSON_bool)1)
+
+#ifdef false
+#undef false
+#endif
+#define false ((cJSON_bool)0)
+
+/* parser states */
+enum
+{
+    sax_value,              /* expecting any value */
+    sax_value_or_end_array, /* first element of an array, or ']' */
+    sax_key_or_end_object,  /* first key of an object, or '}' */
+    sax_key,                /* key after ',' in an object */
+    sax_colon,              /* ':' after a key */
+    sax_comma_or_end,       /* ',' or the end of the enclosing array/object */
+    sax_string,             /* inside a key or string value */
+    sax_escape,             /* after '\' inside a string */
+    sax_unicode,            /* inside the 4 hex digits of \uXXXX */
+    sax_surrogate_escape,   /* expecting '\' of the low surrogate */
+    sax_surrogate_u,        /* expecting 'u' of the low surrogate */
+    sax_number,
+    sax_literal,            /* inside true/false/null */
+    sax_done
+};
+
+#define sax_is_whitespace(c) ((unsigned char)(c) <= 32)
+
+/* hand the full token of a long string value to string_part and start over */
+static cJSON_bool token_flush_part(cJSON_SaxParser * const parser)
+{
+    if ((parser->state != sax_string) || parser->is_key
+        || ((parser->callbacks->string_part == NULL) && (parser->callbacks->string != NULL)))
+    {
+        parser->status = cJSON_SaxTokenTooLong;
+        return false;
+    }
+
+    /* without any string callback the value is only checked, not reported */
+    parser->token[parser->token_length] = '\0';
+    if ((parser->callbacks->string_part != NULL)
+        && !parser->callbacks->string_part(parser->user, parser->token, parser->token_length, true))
+    {
+        parser->status = cJSON_SaxAborted;
+        return false;
+    }
+    parser->token_length = 0;
+    parser->is_part = true;
+
+    return true;
+}
+
+static cJSON_bool token_append(cJSON_SaxParser * const parser, const char *bytes, size_t length)
+{
+    if (((parser->token_length + length) > CJSON_SAX_TOKEN_SIZE) && !token_flush_part(parser))
+    {
+        return false;
+    }
+
+    memcpy(parser->token + parser->token_length, bytes, length);
+    parser->token_length += length;
+
+    return true;
+}
+
+/* encode the pending codepoint as UTF-8 into the token */
+static cJSON_bool token_append_codepoint(cJSON_SaxParser * const parser, unsigned long codepoint)
+{
+    char utf8[4];
+    size_t length = 0;
+
+    if (codepoint < 0x80)
+    {
+        utf8[0] = (char)codepoint;
+        length = 1;
+    }
+    else if (codepoint < 0x800)
+    {
+        utf8[0] = (char)(0xC0 | (codepoint >> 6));
+        utf8[1] = (char)(0x80 | (codepoint & 0x3F));
+        length = 2;
+    }
+    else if (codepoint < 0x10000)
+    {
+        utf8[0] = (char)(0xE0 | (codepoint >> 12));
+        utf8[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        utf8[2] = (char)(0x80 | (codepoint & 0x3F));
+        length = 3;
+    }
+    else
+    {
+        utf8[0] = (char)(0xF0 | (codepoint >> 18));
+        utf8[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+        utf8[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        utf8[3] = (char)(0x80 | (codepoint & 0x3F));
+        length = 4;
+    }
+
+    return token_append(parser, utf8, length);
+}
+
+/* check the token against the JSON number grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)? */
+static cJSON_bool number_is_valid(const char *number, size_t length)
+{
+    size_t i = 0;
+
+    if ((i < length) && (number[i] == '-'))
+    {
+        i++;
+    }
+
+    if ((i < length) && (number[i] == '0'))
+    {
+        i++;
+    }
+    else if ((i < length) && (number[i] >= '1') && (number[i] <= '9'))
+    {
+        while ((i < length) && (number[i] >= '0') && (number[i] <= '9'))
+        {
+            i++;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    if ((i < length) && (number[i] == '.'))
+    {
+        i++;
+        if ((i >= length) || (number[i] < '0') || (number[i] > '9'))
+        {
+            return false;
+        }
+        while ((i < length) && (number[i] >= '0') && (number[i] <= '9'))
+        {
+            i++;
+        }
+    }
+
+    if ((i < length) && ((number[i] == 'e') || (number[i] == 'E')))
+    {
+        i++;
+        if ((i < length) && ((number[i] == '+') || (number[i] == '-')))
+        {
+            i++;
+        }
+        if ((i >= length) || (number[i] < '0') || (number[i] > '9'))
+        {
+            return false;
+        }
+        while ((i < length) && (number[i] >= '0') && (number[i] <= '9'))
+        {
+            i++;
+        }
+    }
+
+    return i == length;
+}
+
+/* a value has been completed, decide what may follow */
+static void value_done(cJSON_SaxParser * const parser)
+{
+    parser->state = (parser->depth == 0) ? sax_done : sax_comma_or_end;
+}
+
+static cJSON_bool emit_number(cJSON_SaxParser * const parser)
+{
+    double number = 0;
+
+    if (!number_is_valid(parser->token, parser->token_length) || !cJSON_ScanNumber(parser->token, parser->token_length, &number))
+    {
+        parser->status = cJSON_SaxError;
+        return false;
+    }
+    parser->token[parser->token_length] = '\0';
+
+    if ((parser->callbacks->number != NULL) && !parser->callbacks->number(parser->user, number, parser->token, parser->token_length))
+    {
+        parser->status = cJSON_SaxAborted;
+        return false;
+    }
+
+    value_done(parser);
+    return true;
+}
+
+static cJSON_bool emit_string(cJSON_SaxParser * const parser)
+{
+    cJSON_bool keep_going = true;
+
+    parser->token[parser->token_length] = '\0';
+    if (parser->is_key)
+    {
+        if (parser->callbacks->key != NULL)
+        {
+            keep_going = parser->callbacks->key(parser->user, parser->token, parser->token_length);
+        }
+        parser->state = sax_colon;
+    }
+    else if (parser->is_part)
+    {
+        /* the rest of a long string, possibly empty */
+        if (parser->callbacks->string_part != NULL)
+        {
+            keep_going = parser->callbacks->string_part(parser->user, parser->token, parser->token_length, false);
+        }
+        value_done(parser);
+    }
+    else
+    {
+        if (parser->callbacks->string != NULL)
+        {
+            keep_going = parser->callbacks->string(parser->user, parser->token, parser->token_length);
+        }
+        value_done(parser);
+    }
+
+    if (!keep_going)
+    {
+        parser->status = cJSON_SaxAborted;
+    }
+
+    return keep_going;
+}
+
+static cJSON_bool emit_literal(cJSON_SaxParser * const parser)
+{
+    cJSON_bool keep_going = true;
+
+    switch (parser->literal[0])
+    {
+        case 't':
+            if (parser->callbacks->boolean != NULL)
+            {
+                keep_going = parser->callbacks->boolean(parser->user, true);
+            }
+            break;
+
+        case 'f':
+            if (parser->callbacks->boolean != NULL)
+            {
+                keep_going = parser->callbacks->boolean(parser->user, false);
+            }
+            break;
+
+        default:
+            if (parser->callbacks->null != NULL)
+            {
+                keep_going = parser->callbacks->null(parser->user);
+            }
+            break;
+    }
+
+    if (!keep_going)
+    {
+        parser->status = cJSON_SaxAborted;
+        return false;
+    }
+
+    value_done(parser);
+    return true;
+}
+
+static cJSON_bool open_container(cJSON_SaxParser * const parser, unsigned char open)
+{
+    cJSON_bool keep_going = true;
+
+    if (parser->depth >= CJSON_SAX_NESTING_LIMIT)
+    {
+        parser->status = cJSON_SaxTooDeep;
+        return false;
+    }
+    parser->stack[parser->depth++] = open;
+
+    if (open == '{')
+    {
+        if (parser->callbacks->start_object != NULL)
+        {
+            keep_going = parser->callbacks->start_object(parser->user);
+        }
+        parser->state = sax_key_or_end_object;
+    }
+    else
+    {
+        if (parser->callbacks->start_array != NULL)
+        {
+            keep_going = parser->callbacks->start_array(parser->user);
+        }
+        parser->state = sax_value_or_end_array;
+    }
+
+    if (!keep_going)
+    {
+        parser->status = cJSON_SaxAborted;
+    }
+
+    return keep_going;
+}
+
+static cJSON_bool close_container(cJSON_SaxParser * const parser, unsigned char close)
+{
+    cJSON_bool keep_going = true;
+    unsigned char open = (close == '}') ? '{' : '[';
+
+    if ((parser->depth == 0) || (parser->stack[parser->depth - 1] != open))
+    {
+        parser->status = cJSON_SaxError;
+        return false;
+    }
+    parser->depth--;
+
+    if (close == '}')
+    {
+        if (parser->callbacks->end_object != NULL)
+        {
+            keep_going = parser->callbacks->end_object(parser->user);
+        }
+    }
+    else
+    {
+        if (parser->callbacks->end_array != NULL)
+        {
+            keep_going = parser->callbacks->end_array(parser->user);
+        }
+    }
+
+    if (!keep_going)
+    {
+        parser->status = cJSON_SaxAborted;
+        return false;
+    }
+
+    value_done(parser);
+    return true;
+}
+
+/* first character of a value */
+static cJSON_bool start_value(cJSON_SaxParser * const parser, char c)
+{
+    switch (c)
+    {
+        case '{':
+        case '[':
+            return open_container(parser, (unsigned char)c);
+
+        case '\"':
+            parser->is_key = false;
+            parser->is_part = false;
+            parser->token_length = 0;
+            parser->state = sax_string;
+            return true;
+
+        case 't':
+            parser->literal = "true";
+            break;
+
+        case 'f':
+            parser->literal = "false";
+            break;
+
+        case 'n':
+            parser->literal = "null";
+            break;
+
+        default:
+            if ((c == '-') || ((c >= '0') && (c <= '9')))
+            {
+                parser->token_length = 0;
+                parser->state = sax_number;
+                return token_append(parser, &c, 1);
+            }
+            parser->status = cJSON_SaxError;
+            return false;
+    }
+
+    parser->literal_index = 1;
+    parser->state = sax_literal;
+    return true;
+}
+
+static int hex_value(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return 10 + c - 'a';
+    }
+    if ((c >= 'A') && (c <= 'F'))
+    {
+        return 10 + c - 'A';
+    }
+
+    return -1;
+}
+
+/* the 4 hex digits of an \uXXXX escape have been read */
+static cJSON_bool unicode_done(cJSON_SaxParser * const parser)
+{
+    unsigned long code = parser->codepoint;
+
+    if (parser->high_surrogate != 0)
+    {
+        if ((code < 0xDC00) || (code > 0xDFFF))
+        {
+            parser->status = cJSON_SaxError;
+            return false;
+        }
+        code = 0x10000 + (((parser->high_surrogate & 0x3FF) << 10) | (code & 0x3FF));
+        parser->high_surrogate = 0;
+    }
+    else if ((code >= 0xD800) && (code <= 0xDBFF))
+    {
+        parser->high_surrogate = code;
+        parser->state = sax_surrogate_escape;
+        return true;
+    }
+    else if ((code >= 0xDC00) && (code <= 0xDFFF))
+    {
+        parser->status = cJSON_SaxError;
+        return false;
+    }
+
+    parser->state = sax_string;
+    return token_append_codepoint(parser, code);
+}
+
+/* process one byte. Returns false if the parser stopped (see status). */
+static cJSON_bool process_char(cJSON_SaxParser * const parser, char c)
+{
+    int digit = 0;
+
+    switch (parser->state)
+    {
+        case sax_value:
+            if (sax_is_whitespace(c))
+            {
+                return true;
+            }
+            return start_value(parser, c);
+
+        case sax_value_or_end_array:
+            if (sax_is_whitespace(c))
+            {
+                return true;
+            }
+            if (c == ']')
+            {
+                return close_container(parser, ']');
+            }
+            return start_value(parser, c);
+
+        case sax_key_or_end_object:
+        case sax_key:
+            if (sax_is_whitespace(c))
+            {
+                return true;
+            }
+            if ((c == '}') && (parser->state == sax_key_or_end_object))
+            {
+                return close_container(parser, '}');
+            }
+            if (c != '\"')
+            {
+                break;
+            }
+            parser->is_key = true;
+            parser->token_length = 0;
+            parser->state = sax_string;
+            return true;
+
+        case sax_colon:
+            if (sax_is_whitespace(c))
+            {
+                return true;
+            }
+            if (c != ':')
+            {
+                break;
+            }
+            parser->state = sax_value;
+            return true;
+
+        case sax_comma_or_end:
+            if (sax_is_whitespace(c))
+            {
+                return true;
+            }
+            if (c == ',')
+            {
+                parser->state = (parser->stack[parser->depth - 1] == '{') ? sax_key : sax_value;
+                return true;
+            }
+            if ((c == '}') || (c == ']'))
+            {
+                return close_container(parser, (unsigned char)c);
+            }
+            break;
+
+        case sax_string:
+            if (c == '\"')
+            {
+                return emit_string(parser);
+            }
+            if (c == '\\')
+            {
+                parser->state = sax_escape;
+                return true;
+            }
+            if ((unsigned char)c < 0x20)
+            {
+                break;
+            }
+            return token_append(parser, &c, 1);
+
+        case sax_escape:
+            parser->state = sax_string;
+            switch (c)
+            {
+                case 'b':
+                    return token_append(parser, "\b", 1);
+                case 'f':
+                    return token_append(parser, "\f", 1);
+                case 'n':
+                    return token_append(parser, "\n", 1);
+                case 'r':
+                    return token_append(parser, "\r", 1);
+                case 't':
+                    return token_append(parser, "\t", 1);
+                case '\"':
+                case '\\':
+                case '/':
+                    return token_append(parser, &c, 1);
+                case 'u':
+                    parser->codepoint = 0;
+                    parser->hex_count = 0;
+                    parser->state = sax_unicode;
+                    return true;
+                default:
+                    break;
+            }
+            break;
+
+        case sax_unicode:
+            digit = hex_value(c);
+            if (digit < 0)
+            {
+                break;
+            }
+            parser->codepoint = (parser->codepoint << 4) | (unsigned long)digit;
+            parser->hex_count++;
+            if (parser->hex_count < 4)
+            {
+                return true;
+            }
+            return unicode_done(parser);
+
+        case sax_surrogate_escape:
+            if (c != '\\')
+            {
+                break;
+            }
+            parser->state = sax_surrogate_u;
+            return true;
+
+        case sax_surrogate_u:
+            if (c != 'u')
+            {
+                break;
+            }
+            parser->codepoint = 0;
+            parser->hex_count = 0;
+            parser->state = sax_unicode;
+            return true;
+
+        case sax_number:
+            if (((c >= '0') && (c <= '9')) || (c == '-') || (c == '+') || (c == '.') || (c == 'e') || (c == 'E'))
+            {
+                return token_append(parser, &c, 1);
+            }
+            /* the number ended, the current character belongs to what follows */
+            if (!emit_number(parser))
+            {
+                return false;
+            }
+            return process_char(parser, c);
+
+        case sax_literal:
+            if (c != parser->literal[parser->literal_index])
+            {
+                break;
+            }
+            parser->literal_index++;
+            if (parser->literal[parser->literal_index] != '\0')
+            {
+                return true;
+            }
+            return emit_literal(parser);
+
+        case sax_done:
+            if (sax_is_whitespace(c))
+            {
+                return true;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    parser->status = cJSON_SaxError;
+    return false;
+}
+
+CJSON_PUBLIC(void) cJSON_SaxInit(cJSON_SaxParser * const parser, const cJSON_SaxCallbacks * const callbacks, void *user)
+{
+    static const cJSON_SaxCallbacks no_callbacks = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+
+    if (parser == NULL)
+    {
+        return;
+    }
+
+    memset(parser, '\0', sizeof(cJSON_SaxParser));
+    parser->callbacks = (callbacks != NULL) ? callbacks : &no_callbacks;
+    parser->user = user;
+    parser->state = sax_value;
+    parser->status = cJSON_SaxOk;
+}
+
+CJSON_PUBLIC(cJSON_SaxStatus) cJSON_SaxFeed(cJSON_SaxParser * const parser, const char *chunk, size_t length)
+{
+    size_t i = 0;
+
+    if (parser == NULL)
+    {
+        return cJSON_SaxError;
+    }
+
+    if (parser->status < 0)
+    {
+        return (cJSON_SaxStatus)parser->status;
+    }
+
+    if ((chunk == NULL) && (length > 0))
+    {
+        parser->status = cJSON_SaxError;
+        return cJSON_SaxError;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        if (!process_char(parser, chunk[i]))
+        {
+            return (cJSON_SaxStatus)parser->status;
+        }
+        parser->offset++;
+    }
+
+    return (parser->state == sax_done) ? cJSON_SaxDone : cJSON_SaxOk;
+}
+
+CJSON_PUBLIC(cJSON_SaxStatus) cJSON_SaxFinish(cJSON_SaxParser * const parser)
+{
+    if (parser == NULL)
+    {
+        return cJSON_SaxError;
+    }
+
+    if (parser->status < 0)
+    {
+        return (cJSON_SaxStatus)parser->status;
+    }
+
+    /* a top level number is only terminated by the end of input */
+    if ((parser->state == sax_number) && (parser->depth == 0))
+    {
+        if (!emit_number(parser))
+        {
+            return (cJSON_SaxStatus)parser->status;
+        }
+    }
+
+    if (parser->state != sax_done)
+    {
+        parser->status = cJSON_SaxError;
+        return cJSON_SaxError;
+    }
+
+    parser->status = cJSON_SaxDone;
+    return cJSON_SaxDone;
+}
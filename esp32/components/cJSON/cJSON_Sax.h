@@ -0,0 +1,96 @@
+/*
+ * cJSON_Sax.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef cJSON_Sax__h
+#define cJSON_Sax__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "cJSON.h"
+
+/* Event driven, resumable JSON tokenizer.
+ * Input can be fed in arbitrary chunks (e.g. straight from httpd_req_recv), no DOM is built and the memory
+ * used is bounded by the parser structure: a nesting stack and one token buffer for the current key/string/number. */
+
+/* Limits how deeply nested arrays/objects can be. */
+#ifndef CJSON_SAX_NESTING_LIMIT
+#define CJSON_SAX_NESTING_LIMIT 32
+#endif
+
+/* Longest key, string value or number (after unescaping, without '\0') that can be reported in one piece.
+ * Longer string values are only accepted when the string_part callback is set, or when neither string
+ * nor string_part is (the value is then checked but not reported). */
+#ifndef CJSON_SAX_TOKEN_SIZE
+#define CJSON_SAX_TOKEN_SIZE 256
+#endif
+
+typedef enum
+{
+    cJSON_SaxOk = 0,            /* chunk consumed, document not complete yet */
+    cJSON_SaxDone = 1,          /* a complete document has been parsed */
+    cJSON_SaxError = -1,        /* malformed input */
+    cJSON_SaxTooDeep = -2,      /* CJSON_SAX_NESTING_LIMIT exceeded */
+    cJSON_SaxTokenTooLong = -3, /* CJSON_SAX_TOKEN_SIZE exceeded by a key, a number or a string nobody takes in pieces */
+    cJSON_SaxAborted = -4       /* a callback returned false */
+} cJSON_SaxStatus;
+
+/* All callbacks are optional. Returning false stops the parser with cJSON_SaxAborted.
+ * Strings are unescaped UTF-8 and null terminated, they are only valid during the callback. */
+typedef struct cJSON_SaxCallbacks
+{
+    cJSON_bool (*start_object)(void *user);
+    cJSON_bool (*end_object)(void *user);
+    cJSON_bool (*start_array)(void *user);
+    cJSON_bool (*end_array)(void *user);
+    cJSON_bool (*key)(void *user, const char *key, size_t length);
+    cJSON_bool (*string)(void *user, const char *value, size_t length);
+    /* text is the number exactly as it appeared in the input */
+    cJSON_bool (*number)(void *user, double value, const char *text, size_t length);
+    cJSON_bool (*boolean)(void *user, cJSON_bool value);
+    cJSON_bool (*null)(void *user);
+    /* String values longer than CJSON_SAX_TOKEN_SIZE, e.g. certificates or base64 blobs, are delivered here in
+     * pieces of up to CJSON_SAX_TOKEN_SIZE bytes instead of through string. more is true for every piece but
+     * the last one. Pieces are cut at byte boundaries, a UTF-8 sequence may span two of them. */
+    cJSON_bool (*string_part)(void *user, const char *value, size_t length, cJSON_bool more);
+} cJSON_SaxCallbacks;
+
+/* Parser state, treat as opaque. Can live on the stack, nothing inside is heap allocated. */
+typedef struct cJSON_SaxParser
+{
+    const cJSON_SaxCallbacks *callbacks;
+    void *user;
+    int state;
+    int status;
+    size_t depth;
+    size_t offset; /* number of bytes consumed so far, points to the error when status < 0 */
+    unsigned char stack[CJSON_SAX_NESTING_LIMIT];
+    char token[CJSON_SAX_TOKEN_SIZE + 1];
+    size_t token_length;
+    const char *literal;
+    size_t literal_index;
+    unsigned long codepoint;
+    unsigned long high_surrogate;
+    unsigned char hex_count;
+    cJSON_bool is_key;
+    cJSON_bool is_part; /* the current string value already went out in pieces */
+} cJSON_SaxParser;
+
+/* Prepare a parser for a new document. */
+CJSON_PUBLIC(void) cJSON_SaxInit(cJSON_SaxParser * const parser, const cJSON_SaxCallbacks * const callbacks, void *user);
+/* Feed the next chunk of input. Returns cJSON_SaxOk while more input is expected, cJSON_SaxDone once
+ * the document is complete (trailing whitespace is accepted) or a negative cJSON_SaxStatus on failure. */
+CJSON_PUBLIC(cJSON_SaxStatus) cJSON_SaxFeed(cJSON_SaxParser * const parser, const char *chunk, size_t length);
+/* Signal the end of input. Returns cJSON_SaxDone if a complete document was parsed. */
+CJSON_PUBLIC(cJSON_SaxStatus) cJSON_SaxFinish(cJSON_SaxParser * const parser);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,572 @@
+/*
+ * cJSON_Writer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <string.h>
+#include <stdio.h>
+
+#include "cJSON_Writer.h"
+#include "cJSON_Cbor.h"
+
+/* define our own boolean type */
+#ifdef true
+#undef true
+#endif
+#define true ((cJSON_bool)1)
+
+#ifdef false
+#undef false
+#endif
+#define false ((cJSON_bool)0)
+
+/* flags kept per nesting level */
+#define writer_is_object    0x01
+#define writer_has_element  0x02
+
+/* CBOR initial bytes, containers are written with indefinite length */
+#define writer_cbor_text    0x60
+#define writer_cbor_array   ((char)0x9F)
+#define writer_cbor_map     ((char)0xBF)
+#define writer_cbor_false   ((char)0xF4)
+#define writer_cbor_true    ((char)0xF5)
+#define writer_cbor_null    ((char)0xF6)
+#define writer_cbor_break   ((char)0xFF)
+
+/* hand the buffered output to the flush callback */
+static cJSON_bool writer_flush(cJSON_Writer * const writer)
+{
+    if (writer->length == 0)
+    {
+        return true;
+    }
+
+    if ((writer->flush == NULL) || !writer->flush(writer->user, writer->buffer, writer->length))
+    {
+        writer->failed = true;
+        return false;
+    }
+    writer->length = 0;
+
+    return true;
+}
+
+static cJSON_bool writer_put(cJSON_Writer * const writer, const char *data, size_t length)
+{
+    size_t copy = 0;
+
+    while (length > 0)
+    {
+        if ((writer->length == writer->size) && !writer_flush(writer))
+        {
+            return false;
+        }
+
+        copy = writer->size - writer->length;
+        if (copy > length)
+        {
+            copy = length;
+        }
+        memcpy(writer->buffer + writer->length, data, copy);
+        writer->length += copy;
+        data += copy;
+        length -= copy;
+    }
+
+    return true;
+}
+
+/* emit the separator a new value needs and check that a value is allowed here */
+static cJSON_bool writer_begin_value(cJSON_Writer * const writer)
+{
+    unsigned char *level = NULL;
+
+    if (writer->failed)
+    {
+        return false;
+    }
+
+    if (writer->depth == 0)
+    {
+        /* a document has exactly one root value */
+        if (writer->has_root)
+        {
+            writer->failed = true;
+            return false;
+        }
+        writer->has_root = true;
+        return true;
+    }
+
+    level = &writer->stack[writer->depth - 1];
+    if (*level & writer_is_object)
+    {
+        /* object members need a key first */
+        if (!writer->after_key)
+        {
+            writer->failed = true;
+            return false;
+        }
+        writer->after_key = false;
+        return true;
+    }
+
+    if ((*level & writer_has_element) && !writer->cbor)
+    {
+        return writer_put(writer, ",", 1);
+    }
+
+    return true;
+}
+
+static void writer_end_value(cJSON_Writer * const writer)
+{
+    if (writer->depth > 0)
+    {
+        writer->stack[writer->depth - 1] |= writer_has_element;
+    }
+}
+
+static cJSON_bool writer_put_string(cJSON_Writer * const writer, const char *string)
+{
+    const unsigned char *run = (const unsigned char*)string;
+    const unsigned char *input = run;
+    char escape[7];
+    size_t escape_length = 0;
+
+    if (!writer_put(writer, "\"", 1))
+    {
+        return false;
+    }
+
+    for (; *input != '\0'; input++)
+    {
+        if ((*input > 31) && (*input != '\"') && (*input != '\\'))
+        {
+            continue;
+        }
+
+        /* copy the run of characters that need no escaping */
+        if (!writer_put(writer, (const char*)run, (size_t)(input - run)))
+        {
+            return false;
+        }
+        run = input + 1;
+
+        escape[0] = '\\';
+        escape_length = 2;
+        switch (*input)
+        {
+            case '\\':
+                escape[1] = '\\';
+                break;
+            case '\"':
+                escape[1] = '\"';
+                break;
+            case '\b':
+                escape[1] = 'b';
+                break;
+            case '\f':
+                escape[1] = 'f';
+                break;
+            case '\n':
+                escape[1] = 'n';
+                break;
+            case '\r':
+                escape[1] = 'r';
+                break;
+            case '\t':
+                escape[1] = 't';
+                break;
+            default:
+                sprintf(escape + 1, "u%04x", *input);
+                escape_length = 6;
+                break;
+        }
+        if (!writer_put(writer, escape, escape_length))
+        {
+            return false;
+        }
+    }
+
+    if (!writer_put(writer, (const char*)run, (size_t)(input - run)))
+    {
+        return false;
+    }
+
+    return writer_put(writer, "\"", 1);
+}
+
+/* CBOR text string: head with the shortest length encoding, then the UTF-8 bytes as they are */
+static cJSON_bool writer_put_text(cJSON_Writer * const writer, const char *text)
+{
+    unsigned char head[5];
+    size_t length = strlen(text);
+    size_t head_length = 0;
+    size_t i = 0;
+
+    if (length > 0xFFFFFFFFUL)
+    {
+        writer->failed = true;
+        return false;
+    }
+
+    if (length < 24)
+    {
+        head[0] = (unsigned char)(writer_cbor_text | length);
+        head_length = 1;
+    }
+    else
+    {
+        head_length = (length <= 0xFF) ? 2 : ((length <= 0xFFFF) ? 3 : 5);
+        head[0] = (unsigned char)(writer_cbor_text | ((head_length == 2) ? 24 : ((head_length == 3) ? 25 : 26)));
+        for (i = 1; i < head_length; i++)
+        {
+            head[i] = (unsigned char)((length >> ((head_length - 1 - i) * 8)) & 0xFF);
+        }
+    }
+
+    return writer_put(writer, (const char*)head, head_length) && writer_put(writer, text, length);
+}
+
+static cJSON_bool writer_open(cJSON_Writer * const writer, unsigned char flags, char open)
+{
+    if (!writer_begin_value(writer))
+    {
+        return false;
+    }
+
+    if (writer->depth >= CJSON_WRITER_NESTING_LIMIT)
+    {
+        writer->failed = true;
+        return false;
+    }
+
+    if (!writer_put(writer, &open, 1))
+    {
+        return false;
+    }
+    writer->stack[writer->depth++] = flags;
+
+    return true;
+}
+
+static cJSON_bool writer_close(cJSON_Writer * const writer, unsigned char flags, char close)
+{
+    if (writer->failed)
+    {
+        return false;
+    }
+
+    if ((writer->depth == 0) || ((writer->stack[writer->depth - 1] & writer_is_object) != flags) || writer->after_key)
+    {
+        writer->failed = true;
+        return false;
+    }
+
+    if (!writer_put(writer, &close, 1))
+    {
+        return false;
+    }
+    writer->depth--;
+    writer_end_value(writer);
+
+    return true;
+}
+
+/* write a complete scalar value */
+static cJSON_bool writer_value(cJSON_Writer * const writer, const char *text, size_t length)
+{
+    if (!writer_begin_value(writer) || !writer_put(writer, text, length))
+    {
+        return false;
+    }
+    writer_end_value(writer);
+
+    return true;
+}
+
+CJSON_PUBLIC(void) cJSON_WriterInit(cJSON_Writer * const writer, char *buffer, size_t size, cJSON_WriterFlush flush, void *user)
+{
+    if (writer == NULL)
+    {
+        return;
+    }
+
+    memset(writer, '\0', sizeof(cJSON_Writer));
+    writer->buffer = buffer;
+    writer->size = size;
+    writer->flush = flush;
+    writer->user = user;
+    writer->failed = (buffer == NULL) || (size == 0);
+}
+
+CJSON_PUBLIC(void) cJSON_WriterInitCbor(cJSON_Writer * const writer, char *buffer, size_t size, cJSON_WriterFlush flush, void *user)
+{
+    if (writer == NULL)
+    {
+        return;
+    }
+
+    cJSON_WriterInit(writer, buffer, size, flush, user);
+    writer->cbor = true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterBeginObject(cJSON_Writer * const writer)
+{
+    return (writer != NULL) && writer_open(writer, writer_is_object, writer->cbor ? writer_cbor_map : '{');
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterEndObject(cJSON_Writer * const writer)
+{
+    return (writer != NULL) && writer_close(writer, writer_is_object, writer->cbor ? writer_cbor_break : '}');
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterBeginArray(cJSON_Writer * const writer)
+{
+    return (writer != NULL) && writer_open(writer, 0, writer->cbor ? writer_cbor_array : '[');
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterEndArray(cJSON_Writer * const writer)
+{
+    return (writer != NULL) && writer_close(writer, 0, writer->cbor ? writer_cbor_break : ']');
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterKey(cJSON_Writer * const writer, const char *key)
+{
+    unsigned char *level = NULL;
+
+    if ((writer == NULL) || writer->failed)
+    {
+        return false;
+    }
+
+    if ((key == NULL) || (writer->depth == 0) || writer->after_key)
+    {
+        writer->failed = true;
+        return false;
+    }
+
+    level = &writer->stack[writer->depth - 1];
+    if (!(*level & writer_is_object))
+    {
+        writer->failed = true;
+        return false;
+    }
+
+    if (writer->cbor)
+    {
+        if (!writer_put_text(writer, key))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if ((*level & writer_has_element) && !writer_put(writer, ",", 1))
+        {
+            return false;
+        }
+
+        if (!writer_put_string(writer, key) || !writer_put(writer, ":", 1))
+        {
+            return false;
+        }
+    }
+    writer->after_key = true;
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterString(cJSON_Writer * const writer, const char *value)
+{
+    if (writer == NULL)
+    {
+        return false;
+    }
+
+    if (value == NULL)
+    {
+        return cJSON_WriterNull(writer);
+    }
+
+    if (!writer_begin_value(writer) || !(writer->cbor ? writer_put_text(writer, value) : writer_put_string(writer, value)))
+    {
+        return false;
+    }
+    writer_end_value(writer);
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterNumber(cJSON_Writer * const writer, double value)
+{
+    char number[CJSON_NUMBER_BUFFER_SIZE];
+    cJSON item;
+    int length = 0;
+
+    if (writer == NULL)
+    {
+        return false;
+    }
+
+    if (writer->cbor)
+    {
+        /* same encoding rules as cJSON_CborEncode, a number takes at most 9 bytes */
+        memset(&item, '\0', sizeof(item));
+        item.type = cJSON_Number;
+        item.valuedouble = value;
+        length = (int)cJSON_CborEncode(&item, (unsigned char*)number, sizeof(number));
+    }
+    else
+    {
+        /* same rendering rules as cJSON_Print */
+        length = cJSON_FormatNumber(value, number);
+    }
+    if (length <= 0)
+    {
+        writer->failed = true;
+        return false;
+    }
+
+    return writer_value(writer, number, (size_t)length);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterBool(cJSON_Writer * const writer, cJSON_bool value)
+{
+    const char simple = value ? writer_cbor_true : writer_cbor_false;
+
+    if (writer == NULL)
+    {
+        return false;
+    }
+
+    if (writer->cbor)
+    {
+        return writer_value(writer, &simple, 1);
+    }
+
+    return value ? writer_value(writer, "true", 4) : writer_value(writer, "false", 5);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterNull(cJSON_Writer * const writer)
+{
+    const char simple = writer_cbor_null;
+
+    if (writer == NULL)
+    {
+        return false;
+    }
+
+    return writer->cbor ? writer_value(writer, &simple, 1) : writer_value(writer, "null", 4);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterRaw(cJSON_Writer * const writer, const char *raw)
+{
+    if (writer == NULL)
+    {
+        return false;
+    }
+
+    /* JSON text has no CBOR form */
+    if ((raw == NULL) || writer->cbor)
+    {
+        writer->failed = true;
+        return false;
+    }
+
+    return writer_value(writer, raw, strlen(raw));
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterItem(cJSON_Writer * const writer, const cJSON * const item)
+{
+    const cJSON *child = NULL;
+
+    if (writer == NULL)
+    {
+        return false;
+    }
+
+    if (item == NULL)
+    {
+        writer->failed = true;
+        return false;
+    }
+
+    switch (item->type & 0xFF)
+    {
+        case cJSON_NULL:
+            return cJSON_WriterNull(writer);
+
+        case cJSON_False:
+            return cJSON_WriterBool(writer, false);
+
+        case cJSON_True:
+            return cJSON_WriterBool(writer, true);
+
+        case cJSON_Number:
+            return cJSON_WriterNumber(writer, item->valuedouble);
+
+        case cJSON_String:
+            /* cJSON_Print renders a missing valuestring as "" */
+            return cJSON_WriterString(writer, (item->valuestring != NULL) ? item->valuestring : "");
+
+        case cJSON_Raw:
+            return cJSON_WriterRaw(writer, item->valuestring);
+
+        case cJSON_Array:
+            if (!cJSON_WriterBeginArray(writer))
+            {
+                return false;
+            }
+            for (child = item->child; child != NULL; child = child->next)
+            {
+                if (!cJSON_WriterItem(writer, child))
+                {
+                    return false;
+                }
+            }
+            return cJSON_WriterEndArray(writer);
+
+        case cJSON_Object:
+            if (!cJSON_WriterBeginObject(writer))
+            {
+                return false;
+            }
+            for (child = item->child; child != NULL; child = child->next)
+            {
+                if (!cJSON_WriterKey(writer, (child->string != NULL) ? child->string : "") || !cJSON_WriterItem(writer, child))
+                {
+                    return false;
+                }
+            }
+            return cJSON_WriterEndObject(writer);
+
+        default:
+            writer->failed = true;
+            return false;
+    }
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterFinish(cJSON_Writer * const writer)
+{
+    if ((writer == NULL) || writer->failed)
+    {
+        return false;
+    }
+
+    if ((writer->depth != 0) || writer->after_key || !writer->has_root)
+    {
+        writer->failed = true;
+        return false;
+    }
+
+    /* without a flush callback the output stays in the buffer */
+    if (writer->flush == NULL)
+    {
+        return true;
+    }
+
+    return writer_flush(writer);
+}
@@ -0,0 +1,75 @@
+/*
+ * cJSON_Writer.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef cJSON_Writer__h
+#define cJSON_Writer__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "cJSON.h"
+
+/* Streaming JSON writer.
+ * Output is formatted (unformatted style) into a small caller supplied buffer which is handed to the flush
+ * callback whenever it fills up, so documents of any size are produced in constant memory and the first
+ * bytes can go out before the whole document exists. Commas and separators are inserted automatically. */
+
+/* Limits how deeply nested arrays/objects can be. */
+#ifndef CJSON_WRITER_NESTING_LIMIT
+#define CJSON_WRITER_NESTING_LIMIT 32
+#endif
+
+/* Send length bytes of output. Return false to abort writing. */
+typedef cJSON_bool (*cJSON_WriterFlush)(void *user, const char *data, size_t length);
+
+/* Writer state, treat as opaque. */
+typedef struct cJSON_Writer
+{
+    char *buffer;
+    size_t size;
+    size_t length;
+    cJSON_WriterFlush flush;
+    void *user;
+    size_t depth;
+    unsigned char stack[CJSON_WRITER_NESTING_LIMIT];
+    cJSON_bool after_key;
+    cJSON_bool has_root;
+    cJSON_bool failed;
+    cJSON_bool cbor;
+} cJSON_Writer;
+
+/* Prepare a writer. Without a flush callback the output must fit into the buffer. */
+CJSON_PUBLIC(void) cJSON_WriterInit(cJSON_Writer * const writer, char *buffer, size_t size, cJSON_WriterFlush flush, void *user);
+/* Same, but the output is CBOR (RFC 8949): scalars as cJSON_CborEncode encodes them, arrays and maps with
+ * indefinite length so nothing has to be counted in advance. cJSON_WriterRaw fails on such a writer. */
+CJSON_PUBLIC(void) cJSON_WriterInitCbor(cJSON_Writer * const writer, char *buffer, size_t size, cJSON_WriterFlush flush, void *user);
+
+/* Each call returns false once the writer has failed (misuse, nesting limit, flush failure).
+ * The failure is sticky, so checking the result of cJSON_WriterFinish only is enough. */
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterBeginObject(cJSON_Writer * const writer);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterEndObject(cJSON_Writer * const writer);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterBeginArray(cJSON_Writer * const writer);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterEndArray(cJSON_Writer * const writer);
+/* Key of the next member, only valid inside an object. */
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterKey(cJSON_Writer * const writer, const char *key);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterString(cJSON_Writer * const writer, const char *value);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterNumber(cJSON_Writer * const writer, double value);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterBool(cJSON_Writer * const writer, cJSON_bool value);
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterNull(cJSON_Writer * const writer);
+/* Insert already formatted JSON text as a value. */
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterRaw(cJSON_Writer * const writer, const char *raw);
+/* Write a cJSON item and all its children as a value. */
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterItem(cJSON_Writer * const writer, const cJSON * const item);
+/* Flush what is left in the buffer. Returns true if a complete document was written. */
+CJSON_PUBLIC(cJSON_bool) cJSON_WriterFinish(cJSON_Writer * const writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
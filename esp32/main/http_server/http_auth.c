@@ -8,6 +8,7 @@
 #include "esp_log.h"
 
 #include "base64.h"
+#include "mod_mem.h"
 #include "http_auth.h"
 
 #define HTTP_AUTH_USER_LEN    32
@@ -35,7 +36,7 @@ static bool priv_auth_validate(const char *token, size_t token_len)
         goto exit;
     }
 
-    buf = (char *)calloc(1, token_len * 2);
+    buf = (char *)mod_mem_calloc(1, token_len * 2, MOD_MEM_INTERNAL);
     if (buf == NULL) {
         valid = false;
         goto exit;
@@ -69,7 +70,7 @@ static bool priv_auth_validate(const char *token, size_t token_len)
 
 exit:
     if (buf != NULL) {
-        free(buf);
+        mod_mem_free(buf);
         buf = NULL;
     }
 
@@ -96,7 +97,7 @@ bool http_auth_validate(httpd_req_t *req)
         goto exit;
     }
 
-    buf = (char *)calloc(1, buf_len);
+    buf = (char *)mod_mem_calloc(1, buf_len, MOD_MEM_INTERNAL);
     if (buf == NULL) {
         ESP_LOGE(TAG, "malloc failed");
         valid = false;
@@ -121,7 +122,7 @@ bool http_auth_validate(httpd_req_t *req)
 
 exit:
     if (buf != NULL) {
-        free(buf);
+        mod_mem_free(buf);
         buf = NULL;
     }
 
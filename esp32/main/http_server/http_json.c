@@ -0,0 +1,624 @@
+/*
+ * http_json.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <string.h>
+#include <strings.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "cJSON_Cbor.h"
+
+#include "mod_mem.h"
+#include "http_json.h"
+
+#define HTTP_JSON_RECV_CHUNK    512
+#define HTTP_JSON_RECV_RETRY    3    /* receive timeouts in a row before giving up */
+#define HTTP_JSON_CBOR_MAX      4096 /* CBOR bodies are decoded as a whole */
+#define HTTP_JSON_TYPE_CBOR     "application/cbor"
+#define HTTP_JSON_TYPE_JSON     "application/json"
+#define HTTP_JSON_HDR_LEN       128
+
+#define HTTP_JSON_POOL_NUM      2    /* responses formatted at the same time without allocating */
+#define HTTP_JSON_POOL_MIN      256
+#define HTTP_JSON_POOL_MAX      4096 /* larger documents are always streamed */
+#define HTTP_JSON_ROUTE_NUM     8    /* size estimates, direct mapped by uri hash */
+#define HTTP_JSON_STREAM_CHUNK  512
+
+typedef struct {
+    char *buf;
+    size_t size;
+    bool in_use;
+} http_json_pool_t;
+
+typedef struct {
+    uint32_t hash;     /* 0: unused */
+    size_t estimate;   /* running average of the response size */
+} http_json_route_t;
+
+typedef struct {
+    httpd_req_t *req;
+    size_t total;
+} http_json_stream_t;
+
+static const char *TAG = "httpd_json";
+
+static http_json_pool_t s_pool[HTTP_JSON_POOL_NUM];
+static http_json_route_t s_route[HTTP_JSON_ROUTE_NUM];
+static http_json_stats_t s_stats;
+static portMUX_TYPE s_pool_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static cJSON_bool priv_writer_flush(void *user, const char *data, size_t length)
+{
+    return httpd_resp_send_chunk((httpd_req_t *)user, data, length) == ESP_OK;
+}
+
+static cJSON_bool priv_stream_flush(void *user, const char *data, size_t length)
+{
+    http_json_stream_t *stream = (http_json_stream_t *)user;
+
+    stream->total += length;
+    return httpd_resp_send_chunk(stream->req, data, length) == ESP_OK;
+}
+
+/* route key is the uri without query string */
+static uint32_t priv_route_hash(const char *uri)
+{
+    uint32_t hash = 2166136261UL;
+
+    while ((*uri != '\0') && (*uri != '?')) {
+        hash = (hash ^ (uint8_t)*uri++) * 16777619UL;
+    }
+
+    return (hash != 0) ? hash : 1;
+}
+
+static size_t priv_route_estimate(uint32_t hash)
+{
+    http_json_route_t *route = &s_route[hash % HTTP_JSON_ROUTE_NUM];
+
+    return (route->hash == hash) ? route->estimate : HTTP_JSON_POOL_MIN;
+}
+
+/* EWMA with weight 1/4, a new route or a collision starts from the measured size */
+static void priv_route_update(uint32_t hash, size_t len)
+{
+    http_json_route_t *route = &s_route[hash % HTTP_JSON_ROUTE_NUM];
+
+    if (route->hash != hash) {
+        route->hash = hash;
+        route->estimate = len;
+    } else if (len > route->estimate) {
+        route->estimate += (len - route->estimate + 3) / 4;
+    } else {
+        route->estimate -= (route->estimate - len) / 4;
+    }
+}
+
+/**
+ * 取一个空闲的缓冲区, 容量不够时才重新分配, 稳定后不再申请内存.
+ * 返回 NULL 表示没有空闲的缓冲区或内存不足.
+ */
+static http_json_pool_t *priv_pool_acquire(size_t size)
+{
+    http_json_pool_t *pool = NULL;
+    char *buf = NULL;
+    int i = 0;
+
+    taskENTER_CRITICAL(&s_pool_lock);
+    for (i = 0; i < HTTP_JSON_POOL_NUM; i++) {
+        if (s_pool[i].in_use) {
+            continue;
+        }
+        /* prefer a buffer that is already large enough */
+        if ((pool == NULL) || ((pool->size < size) && (s_pool[i].size > pool->size))) {
+            pool = &s_pool[i];
+        }
+    }
+    if (pool != NULL) {
+        pool->in_use = true;
+    }
+    taskEXIT_CRITICAL(&s_pool_lock);
+
+    if ((pool == NULL) || (pool->size >= size)) {
+        return pool;
+    }
+
+    buf = (char *)mod_mem_malloc(size, MOD_MEM_DEFAULT);
+    if (buf == NULL) {
+        ESP_LOGW(TAG, "grow pool buffer to %d failed", size);
+        if (pool->buf != NULL) {
+            return pool;
+        }
+        pool->in_use = false;
+        return NULL;
+    }
+    mod_mem_free(pool->buf);
+    pool->buf = buf;
+    pool->size = size;
+
+    taskENTER_CRITICAL(&s_pool_lock);
+    s_stats.grows++;
+    taskEXIT_CRITICAL(&s_pool_lock);
+
+    return pool;
+}
+
+static void priv_pool_release(http_json_pool_t *pool)
+{
+    taskENTER_CRITICAL(&s_pool_lock);
+    pool->in_use = false;
+    taskEXIT_CRITICAL(&s_pool_lock);
+}
+
+/* qvalue in thousandths: "1", "1.000", "0", "0.5", anything malformed counts as a refusal */
+static int priv_parse_q(const char *s)
+{
+    int q = 0;
+
+    if (*s == '1') {
+        return 1000;
+    }
+    if ((s[0] != '0') || (s[1] != '.')) {
+        return 0;
+    }
+    s += 2;
+    for (int scale = 100; (scale > 0) && (*s >= '0') && (*s <= '9'); scale /= 10) {
+        q += (*s++ - '0') * scale;
+    }
+
+    return q;
+}
+
+/**
+ * 请求头里媒体类型的 q 值 (千分之一), 没有列出返回 -1.
+ * 按逗号分开, 去掉参数后整个类型不区分大小写比较, q=0 表示拒绝. 超长的请求头不匹配.
+ */
+static int priv_hdr_type_q(httpd_req_t *req, const char *field, const char *type)
+{
+    char value[HTTP_JSON_HDR_LEN];
+    const char *p = value;
+    size_t type_len = strlen(type);
+    size_t len = 0;
+    bool match = false;
+    int best = -1;
+    int q = 0;
+
+    len = httpd_req_get_hdr_value_len(req, field);
+    if ((len == 0) || (len >= sizeof(value))) {
+        return -1;
+    }
+
+    if (httpd_req_get_hdr_value_str(req, field, value, sizeof(value)) != ESP_OK) {
+        return -1;
+    }
+
+    while (*p != '\0') {
+        p += strspn(p, " \t,");
+        len = strcspn(p, " \t;,");
+        match = (len == type_len) && (strncasecmp(p, type, len) == 0);
+        p += len;
+
+        /* 参数直到下一个逗号 */
+        q = 1000;
+        while ((*p != '\0') && (*p != ',')) {
+            p += strspn(p, " \t;");
+            if (strncasecmp(p, "q=", 2) == 0) {
+                q = priv_parse_q(p + 2);
+            }
+            p += strcspn(p, ";,");
+        }
+
+        if (match && (q > best)) {
+            best = q;
+        }
+    }
+
+    return best;
+}
+
+/* whether a request header lists the media type and does not refuse it */
+static bool priv_hdr_has_type(httpd_req_t *req, const char *field, const char *type)
+{
+    return priv_hdr_type_q(req, field, type) > 0;
+}
+
+/* CBOR only when the client prefers it at least as much as JSON */
+static bool priv_accept_cbor(httpd_req_t *req)
+{
+    int cbor = priv_hdr_type_q(req, "Accept", HTTP_JSON_TYPE_CBOR);
+
+    return (cbor > 0) && (cbor >= priv_hdr_type_q(req, "Accept", HTTP_JSON_TYPE_JSON));
+}
+
+/**
+ * 把解码后的 CBOR 文档按 JSON 的 SAX 事件重放, 处理函数不需要关心请求体的编码.
+ * 长度限制和 JSON 请求体一样, 超长的字符串分段交给 string_part.
+ */
+static bool priv_sax_replay(cJSON *item, const cJSON_SaxCallbacks *callbacks, void *user)
+{
+    char number[CJSON_NUMBER_BUFFER_SIZE];
+    cJSON *child = NULL;
+    char *piece = NULL;
+    size_t piece_len = 0;
+    size_t left = 0;
+    char saved = '\0';
+    bool keep_going = true;
+    int len = 0;
+
+    if (item->string != NULL) {
+        len = strlen(item->string);
+        if (len > CJSON_SAX_TOKEN_SIZE) {
+            return false;
+        }
+        if ((callbacks->key != NULL) && !callbacks->key(user, item->string, len)) {
+            return false;
+        }
+    }
+
+    switch (item->type & 0xFF) {
+    case cJSON_False:
+    case cJSON_True:
+        return (callbacks->boolean == NULL) || callbacks->boolean(user, cJSON_IsTrue(item));
+    case cJSON_NULL:
+        return (callbacks->null == NULL) || callbacks->null(user);
+    case cJSON_Number:
+        len = cJSON_FormatNumber(item->valuedouble, number);
+        return (callbacks->number == NULL) || callbacks->number(user, item->valuedouble, number, len);
+    case cJSON_String:
+        left = strlen(item->valuestring);
+        if (left <= CJSON_SAX_TOKEN_SIZE) {
+            return (callbacks->string == NULL) || callbacks->string(user, item->valuestring, left);
+        }
+        if (callbacks->string_part == NULL) {
+            return callbacks->string == NULL;
+        }
+        /* 文档是这里解码出来的, 每段后面临时写 '\0', 不用再复制一份 */
+        for (piece = item->valuestring; keep_going && (left > 0); piece += piece_len, left -= piece_len) {
+            piece_len = (left < CJSON_SAX_TOKEN_SIZE) ? left : CJSON_SAX_TOKEN_SIZE;
+            saved = piece[piece_len];
+            piece[piece_len] = '\0';
+            keep_going = callbacks->string_part(user, piece, piece_len, left > piece_len);
+            piece[piece_len] = saved;
+        }
+        return keep_going;
+    case cJSON_Array:
+        if ((callbacks->start_array != NULL) && !callbacks->start_array(user)) {
+            return false;
+        }
+        for (child = item->child; child != NULL; child = child->next) {
+            if (!priv_sax_replay(child, callbacks, user)) {
+                return false;
+            }
+        }
+        return (callbacks->end_array == NULL) || callbacks->end_array(user);
+    case cJSON_Object:
+        if ((callbacks->start_object != NULL) && !callbacks->start_object(user)) {
+            return false;
+        }
+        for (child = item->child; child != NULL; child = child->next) {
+            if (!priv_sax_replay(child, callbacks, user)) {
+                return false;
+            }
+        }
+        return (callbacks->end_object == NULL) || callbacks->end_object(user);
+    default:
+        return false;
+    }
+}
+
+static int priv_recv_cbor(httpd_req_t *req, const cJSON_SaxCallbacks *callbacks, void *user)
+{
+    static const cJSON_SaxCallbacks s_no_callbacks = {0};
+    uint8_t *buf = NULL;
+    cJSON *item = NULL;
+    size_t received = 0;
+    size_t consumed = 0;
+    int recv_len = 0;
+    int retry = 0;
+    int ret = -1;
+
+    if ((req->content_len == 0) || (req->content_len > HTTP_JSON_CBOR_MAX)) {
+        ESP_LOGE(TAG, "cbor body size %d not supported", req->content_len);
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, NULL);
+        return -1;
+    }
+
+    buf = (uint8_t *)mod_mem_malloc(req->content_len, MOD_MEM_DEFAULT);
+    if (buf == NULL) {
+        ESP_LOGE(TAG, "malloc failed");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+        return -1;
+    }
+
+    while (received < req->content_len) {
+        recv_len = httpd_req_recv(req, (char *)buf + received, req->content_len - received);
+        if ((recv_len == HTTPD_SOCK_ERR_TIMEOUT) && (++retry < HTTP_JSON_RECV_RETRY)) {
+            continue;
+        }
+        if (recv_len <= 0) {
+            ESP_LOGE(TAG, "receive body failed: %d", recv_len);
+            httpd_resp_send_err(req, (recv_len == HTTPD_SOCK_ERR_TIMEOUT) ? HTTPD_408_REQ_TIMEOUT : HTTPD_400_BAD_REQUEST, NULL);
+            goto exit;
+        }
+        retry = 0;
+        received += recv_len;
+    }
+
+    item = cJSON_CborDecode(buf, received, &consumed);
+    if ((item == NULL) || (consumed != received)) {
+        ESP_LOGE(TAG, "invalid cbor body");
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, NULL);
+        goto exit;
+    }
+
+    if (!priv_sax_replay(item, (callbacks != NULL) ? callbacks : &s_no_callbacks, user)) {
+        ESP_LOGE(TAG, "cbor body rejected");
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, NULL);
+        goto exit;
+    }
+    ret = 0;
+
+exit:
+    cJSON_Delete(item);
+    mod_mem_free(buf);
+
+    return ret;
+}
+
+/* 按请求的大小取池里的缓冲区, 取不到时临时申请 */
+static int priv_send_cbor(httpd_req_t *req, const cJSON *item)
+{
+    http_json_pool_t *pool = NULL;
+    uint8_t *buf = NULL;
+    size_t size = 0;
+    size_t len = 0;
+    int ret = -1;
+
+    size = cJSON_CborEncode(item, NULL, 0);
+    if (size == 0) {
+        ESP_LOGE(TAG, "document can't be encoded as cbor");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+        return -1;
+    }
+
+    if (size <= HTTP_JSON_POOL_MAX) {
+        pool = priv_pool_acquire(((size + 63) / 64) * 64);
+    }
+
+    if ((pool != NULL) && (pool->size >= size)) {
+        buf = (uint8_t *)pool->buf;
+    } else {
+        buf = (uint8_t *)mod_mem_malloc(size, MOD_MEM_BULK);
+        if (buf == NULL) {
+            ESP_LOGE(TAG, "malloc failed");
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+            goto exit;
+        }
+    }
+
+    len = cJSON_CborEncode(item, buf, size);
+    httpd_resp_set_type(req, HTTP_JSON_TYPE_CBOR);
+    ret = (httpd_resp_send(req, (const char *)buf, len) == ESP_OK) ? 0 : -1;
+
+exit:
+    if ((pool != NULL) && (buf == (uint8_t *)pool->buf)) {
+        buf = NULL;
+    }
+    if (pool != NULL) {
+        priv_pool_release(pool);
+    }
+    mod_mem_free(buf);
+
+    if (ret == 0) {
+        taskENTER_CRITICAL(&s_pool_lock);
+        s_stats.cbor++;
+        taskEXIT_CRITICAL(&s_pool_lock);
+    }
+
+    return ret;
+}
+
+int http_json_recv(httpd_req_t *req, const cJSON_SaxCallbacks *callbacks, void *user)
+{
+    cJSON_SaxParser parser;
+    cJSON_SaxStatus status = cJSON_SaxOk;
+
+    char buf[HTTP_JSON_RECV_CHUNK];
+    size_t remaining = 0;
+    int recv_len = 0;
+    int retry = 0;
+
+    if (req == NULL) {
+        return -1;
+    }
+
+    if (priv_hdr_has_type(req, "Content-Type", HTTP_JSON_TYPE_CBOR)) {
+        return priv_recv_cbor(req, callbacks, user);
+    }
+
+    cJSON_SaxInit(&parser, callbacks, user);
+
+    remaining = req->content_len;
+    while (remaining > 0) {
+        recv_len = httpd_req_recv(req, buf, (remaining < sizeof(buf)) ? remaining : sizeof(buf));
+        if ((recv_len == HTTPD_SOCK_ERR_TIMEOUT) && (++retry < HTTP_JSON_RECV_RETRY)) {
+            continue;
+        }
+        if (recv_len <= 0) {
+            ESP_LOGE(TAG, "receive body failed: %d", recv_len);
+            httpd_resp_send_err(req, (recv_len == HTTPD_SOCK_ERR_TIMEOUT) ? HTTPD_408_REQ_TIMEOUT : HTTPD_400_BAD_REQUEST, NULL);
+            return -1;
+        }
+        retry = 0;
+        remaining -= recv_len;
+
+        status = cJSON_SaxFeed(&parser, buf, recv_len);
+        if (status < 0) {
+            break;
+        }
+    }
+
+    if (status >= 0) {
+        status = cJSON_SaxFinish(&parser);
+    }
+
+    if (status == cJSON_SaxTokenTooLong) {
+        ESP_LOGE(TAG, "json token longer than %d at offset %d", CJSON_SAX_TOKEN_SIZE, (int)parser.offset);
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "key, number or string too long");
+        return -1;
+    }
+
+    if (status != cJSON_SaxDone) {
+        ESP_LOGE(TAG, "invalid json body: status %d at offset %d", status, (int)parser.offset);
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, NULL);
+        return -1;
+    }
+
+    return 0;
+}
+
+void http_json_writer_init(cJSON_Writer *writer, httpd_req_t *req, char *buf, size_t size)
+{
+    /* 和 http_json_send 一样按 Accept 选择编码, 处理函数用同一套 cJSON_Writer* 调用 */
+    if (priv_accept_cbor(req)) {
+        httpd_resp_set_type(req, HTTP_JSON_TYPE_CBOR);
+        cJSON_WriterInitCbor(writer, buf, size, priv_writer_flush, req);
+        return;
+    }
+
+    httpd_resp_set_type(req, HTTP_JSON_TYPE_JSON);
+    cJSON_WriterInit(writer, buf, size, priv_writer_flush, req);
+}
+
+int http_json_writer_finish(cJSON_Writer *writer)
+{
+    httpd_req_t *req = NULL;
+
+    if (writer == NULL) {
+        return -1;
+    }
+    req = (httpd_req_t *)writer->user;
+
+    if (!cJSON_WriterFinish(writer)) {
+        ESP_LOGE(TAG, "json response incomplete");
+        /* terminate the chunked response anyway so the connection stays usable */
+        httpd_resp_send_chunk(req, NULL, 0);
+        return -1;
+    }
+
+    if (httpd_resp_send_chunk(req, NULL, 0) != ESP_OK) {
+        return -1;
+    }
+
+    if (writer->cbor) {
+        taskENTER_CRITICAL(&s_pool_lock);
+        s_stats.cbor++;
+        taskEXIT_CRITICAL(&s_pool_lock);
+    }
+
+    return 0;
+}
+
+int http_json_send(httpd_req_t *req, const cJSON *item)
+{
+    http_json_pool_t *pool = NULL;
+    http_json_stream_t stream = {0};
+    cJSON_Writer writer;
+    char chunk[HTTP_JSON_STREAM_CHUNK];
+    uint32_t hash = 0;
+    size_t size = 0;
+    size_t len = 0;
+    bool pooled = false;
+    int ret = -1;
+
+    if ((req == NULL) || (item == NULL)) {
+        return -1;
+    }
+
+    if (priv_accept_cbor(req)) {
+        return priv_send_cbor(req, item);
+    }
+
+    httpd_resp_set_type(req, HTTP_JSON_TYPE_JSON);
+
+    hash = priv_route_hash(req->uri);
+
+    /* 25% headroom over the estimate plus the 5 bytes cJSON_PrintPreallocated asks for, rounded to 64 */
+    taskENTER_CRITICAL(&s_pool_lock);
+    size = priv_route_estimate(hash);
+    taskEXIT_CRITICAL(&s_pool_lock);
+    size = ((size + size / 4 + 5 + 63) / 64) * 64;
+    if (size < HTTP_JSON_POOL_MIN) {
+        size = HTTP_JSON_POOL_MIN;
+    }
+
+    if (size <= HTTP_JSON_POOL_MAX) {
+        pool = priv_pool_acquire(size);
+    }
+
+    if ((pool != NULL) && cJSON_PrintPreallocated((cJSON *)item, pool->buf, (int)pool->size, false)) {
+        len = strlen(pool->buf);
+        ret = (httpd_resp_send(req, pool->buf, len) == ESP_OK) ? 0 : -1;
+        priv_pool_release(pool);
+        pooled = true;
+        goto exit;
+    }
+
+    /* document overflowed the buffer, stream it instead (through the pool buffer if we hold one) */
+    stream.req = req;
+    if (pool != NULL) {
+        cJSON_WriterInit(&writer, pool->buf, pool->size, priv_stream_flush, &stream);
+    } else {
+        cJSON_WriterInit(&writer, chunk, sizeof(chunk), priv_stream_flush, &stream);
+    }
+
+    if (cJSON_WriterItem(&writer, item) && cJSON_WriterFinish(&writer)) {
+        ret = (httpd_resp_send_chunk(req, NULL, 0) == ESP_OK) ? 0 : -1;
+    } else {
+        ESP_LOGE(TAG, "json response incomplete");
+        httpd_resp_send_chunk(req, NULL, 0);
+    }
+
+    if (pool != NULL) {
+        priv_pool_release(pool);
+    }
+    len = stream.total;
+
+exit:
+    taskENTER_CRITICAL(&s_pool_lock);
+    priv_route_update(hash, len);
+    if (pooled) {
+        s_stats.pooled++;
+    } else {
+        s_stats.streamed++;
+    }
+    taskEXIT_CRITICAL(&s_pool_lock);
+
+    return ret;
+}
+
+int http_json_get_stats(http_json_stats_t *stats)
+{
+    int i = 0;
+
+    if (stats == NULL) {
+        return -1;
+    }
+
+    taskENTER_CRITICAL(&s_pool_lock);
+    *stats = s_stats;
+    stats->pool_bytes = 0;
+    for (i = 0; i < HTTP_JSON_POOL_NUM; i++) {
+        stats->pool_bytes += s_pool[i].size;
+    }
+    taskEXIT_CRITICAL(&s_pool_lock);
+
+    return 0;
+}
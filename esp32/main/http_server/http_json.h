@@ -0,0 +1,93 @@
+/*
+ * http_json.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef __HTTP_JSON_H__
+#define __HTTP_JSON_H__
+
+#include "esp_http_server.h"
+#include "cJSON_Sax.h"
+#include "cJSON_Writer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t pooled;    /* responses formatted into a pool buffer */
+    uint32_t streamed;  /* responses that overflowed and were sent chunked */
+    uint32_t grows;     /* pool buffer reallocations */
+    uint32_t cbor;      /* responses sent as application/cbor, pooled or streamed by the writer */
+    size_t pool_bytes;  /* memory held by the pool */
+} http_json_stats_t;
+
+/**
+ * @brief Stream the request body into a SAX parser
+ * @param req HTTP request
+ * @param callbacks SAX callbacks, invoked per key and value
+ * @param user User data passed to the callbacks
+ * @return
+ *  - 0: body is a complete JSON document
+ *  - -1: failure
+ * @note The body is never buffered as a whole, memory use is bounded by the parser and one receive chunk.
+ *       A body with Content-Type application/cbor (up to 4 KiB) is decoded and replayed as the same callbacks,
+ *       numbers get their shortest text form.
+ *       Keys, numbers and strings are limited to CJSON_SAX_TOKEN_SIZE (256) bytes, longer ones fail with
+ *       400 "key, number or string too long". Set the string_part callback to take longer string values
+ *       (certificates, base64 data) in pieces instead.
+ *       This function will send HTTP error response automatically on failure.
+ */
+int http_json_recv(httpd_req_t *req, const cJSON_SaxCallbacks *callbacks, void *user);
+
+/**
+ * @brief Start a chunked JSON response, CBOR encoded when the Accept header asks for it like for http_json_send
+ * @param writer Writer to initialize
+ * @param req HTTP request
+ * @param buf Format buffer, sent with httpd_resp_send_chunk every time it fills up
+ * @param size Buffer size
+ * @note Build the document with the cJSON_Writer* functions, then call http_json_writer_finish.
+ *       cJSON_WriterRaw fails on a CBOR response.
+ */
+void http_json_writer_init(cJSON_Writer *writer, httpd_req_t *req, char *buf, size_t size);
+
+/**
+ * @brief Flush the remaining output and terminate the chunked response
+ * @param writer Writer started by http_json_writer_init
+ * @return
+ *  - 0: success
+ *  - -1: failure, the response is incomplete
+ */
+int http_json_writer_finish(cJSON_Writer *writer);
+
+/**
+ * @brief Send a cJSON document as the response
+ * @param req HTTP request
+ * @param item Document
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ * @note The document is printed into a pooled buffer sized from a running estimate of earlier responses
+ *       on the same uri, so steady state responses don't allocate. Documents that overflow the buffer
+ *       are streamed as a chunked response instead.
+ *       When the Accept header lists application/cbor, not refused with q=0 and weighted at least as high as
+ *       application/json, the document is sent CBOR encoded. Media types compare case insensitively, parameters
+ *       other than q are ignored.
+ */
+int http_json_send(httpd_req_t *req, const cJSON *item);
+
+/**
+ * @brief Get response buffer pool statistics
+ * @param stats Statistics
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int http_json_get_stats(http_json_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HTTP_JSON_H__ */
@@ -0,0 +1,341 @@
+/*
+ * http_uri_files.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <stdlib.h>
+#include <strings.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "mbedtls/sha256.h"
+#include "cJSON.h"
+
+#include "mod_mem.h"
+#include "mod_fs.h"
+#include "mod_fs_async.h"
+#include "http_auth.h"
+#include "http_json.h"
+#include "http_uri_files.h"
+
+#define FILES_PATH_MAX      64
+#define FILES_CHUNK_SIZE    4096
+#define FILES_RECV_RETRY    3
+#define FILES_SHA256_LEN    32
+#define FILES_SHA256_HDR    "X-Content-SHA256"
+#define FILES_QUERY_LEN     64
+#define FILES_LIST_CHUNK    1024
+#define FILES_LIST_LIMIT    50  /* default page size */
+#define FILES_LIST_LIMIT_MAX 500
+
+static const char *TAG = "httpd_files";
+
+/**
+ * 取出 uri 中的路径, 去掉查询字符串.
+ * 不允许 ".." 和空的路径段. 目录可以为空 (根目录) 或以 '/' 结尾,
+ * 文件不能以 mod_fs 原子写使用的 '~' '^' 结尾.
+ */
+static int priv_files_path(httpd_req_t *req, char *path, size_t size, bool dir)
+{
+    const char *start = req->uri + strlen(HTTP_URI_FILES_PREFIX);
+    size_t len = strcspn(start, "?");
+
+    if (dir && (len == 0)) {
+        strcpy(path, "/");
+        return 0;
+    }
+
+    if ((len < 2) || (len >= size) || (start[0] != '/')) {
+        return -1;
+    }
+
+    memcpy(path, start, len);
+    path[len] = '\0';
+
+    if ((strstr(path, "//") != NULL) || (strstr(path, "/../") != NULL) ||
+        ((len >= 3) && (strcmp(path + len - 3, "/..") == 0))) {
+        return -1;
+    }
+
+    if (!dir && ((path[len - 1] == '/') || (path[len - 1] == '~') || (path[len - 1] == '^'))) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static void priv_files_hex(const uint8_t *data, size_t len, char *hex)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    for (size_t i = 0; i < len; i++) {
+        hex[2 * i] = digits[data[i] >> 4];
+        hex[2 * i + 1] = digits[data[i] & 0x0F];
+    }
+    hex[2 * len] = '\0';
+}
+
+/**
+ * 双缓冲接收: I/O 任务写入上一块的同时接收下一块并计算 SHA-256.
+ * 返回 0 成功, -1 失败 (错误响应已发送).
+ */
+static int priv_files_recv(httpd_req_t *req, FILE *fp, mbedtls_sha256_context *sha)
+{
+    mod_fs_async_req_t io = {0};
+    size_t remaining = req->content_len;
+    bool pending = false;
+    char *buf = NULL;
+    int retry = 0;
+    int cur = 0;
+    int len = 0;
+    int ret = -1;
+
+    buf = (char *)mod_mem_malloc(2 * FILES_CHUNK_SIZE, MOD_MEM_INTERNAL);
+    if (buf == NULL) {
+        ESP_LOGE(TAG, "malloc failed");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+        return -1;
+    }
+
+    while (remaining > 0) {
+        len = httpd_req_recv(req, buf + cur * FILES_CHUNK_SIZE,
+                             (remaining < FILES_CHUNK_SIZE) ? remaining : FILES_CHUNK_SIZE);
+        if ((len == HTTPD_SOCK_ERR_TIMEOUT) && (++retry < FILES_RECV_RETRY)) {
+            continue;
+        }
+        if (len <= 0) {
+            ESP_LOGE(TAG, "recv failed: %d", len);
+            httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, NULL);
+            goto exit;
+        }
+        retry = 0;
+
+        /* 硬件 SHA 加速, 和上一块的写入重叠 */
+        mbedtls_sha256_update(sha, (const unsigned char *)buf + cur * FILES_CHUNK_SIZE, len);
+
+        if (pending) {
+            mod_fs_async_wait(&io, MOD_FS_ASYNC_FOREVER);
+            pending = false;
+            if (io.result < 0) {
+                ESP_LOGE(TAG, "write failed");
+                httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "write failed");
+                goto exit;
+            }
+        }
+
+        if (mod_fs_async_write(&io, fp, buf + cur * FILES_CHUNK_SIZE, len, NULL, NULL) != 0) {
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+            goto exit;
+        }
+        pending = true;
+
+        remaining -= len;
+        cur ^= 1;
+    }
+
+    if (pending) {
+        mod_fs_async_wait(&io, MOD_FS_ASYNC_FOREVER);
+        pending = false;
+        if (io.result < 0) {
+            ESP_LOGE(TAG, "write failed");
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "write failed");
+            goto exit;
+        }
+    }
+    ret = 0;
+
+exit:
+    /* 缓冲区在写入完成前不能释放 */
+    if (pending) {
+        mod_fs_async_wait(&io, MOD_FS_ASYNC_FOREVER);
+    }
+    mod_mem_free(buf);
+
+    return ret;
+}
+
+static esp_err_t priv_files_put(httpd_req_t *req)
+{
+    mbedtls_sha256_context sha;
+    uint8_t digest[FILES_SHA256_LEN];
+    char expect[2 * FILES_SHA256_LEN + 1] = {0};
+    char actual[2 * FILES_SHA256_LEN + 1] = {0};
+    char path[FILES_PATH_MAX];
+    cJSON *resp = NULL;
+    FILE *fp = NULL;
+    size_t len = 0;
+
+    if (priv_files_path(req, path, sizeof(path), false) != 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad path");
+        return ESP_OK;
+    }
+
+    /* content_len 为 0 时创建空文件 */
+    len = httpd_req_get_hdr_value_len(req, FILES_SHA256_HDR);
+    if (len > 0) {
+        if ((len != (sizeof(expect) - 1)) ||
+            (httpd_req_get_hdr_value_str(req, FILES_SHA256_HDR, expect, sizeof(expect)) != ESP_OK)) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad " FILES_SHA256_HDR);
+            return ESP_OK;
+        }
+    }
+
+    fp = mod_fs_atomic_open(MOD_FS_DEFAULT, path);
+    if (fp == NULL) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+        return ESP_OK;
+    }
+
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+
+    if (priv_files_recv(req, fp, &sha) != 0) {
+        mbedtls_sha256_free(&sha);
+        mod_fs_atomic_abort(MOD_FS_DEFAULT, path, fp);
+        return ESP_OK;
+    }
+
+    mbedtls_sha256_finish(&sha, digest);
+    mbedtls_sha256_free(&sha);
+    priv_files_hex(digest, sizeof(digest), actual);
+
+    if ((expect[0] != '\0') && (strcasecmp(expect, actual) != 0)) {
+        ESP_LOGE(TAG, "%s: checksum mismatch, got %s", path, actual);
+        mod_fs_atomic_abort(MOD_FS_DEFAULT, path, fp);
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "checksum mismatch");
+        return ESP_OK;
+    }
+
+    if (mod_fs_atomic_commit(MOD_FS_DEFAULT, path, fp) != 0) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "commit failed");
+        return ESP_OK;
+    }
+    ESP_LOGI(TAG, "%s: %d B stored", path, req->content_len);
+
+    resp = cJSON_CreateObject();
+    if (resp == NULL) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+        return ESP_OK;
+    }
+    cJSON_AddStringToObject(resp, "path", path);
+    cJSON_AddNumberToObject(resp, "size", req->content_len);
+    cJSON_AddStringToObject(resp, "sha256", actual);
+    http_json_send(req, resp);
+    cJSON_Delete(resp);
+
+    return ESP_OK;
+}
+
+/**
+ * 分页列出目录, 边遍历边发送, 内存占用和目录大小无关.
+ * 查询参数: cursor 上一页返回的 next, limit 每页条目数 (默认 FILES_LIST_LIMIT, 最多 FILES_LIST_LIMIT_MAX).
+ */
+static esp_err_t priv_files_list(httpd_req_t *req)
+{
+    char query[FILES_QUERY_LEN] = {0};
+    char value[16] = {0};
+    char path[FILES_PATH_MAX];
+    char chunk[FILES_LIST_CHUNK];
+    cJSON_Writer writer;
+    mod_fs_entry_t entry;
+    mod_fs_dir_t *dir = NULL;
+    char *end = NULL;
+    long cursor = 0;
+    long next = -1;
+    long limit = FILES_LIST_LIMIT;
+    int count = 0;
+
+    if (priv_files_path(req, path, sizeof(path), true) != 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad path");
+        return ESP_OK;
+    }
+
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        if (httpd_query_key_value(query, "cursor", value, sizeof(value)) == ESP_OK) {
+            cursor = strtol(value, NULL, 10);
+        }
+        if (httpd_query_key_value(query, "limit", value, sizeof(value)) == ESP_OK) {
+            /* 无效值用默认页大小, 过大的值截到上限 */
+            limit = strtol(value, &end, 10);
+            if ((end == value) || (*end != '\0') || (limit <= 0)) {
+                limit = FILES_LIST_LIMIT;
+            } else if (limit > FILES_LIST_LIMIT_MAX) {
+                limit = FILES_LIST_LIMIT_MAX;
+            }
+        }
+    }
+
+    dir = mod_fs_dir_open(MOD_FS_DEFAULT, path);
+    if (dir == NULL) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, NULL);
+        return ESP_OK;
+    }
+    if (cursor > 0) {
+        mod_fs_dir_seek(dir, cursor);
+    }
+
+    http_json_writer_init(&writer, req, chunk, sizeof(chunk));
+    cJSON_WriterBeginObject(&writer);
+    cJSON_WriterKey(&writer, "path");
+    cJSON_WriterString(&writer, path);
+    cJSON_WriterKey(&writer, "entries");
+    cJSON_WriterBeginArray(&writer);
+
+    while (1) {
+        next = mod_fs_dir_tell(dir);
+        if (mod_fs_dir_next(dir, &entry) <= 0) {
+            next = -1;
+            break;
+        }
+        /* 多读的一条只用来判断还有没有下一页 */
+        if (count == limit) {
+            break;
+        }
+
+        cJSON_WriterBeginObject(&writer);
+        cJSON_WriterKey(&writer, "name");
+        cJSON_WriterString(&writer, entry.name);
+        cJSON_WriterKey(&writer, "size");
+        cJSON_WriterNumber(&writer, entry.size);
+        cJSON_WriterKey(&writer, "mtime");
+        cJSON_WriterNumber(&writer, entry.mtime);
+        cJSON_WriterKey(&writer, "dir");
+        cJSON_WriterBool(&writer, entry.is_dir);
+        cJSON_WriterEndObject(&writer);
+        count++;
+    }
+
+    cJSON_WriterEndArray(&writer);
+    cJSON_WriterKey(&writer, "next");
+    if (next >= 0) {
+        cJSON_WriterNumber(&writer, next);
+    } else {
+        cJSON_WriterNull(&writer);
+    }
+    cJSON_WriterEndObject(&writer);
+    http_json_writer_finish(&writer);
+
+    mod_fs_dir_close(dir);
+
+    return ESP_OK;
+}
+
+esp_err_t http_server_uri_files_handle(httpd_req_t *req)
+{
+    if (!http_auth_validate(req)) {
+        return ESP_OK;
+    }
+
+    if (req->method == HTTP_PUT) {
+        return priv_files_put(req);
+    }
+
+    if (req->method == HTTP_GET) {
+        return priv_files_list(req);
+    }
+
+    httpd_resp_send_err(req, HTTPD_405_METHOD_NOT_ALLOWED, NULL);
+
+    return ESP_OK;
+}
@@ -0,0 +1,35 @@
+/*
+ * http_uri_files.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef __HTTP_URI_FILES_H__
+#define __HTTP_URI_FILES_H__
+
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_URI_FILES_PREFIX    "/system/files"
+
+/**
+ * @brief httpd `/system/files` uri handler
+ * @note PUT /system/files/<path> stores the body as <path> on the file system. The file is replaced
+ *       atomically once the whole body arrived. If the X-Content-SHA256 header (hex) is given, the file
+ *       is only replaced when the SHA-256 of the body matches. The response is a JSON object with
+ *       path, size and sha256.
+ *       GET /system/files/<dir>?cursor=<next>&limit=<n> lists a directory (the root without <dir>),
+ *       streamed as {"path", "entries": [{"name", "size", "mtime", "dir"}], "next"}.
+ *       Pass next as cursor to get the following page, it is null on the last page.
+ * @return esp_err_t
+ */
+esp_err_t http_server_uri_files_handle(httpd_req_t *req);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HTTP_URI_FILES_H__ */
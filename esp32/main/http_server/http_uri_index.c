@@ -7,30 +7,114 @@
 #include "esp_err.h"
 #include "esp_log.h"
 
+#include "mod_mem.h"
 #include "mod_fs.h"
+#include "mod_fs_async.h"
 #include "http_uri_index.h"
 
+#define INDEX_CHUNK_SIZE    2048
+
 static const char *TAG = "httpd_index";
 
-esp_err_t http_server_uri_index_handle(httpd_req_t *req)
+/**
+ * 双缓冲发送文件: 一块在发送的同时, I/O 任务读取下一块.
+ * 返回 0 成功, -1 失败 (已发送的部分无法撤回, 调用者要关闭连接).
+ */
+static int priv_send_file(httpd_req_t *req, FILE *fp)
 {
+    mod_fs_async_req_t io = {0};
+    bool pending = false;
     char *buf = NULL;
+    int cur = 0;
+    int len = 0;
+    int ret = -1;
+
+    buf = (char *)mod_mem_malloc(2 * INDEX_CHUNK_SIZE, MOD_MEM_DEFAULT);
+    if (buf == NULL) {
+        ESP_LOGE(TAG, "malloc failed");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+        return -1;
+    }
+
+    if (mod_fs_async_read(&io, fp, buf, INDEX_CHUNK_SIZE, NULL, NULL) != 0) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+        goto exit;
+    }
+    pending = true;
+
+    while (1) {
+        mod_fs_async_wait(&io, MOD_FS_ASYNC_FOREVER);
+        pending = false;
+
+        len = io.result;
+        if (len < 0) {
+            ESP_LOGE(TAG, "read failed");
+            break;
+        }
+        if (len == 0) {
+            ret = (httpd_resp_send_chunk(req, NULL, 0) == ESP_OK) ? 0 : -1;
+            break;
+        }
+
+        /* 读满一块才可能还有数据 */
+        if (len == INDEX_CHUNK_SIZE) {
+            if (mod_fs_async_read(&io, fp, buf + (cur ^ 1) * INDEX_CHUNK_SIZE, INDEX_CHUNK_SIZE, NULL, NULL) != 0) {
+                break;
+            }
+            pending = true;
+        }
+
+        if (httpd_resp_send_chunk(req, buf + cur * INDEX_CHUNK_SIZE, len) != ESP_OK) {
+            ESP_LOGE(TAG, "send failed");
+            break;
+        }
+
+        if (!pending) {
+            ret = (httpd_resp_send_chunk(req, NULL, 0) == ESP_OK) ? 0 : -1;
+            break;
+        }
+        cur ^= 1;
+    }
+
+exit:
+    /* 缓冲区和文件在请求完成前不能释放 */
+    if (pending) {
+        mod_fs_async_wait(&io, MOD_FS_ASYNC_FOREVER);
+    }
+    mod_mem_free(buf);
+
+    return ret;
+}
+
+esp_err_t http_server_uri_index_handle(httpd_req_t *req)
+{
+    const char *path = req->uri;
+    FILE *fp = NULL;
+    int ret = 0;
 
     ESP_LOGI(TAG, "uri: %s", req->uri);
 
     if (strcmp(req->uri, "/") == 0) {
-        buf = (char *)mod_fs_file_read(MOD_FS_SPIFFS, "/index.html");
+        path = "/index.html";
         httpd_resp_set_type(req, "text/html");
     } else if (strstr(req->uri, ".js") != NULL) {
-        buf = (char *)mod_fs_file_read(MOD_FS_SPIFFS, req->uri);
         httpd_resp_set_type(req, "text/javascript");
     } else if (strstr(req->uri, ".css") != NULL) {
-        buf = (char *)mod_fs_file_read(MOD_FS_SPIFFS, req->uri);
         httpd_resp_set_type(req, "text/css");
+    } else {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, NULL);
+        return ESP_OK;
+    }
+
+    fp = mod_fs_open_ex(MOD_FS_WWW, path, "r", MOD_FS_HINT_SEQUENTIAL);
+    if (fp == NULL) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, NULL);
+        return ESP_OK;
     }
 
-    httpd_resp_send(req, buf, strlen(buf));
-    mod_fs_buf_free(buf);
+    ret = priv_send_file(req, fp);
+    mod_fs_close(fp);
 
-    return ESP_OK;
+    /* 发送到一半失败时, 客户端收到的是不完整的分块响应, 返回 ESP_FAIL 让 httpd 关闭连接 */
+    return (ret == 0) ? ESP_OK : ESP_FAIL;
 }
@@ -6,10 +6,17 @@
  */
 #include "esp_err.h"
 #include "esp_log.h"
+#include "cJSON.h"
 
+#include "mod_fs.h"
 #include "http_auth.h"
+#include "http_json.h"
+#include "http_uri_files.h"
+#include "http_uri_www.h"
 #include "http_uri_system.h"
 
+#define METRICS_CHUNK_SIZE  1024
+
 static const char *TAG = "httpd_system";
 
 static esp_err_t priv_login_handle(httpd_req_t *req)
@@ -26,6 +33,106 @@ static esp_err_t priv_login_handle(httpd_req_t *req)
     return ESP_OK;
 }
 
+static void priv_metrics_op(cJSON_Writer *writer, const mod_fs_op_stats_t *op)
+{
+    cJSON_WriterBeginObject(writer);
+    cJSON_WriterKey(writer, "count");
+    cJSON_WriterNumber(writer, op->count);
+    cJSON_WriterKey(writer, "errors");
+    cJSON_WriterNumber(writer, op->errors);
+    cJSON_WriterKey(writer, "bytes");
+    cJSON_WriterNumber(writer, op->bytes);
+    cJSON_WriterKey(writer, "total_us");
+    cJSON_WriterNumber(writer, op->total_us);
+    cJSON_WriterKey(writer, "max_us");
+    cJSON_WriterNumber(writer, op->max_us);
+    cJSON_WriterKey(writer, "hist");
+    cJSON_WriterBeginArray(writer);
+    for (int i = 0; i < MOD_FS_HIST_NUM; i++) {
+        cJSON_WriterNumber(writer, op->hist[i]);
+    }
+    cJSON_WriterEndArray(writer);
+    cJSON_WriterEndObject(writer);
+}
+
+/**
+ * 文件系统统计: {"fs": {<mount>: {"open_files", "open_files_max", "max_files", <op>: {...}}}, "gc": {...}}
+ * hist 第 i 个桶统计小于 hist_base_us << 2i 的操作, 最后一个是其余的.
+ */
+static esp_err_t priv_metrics_handle(httpd_req_t *req)
+{
+    char chunk[METRICS_CHUNK_SIZE];
+    cJSON_Writer writer;
+    mod_fs_stats_t stats;
+    mod_fs_gc_stats_t gc = {0};
+
+    if (!http_auth_validate(req)) {
+        return ESP_OK;
+    }
+
+    if (req->method != HTTP_GET) {
+        httpd_resp_send_err(req, HTTPD_405_METHOD_NOT_ALLOWED, NULL);
+        return ESP_OK;
+    }
+
+    http_json_writer_init(&writer, req, chunk, sizeof(chunk));
+    cJSON_WriterBeginObject(&writer);
+    cJSON_WriterKey(&writer, "hist_base_us");
+    cJSON_WriterNumber(&writer, MOD_FS_HIST_BASE_US);
+
+    cJSON_WriterKey(&writer, "fs");
+    cJSON_WriterBeginObject(&writer);
+    for (mod_fs_type_t type = MOD_FS_SPIFFS; type <= MOD_FS_WWW; type++) {
+        if ((mod_fs_get_stats(type, &stats) != 0) || (stats.open_files_max == 0)) {
+            continue;
+        }
+        cJSON_WriterKey(&writer, mod_fs_get_type_name(type));
+        cJSON_WriterBeginObject(&writer);
+        cJSON_WriterKey(&writer, "open_files");
+        cJSON_WriterNumber(&writer, stats.open_files);
+        cJSON_WriterKey(&writer, "open_files_max");
+        cJSON_WriterNumber(&writer, stats.open_files_max);
+        cJSON_WriterKey(&writer, "max_files");
+        cJSON_WriterNumber(&writer, stats.max_files);
+        for (int i = 0; i < MOD_FS_OP_NUM; i++) {
+            cJSON_WriterKey(&writer, mod_fs_get_op_name(i));
+            priv_metrics_op(&writer, &stats.ops[i]);
+        }
+        cJSON_WriterEndObject(&writer);
+    }
+    cJSON_WriterEndObject(&writer);
+
+    mod_fs_get_gc_stats(&gc);
+    cJSON_WriterKey(&writer, "gc");
+    cJSON_WriterBeginObject(&writer);
+    cJSON_WriterKey(&writer, "checks");
+    cJSON_WriterNumber(&writer, gc.checks);
+    cJSON_WriterKey(&writer, "runs");
+    cJSON_WriterNumber(&writer, gc.runs);
+    cJSON_WriterKey(&writer, "errors");
+    cJSON_WriterNumber(&writer, gc.errors);
+    cJSON_WriterKey(&writer, "total_us");
+    cJSON_WriterNumber(&writer, gc.total_us);
+    cJSON_WriterKey(&writer, "max_us");
+    cJSON_WriterNumber(&writer, gc.max_us);
+    cJSON_WriterKey(&writer, "free_pct");
+    cJSON_WriterNumber(&writer, gc.free_pct);
+    cJSON_WriterEndObject(&writer);
+
+    cJSON_WriterEndObject(&writer);
+    http_json_writer_finish(&writer);
+
+    return ESP_OK;
+}
+
+/* prefix 本身, 或者后面跟着子路径/查询字符串 */
+static bool priv_uri_match(const char *uri, const char *prefix)
+{
+    size_t len = strlen(prefix);
+
+    return (strncmp(uri, prefix, len) == 0) && ((uri[len] == '\0') || (uri[len] == '/') || (uri[len] == '?'));
+}
+
 esp_err_t http_server_uri_system_handle(httpd_req_t *req)
 {
     ESP_LOGI(TAG, "uri: %s", req->uri);
@@ -34,6 +141,18 @@ esp_err_t http_server_uri_system_handle(httpd_req_t *req)
         return priv_login_handle(req);
     }
 
+    if (priv_uri_match(req->uri, "/system/metrics")) {
+        return priv_metrics_handle(req);
+    }
+
+    if (priv_uri_match(req->uri, HTTP_URI_FILES_PREFIX)) {
+        return http_server_uri_files_handle(req);
+    }
+
+    if (priv_uri_match(req->uri, HTTP_URI_WWW_PREFIX)) {
+        return http_server_uri_www_handle(req);
+    }
+
     httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, NULL);
 
     return ESP_OK;
@@ -0,0 +1,177 @@
+/*
+ * http_uri_www.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "cJSON.h"
+
+#include "mod_mem.h"
+#include "mod_fs_www.h"
+#include "http_auth.h"
+#include "http_json.h"
+#include "http_uri_www.h"
+
+#define WWW_CHUNK_SIZE      4096
+#define WWW_RECV_RETRY      3
+#define WWW_SHA256_HDR      "X-Content-SHA256"
+
+static const char *TAG = "httpd_www";
+
+static int priv_www_hex_val(char c)
+{
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    }
+    if ((c >= 'A') && (c <= 'F')) {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+static int priv_www_unhex(const char *hex, uint8_t *data, size_t len)
+{
+    int hi = 0;
+    int lo = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        hi = priv_www_hex_val(hex[2 * i]);
+        lo = priv_www_hex_val(hex[2 * i + 1]);
+        if ((hi < 0) || (lo < 0)) {
+            return -1;
+        }
+        data[i] = (hi << 4) | lo;
+    }
+
+    return 0;
+}
+
+/* 返回 0 成功, -1 失败 (错误响应已发送) */
+static int priv_www_recv(httpd_req_t *req)
+{
+    size_t remaining = req->content_len;
+    char *buf = NULL;
+    int retry = 0;
+    int len = 0;
+    int ret = -1;
+
+    buf = (char *)mod_mem_malloc(WWW_CHUNK_SIZE, MOD_MEM_INTERNAL);
+    if (buf == NULL) {
+        ESP_LOGE(TAG, "malloc failed");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+        return -1;
+    }
+
+    while (remaining > 0) {
+        len = httpd_req_recv(req, buf, (remaining < WWW_CHUNK_SIZE) ? remaining : WWW_CHUNK_SIZE);
+        if ((len == HTTPD_SOCK_ERR_TIMEOUT) && (++retry < WWW_RECV_RETRY)) {
+            continue;
+        }
+        if (len <= 0) {
+            ESP_LOGE(TAG, "recv failed: %d", len);
+            httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, NULL);
+            goto exit;
+        }
+        retry = 0;
+
+        if (mod_fs_www_update_write(buf, len) != 0) {
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "write failed");
+            goto exit;
+        }
+        remaining -= len;
+    }
+    ret = 0;
+
+exit:
+    mod_mem_free(buf);
+
+    return ret;
+}
+
+static void priv_www_send_slot(httpd_req_t *req, size_t size)
+{
+    cJSON *resp = cJSON_CreateObject();
+
+    if (resp == NULL) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, NULL);
+        return;
+    }
+    cJSON_AddNumberToObject(resp, "slot", mod_fs_www_get_slot());
+    if (size > 0) {
+        cJSON_AddNumberToObject(resp, "size", size);
+    }
+    http_json_send(req, resp);
+    cJSON_Delete(resp);
+}
+
+static esp_err_t priv_www_put(httpd_req_t *req)
+{
+    uint8_t expect[MOD_FS_WWW_SHA256_LEN];
+    char hex[2 * MOD_FS_WWW_SHA256_LEN + 1] = {0};
+    bool check = false;
+    size_t len = 0;
+
+    if (req->content_len == 0) {
+        httpd_resp_send_err(req, HTTPD_411_LENGTH_REQUIRED, NULL);
+        return ESP_OK;
+    }
+
+    len = httpd_req_get_hdr_value_len(req, WWW_SHA256_HDR);
+    if (len > 0) {
+        if ((len != (sizeof(hex) - 1)) ||
+            (httpd_req_get_hdr_value_str(req, WWW_SHA256_HDR, hex, sizeof(hex)) != ESP_OK) ||
+            (priv_www_unhex(hex, expect, sizeof(expect)) != 0)) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad " WWW_SHA256_HDR);
+            return ESP_OK;
+        }
+        check = true;
+    }
+
+    if (mod_fs_www_update_begin(req->content_len) != 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "update not possible");
+        return ESP_OK;
+    }
+
+    if (priv_www_recv(req) != 0) {
+        mod_fs_www_update_abort();
+        return ESP_OK;
+    }
+
+    if (mod_fs_www_update_finish(check ? expect : NULL) != 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "verify failed");
+        return ESP_OK;
+    }
+    ESP_LOGI(TAG, "%d B image active in slot %d", req->content_len, mod_fs_www_get_slot());
+
+    priv_www_send_slot(req, req->content_len);
+
+    return ESP_OK;
+}
+
+esp_err_t http_server_uri_www_handle(httpd_req_t *req)
+{
+    if (!http_auth_validate(req)) {
+        return ESP_OK;
+    }
+
+    if (req->method == HTTP_PUT) {
+        return priv_www_put(req);
+    }
+
+    if (req->method == HTTP_GET) {
+        priv_www_send_slot(req, 0);
+        return ESP_OK;
+    }
+
+    httpd_resp_send_err(req, HTTPD_405_METHOD_NOT_ALLOWED, NULL);
+
+    return ESP_OK;
+}
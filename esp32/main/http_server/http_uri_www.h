@@ -0,0 +1,32 @@
+/*
+ * http_uri_www.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef __HTTP_URI_WWW_H__
+#define __HTTP_URI_WWW_H__
+
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_URI_WWW_PREFIX    "/system/www"
+
+/**
+ * @brief httpd `/system/www` uri handler
+ * @note PUT /system/www writes the body, a SPIFFS image of the web assets, into the inactive slot and
+ *       switches to it once the image is verified. If the X-Content-SHA256 header (hex) is given, the slot
+ *       is only switched when the SHA-256 of the body matches. The response is a JSON object with slot and size.
+ *       GET /system/www returns the active slot.
+ * @return esp_err_t
+ */
+esp_err_t http_server_uri_www_handle(httpd_req_t *req);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HTTP_URI_WWW_H__ */
@@ -10,9 +10,14 @@
 #include "freertos/task.h"
 #include "esp_log.h"
 
+#include "mod_mem.h"
 #include "mod_nvs.h"
 #include "mod_cmd.h"
+#include "mod_bench.h"
 #include "mod_fs.h"
+#include "mod_fs_async.h"
+#include "mod_fs_www.h"
+#include "mod_rec.h"
 #include "mod_network.h"
 #include "http_server.h"
 
@@ -20,10 +25,16 @@ static const char *TAG = "main";
 
 void app_main(void)
 {
+	/* 最先初始化, 之后的 cJSON 分配都经过内存策略 */
+	mod_mem_init();
 	/* WIFI 模块依赖 NVS 模块 */
 	mod_nvs_init();
 	mod_cmd_init();
+	mod_bench_init();
 	mod_fs_init(MOD_FS_DEFAULT);
+	mod_fs_async_init();
+	mod_fs_www_init();
+	mod_rec_init();
 	mod_network_init();
 
 	http_server_init();
@@ -0,0 +1,786 @@
+/*
+ * mod_bench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "argtable3/argtable3.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_console.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_heap_caps.h"
+
+#include "cJSON.h"
+#include "cJSON_Compact.h"
+#include "cJSON_Cbor.h"
+#include "base64.h"
+#include "mod_mem.h"
+#include "mod_fs.h"
+#include "mod_bench.h"
+
+#define BENCH_DEFAULT_ITERATIONS    50
+#define BENCH_BASE64_DEFAULT_SIZE   4096
+#define BENCH_CORPUS_BUF_LEN        16384
+
+#define BENCH_FILE_ENTRIES          64
+#define BENCH_TELEMETRY_SAMPLES     100
+
+#define BENCH_FS_MAX_FILES          32
+#define BENCH_FS_MAX_DEPTH          4
+#define BENCH_FS_PATH_LEN           64
+#define BENCH_FS_READ_CHUNK         4096
+#define BENCH_FS_SMALL_READ         256 /* typical parser/record read size, served from the stdio buffer */
+#define BENCH_FS_WRITE_SIZE         128
+#define BENCH_FS_WRITE_FILE         "/bench.tmp"
+#define BENCH_FS_APPEND_CHUNK       1024
+#define BENCH_FS_APPEND_COUNT       256 /* 256 KiB sustained sequential write */
+#define BENCH_FS_APPEND_FILE        "/bench.log"
+
+typedef int (*bench_doc_fn_t)(const char *name, const char *json, size_t len, int iterations);
+
+typedef struct {
+    char path[BENCH_FS_MAX_FILES][BENCH_FS_PATH_LEN]; /* relative to the mount path */
+    size_t size[BENCH_FS_MAX_FILES];
+    int count; /* files collected */
+    int total; /* files seen */
+} bench_fs_list_t;
+
+typedef struct {
+    uint32_t count; /* allocations */
+    size_t used;
+    size_t peak;
+} bench_alloc_t;
+
+static const char *TAG = "mod_bench";
+
+/* 与 HTTP 接口的报文结构保持一致 */
+static const char s_bench_login[] = "{\"username\":\"admin\",\"password\":\"88888888\"}";
+
+static const char s_bench_config[] =
+    "{\"network\":{\"mode\":\"eth\",\"dhcp\":true,\"ip\":\"192.168.1.100\",\"netmask\":\"255.255.255.0\","
+    "\"gateway\":\"192.168.1.1\",\"dns\":[\"8.8.8.8\",\"114.114.114.114\"]},"
+    "\"http\":{\"port\":80,\"max_uri_handlers\":8,\"auth\":true},"
+    "\"fs\":{\"type\":\"spiffs\",\"max_files\":20,\"format_if_mount_failed\":true},"
+    "\"log\":{\"level\":\"info\",\"tags\":{\"mod_fs\":\"warn\",\"httpd_auth\":\"error\"}}}";
+
+static bench_alloc_t s_bench_alloc = {0};
+
+static struct {
+    struct arg_str *target;
+    struct arg_str *file;
+    struct arg_int *iterations;
+    struct arg_int *size;
+    struct arg_end *end;
+} s_bench_args;
+
+static void *priv_bench_malloc(size_t size)
+{
+    void *ptr = malloc(size);
+
+    if (ptr != NULL) {
+        s_bench_alloc.count++;
+        s_bench_alloc.used += heap_caps_get_allocated_size(ptr);
+        if (s_bench_alloc.used > s_bench_alloc.peak) {
+            s_bench_alloc.peak = s_bench_alloc.used;
+        }
+    }
+
+    return ptr;
+}
+
+static void priv_bench_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    s_bench_alloc.used -= heap_caps_get_allocated_size(ptr);
+    free(ptr);
+}
+
+static void priv_bench_alloc_reset(void)
+{
+    memset(&s_bench_alloc, 0, sizeof(s_bench_alloc));
+}
+
+/* 字节数 / 微秒 = MB/s */
+static double priv_bench_mbps(size_t len, int iterations, int64_t us)
+{
+    if (us <= 0) {
+        return 0;
+    }
+
+    return ((double)len * iterations) / (double)us;
+}
+
+static size_t priv_bench_gen_files(char *buf, size_t size)
+{
+    size_t len = 0;
+
+    len += snprintf(buf + len, size - len, "{\"path\":\"/\",\"files\":[");
+    for (int i = 0; (i < BENCH_FILE_ENTRIES) && (len < size); i++) {
+        len += snprintf(buf + len, size - len, "%s{\"name\":\"assets/index-%08lx.js\",\"size\":%lu,\"type\":\"file\",\"mtime\":%lu}",
+                        (i == 0) ? "" : ",", esp_random(), esp_random() % 65536, 1767225600UL + i * 60);
+    }
+    if (len >= size) {
+        return 0;
+    }
+    len += snprintf(buf + len, size - len, "],\"total\":%d}", BENCH_FILE_ENTRIES);
+
+    return (len < size) ? len : 0;
+}
+
+static size_t priv_bench_gen_telemetry(char *buf, size_t size)
+{
+    size_t len = 0;
+
+    len += snprintf(buf + len, size - len, "{\"device\":\"esp32s3\",\"samples\":[");
+    for (int i = 0; (i < BENCH_TELEMETRY_SAMPLES) && (len < size); i++) {
+        len += snprintf(buf + len, size - len, "%s{\"ts\":%lu,\"temp\":%.2f,\"hum\":%.1f,\"rssi\":%d,\"ok\":%s}",
+                        (i == 0) ? "" : ",", 1767225600UL + i, 20.0 + (esp_random() % 1000) / 100.0,
+                        40.0 + (esp_random() % 300) / 10.0, -(int)(esp_random() % 60) - 30, (i % 7) ? "true" : "false");
+    }
+    if (len >= size) {
+        return 0;
+    }
+    len += snprintf(buf + len, size - len, "]}");
+
+    return (len < size) ? len : 0;
+}
+
+static int priv_bench_json(const char *name, const char *json, size_t len, int iterations)
+{
+    cJSON_Context ctx = {0};
+    cJSON_Hooks hooks = {
+        .malloc_fn = priv_bench_malloc,
+        .free_fn = priv_bench_free,
+    };
+    cJSON_CompactDoc *compact = NULL;
+    cJSON *item = NULL;
+    char *out = NULL;
+
+    uint32_t parse_allocs = 0;
+    size_t parse_peak = 0;
+    size_t tree_bytes = 0;
+    uint32_t print_allocs = 0;
+    size_t print_peak = 0;
+    size_t compact_bytes = 0;
+    int64_t parse_us = 0;
+    int64_t print_us = 0;
+    int64_t validate_us = 0;
+    int64_t start = 0;
+
+    cJSON_InitContext(&ctx, &hooks);
+
+    /* 单独跑一次统计分配次数和内存占用 */
+    priv_bench_alloc_reset();
+    item = cJSON_ParseWithContext(&ctx, json, len, NULL, false);
+    if (item == NULL) {
+        printf("%-10s parse failed at offset %d\n", name, (ctx.error_ptr != NULL) ? (int)(ctx.error_ptr - json) : -1);
+        return -1;
+    }
+    parse_allocs = s_bench_alloc.count;
+    parse_peak = s_bench_alloc.peak;
+    tree_bytes = s_bench_alloc.used;
+
+    priv_bench_alloc_reset();
+    out = cJSON_PrintWithContext(&ctx, item, false);
+    print_allocs = s_bench_alloc.count;
+    print_peak = s_bench_alloc.peak;
+    priv_bench_free(out);
+    cJSON_DeleteWithContext(&ctx, item);
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        item = cJSON_ParseWithContext(&ctx, json, len, NULL, false);
+        cJSON_DeleteWithContext(&ctx, item);
+    }
+    parse_us = esp_timer_get_time() - start;
+
+    item = cJSON_ParseWithContext(&ctx, json, len, NULL, false);
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        out = cJSON_PrintWithContext(&ctx, item, false);
+        priv_bench_free(out);
+    }
+    print_us = esp_timer_get_time() - start;
+    cJSON_DeleteWithContext(&ctx, item);
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        if (!cJSON_ValidateWithLength(json, len)) {
+            printf("%-10s validate failed\n", name);
+            return -1;
+        }
+    }
+    validate_us = esp_timer_get_time() - start;
+
+    compact = cJSON_CompactParse(json, len);
+    compact_bytes = cJSON_CompactMemoryUsage(compact);
+    cJSON_CompactDelete(compact);
+
+    printf("%-10s %6d B | parse %7.2f MB/s %5lu allocs peak %6d B | print %7.2f MB/s %3lu allocs peak %6d B | "
+           "validate %7.2f MB/s | tree %6d B compact %6d B\n",
+           name, len,
+           priv_bench_mbps(len, iterations, parse_us), parse_allocs, parse_peak,
+           priv_bench_mbps(len, iterations, print_us), print_allocs, print_peak,
+           priv_bench_mbps(len, iterations, validate_us),
+           tree_bytes, compact_bytes);
+
+    return 0;
+}
+
+/* 同一份数据分别用 JSON 文本和 CBOR 编解码, 对比报文大小和每次耗时 */
+static int priv_bench_cbor(const char *name, const char *json, size_t len, int iterations)
+{
+    cJSON *item = NULL;
+    char *text = NULL;
+    uint8_t *cbor = NULL;
+    size_t text_len = 0;
+    size_t cbor_len = 0;
+    int64_t print_us = 0;
+    int64_t encode_us = 0;
+    int64_t parse_us = 0;
+    int64_t decode_us = 0;
+    int64_t start = 0;
+    int ret = -1;
+
+    item = cJSON_ParseWithLength(json, len);
+    if (item == NULL) {
+        printf("%-10s parse failed\n", name);
+        return -1;
+    }
+
+    text = cJSON_PrintUnformatted(item);
+    cbor_len = cJSON_CborEncode(item, NULL, 0);
+    if ((text == NULL) || (cbor_len == 0)) {
+        printf("%-10s encode failed\n", name);
+        goto exit;
+    }
+    text_len = strlen(text);
+
+    cbor = (uint8_t *)mod_mem_malloc(cbor_len, MOD_MEM_BULK);
+    if (cbor == NULL) {
+        ESP_LOGE(TAG, "malloc failed");
+        goto exit;
+    }
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        cJSON_free(cJSON_PrintUnformatted(item));
+    }
+    print_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        cJSON_CborEncode(item, cbor, cbor_len);
+    }
+    encode_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        cJSON_Delete(cJSON_ParseWithLength(text, text_len));
+    }
+    parse_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        cJSON_Delete(cJSON_CborDecode(cbor, cbor_len, NULL));
+    }
+    decode_us = esp_timer_get_time() - start;
+
+    printf("%-10s json %6d B cbor %6d B (%3d%%) | print %8.1f us encode %8.1f us | parse %8.1f us decode %8.1f us\n",
+           name, text_len, cbor_len, (int)(cbor_len * 100 / text_len),
+           (double)print_us / iterations, (double)encode_us / iterations,
+           (double)parse_us / iterations, (double)decode_us / iterations);
+    ret = 0;
+
+exit:
+    mod_mem_free(cbor);
+    cJSON_free(text);
+    cJSON_Delete(item);
+
+    return ret;
+}
+
+static int priv_bench_corpus(bench_doc_fn_t bench, int iterations)
+{
+    char *buf = NULL;
+    size_t len = 0;
+    int ret = 0;
+
+    buf = (char *)mod_mem_malloc(BENCH_CORPUS_BUF_LEN, MOD_MEM_BULK);
+    if (buf == NULL) {
+        ESP_LOGE(TAG, "malloc failed");
+        return -1;
+    }
+
+    ret |= bench("login", s_bench_login, strlen(s_bench_login), iterations);
+    ret |= bench("config", s_bench_config, strlen(s_bench_config), iterations);
+
+    len = priv_bench_gen_files(buf, BENCH_CORPUS_BUF_LEN);
+    ret |= bench("files", buf, len, iterations);
+
+    len = priv_bench_gen_telemetry(buf, BENCH_CORPUS_BUF_LEN);
+    ret |= bench("telemetry", buf, len, iterations);
+
+    mod_mem_free(buf);
+
+    return ret;
+}
+
+static int priv_bench_file(bench_doc_fn_t bench, const char *path, int iterations)
+{
+    char *buf = NULL;
+    int ret = 0;
+
+    buf = (char *)mod_fs_file_read(MOD_FS_DEFAULT, path);
+    if (buf == NULL) {
+        printf("%s read failed\n", path);
+        return -1;
+    }
+
+    ret = bench(path, buf, strlen(buf), iterations);
+    mod_fs_buf_free(buf);
+
+    return ret;
+}
+
+static int priv_bench_base64(size_t size, int iterations)
+{
+    int ret = -1;
+    uint8_t *bin = NULL;
+    uint8_t *check = NULL;
+    char *b64 = NULL;
+    size_t b64_size = ((size + 2) / 3) * 4 + 1;
+    int b64_len = 0;
+    int64_t encode_us = 0;
+    int64_t decode_us = 0;
+    int64_t start = 0;
+
+    bin = (uint8_t *)mod_mem_malloc(size, MOD_MEM_DEFAULT);
+    check = (uint8_t *)mod_mem_malloc(size, MOD_MEM_DEFAULT);
+    b64 = (char *)mod_mem_malloc(b64_size, MOD_MEM_DEFAULT);
+    if ((bin == NULL) || (check == NULL) || (b64 == NULL)) {
+        ESP_LOGE(TAG, "malloc failed");
+        goto exit;
+    }
+    esp_fill_random(bin, size);
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        b64_len = bin_to_b64(bin, size, b64, b64_size);
+    }
+    encode_us = esp_timer_get_time() - start;
+    if (b64_len < 0) {
+        printf("base64 encode failed\n");
+        goto exit;
+    }
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        b64_to_bin(b64, b64_len, check, size);
+    }
+    decode_us = esp_timer_get_time() - start;
+
+    if (memcmp(bin, check, size) != 0) {
+        printf("base64 round trip mismatch\n");
+        goto exit;
+    }
+
+    printf("base64     %6d B | encode %7.2f MB/s | decode %7.2f MB/s\n",
+           size, priv_bench_mbps(size, iterations, encode_us), priv_bench_mbps(size, iterations, decode_us));
+    ret = 0;
+
+exit:
+    mod_mem_free(bin);
+    mod_mem_free(check);
+    mod_mem_free(b64);
+
+    return ret;
+}
+
+static const char *priv_bench_fs_name(mod_fs_type_t type)
+{
+    switch (type) {
+        case MOD_FS_SPIFFS:
+            return "spiffs";
+
+        case MOD_FS_LITTLEFS:
+            return "littlefs";
+
+        case MOD_FS_FATFS:
+            return "fatfs";
+
+        default:
+            return "unknown";
+    }
+}
+
+/* 遍历目录, SPIFFS 没有真正的目录, 文件名里带 '/' */
+static void priv_bench_fs_walk(const char *mount, const char *dir, bench_fs_list_t *list, int depth)
+{
+    char real_path[128];
+    char path[BENCH_FS_PATH_LEN];
+    struct dirent *entry = NULL;
+    struct stat st;
+    DIR *dp = NULL;
+
+    snprintf(real_path, sizeof(real_path), "%s%s", mount, dir);
+    dp = opendir(real_path);
+    if (dp == NULL) {
+        return;
+    }
+
+    while ((entry = readdir(dp)) != NULL) {
+        if (snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name) >= sizeof(path)) {
+            continue;
+        }
+
+        if (entry->d_type == DT_DIR) {
+            if (depth < BENCH_FS_MAX_DEPTH) {
+                priv_bench_fs_walk(mount, path, list, depth + 1);
+            }
+            continue;
+        }
+
+        snprintf(real_path, sizeof(real_path), "%s%s", mount, path);
+        if (stat(real_path, &st) != 0) {
+            continue;
+        }
+
+        list->total++;
+        if (list->count < BENCH_FS_MAX_FILES) {
+            strcpy(list->path[list->count], path);
+            list->size[list->count] = st.st_size;
+            list->count++;
+        }
+    }
+
+    closedir(dp);
+}
+
+static int priv_bench_cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* 打开, 按 chunk 读完整个文件, 关闭, 返回总耗时, -1 表示打开失败 */
+static int64_t priv_bench_fs_read(const char *path, mod_fs_hint_t hint, size_t chunk, uint8_t *buf, int iterations)
+{
+    int64_t start = esp_timer_get_time();
+    FILE *fp = NULL;
+
+    for (int i = 0; i < iterations; i++) {
+        fp = mod_fs_open_ex(MOD_FS_DEFAULT, path, "r", hint);
+        if (fp == NULL) {
+            return -1;
+        }
+        while (mod_fs_read(fp, buf, chunk) > 0) {
+        }
+        mod_fs_close(fp);
+    }
+
+    return esp_timer_get_time() - start;
+}
+
+/* 通过缓存句柄按偏移读, 句柄打开不再拼接路径 */
+static int64_t priv_bench_fs_pread(const char *path, size_t chunk, uint8_t *buf, int iterations)
+{
+    int64_t start = esp_timer_get_time();
+    mod_fs_handle_t handle = MOD_FS_HANDLE_INVALID;
+    size_t offset = 0;
+    int len = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        handle = mod_fs_handle_open(MOD_FS_DEFAULT, path);
+        if (handle == MOD_FS_HANDLE_INVALID) {
+            return -1;
+        }
+        offset = 0;
+        while ((len = mod_fs_pread(handle, buf, chunk, offset)) > 0) {
+            offset += len;
+        }
+        mod_fs_handle_close(handle);
+    }
+
+    return esp_timer_get_time() - start;
+}
+
+/* 持续追加写, 每块都 fsync, 用延迟分位数反映垃圾回收/簇分配造成的停顿 */
+static int priv_bench_fs_append(const char *mount, uint8_t *buf)
+{
+    uint32_t *latency = NULL;
+    char real_path[128];
+    FILE *fp = NULL;
+    int64_t total_us = 0;
+    int64_t start = 0;
+    int ret = -1;
+    int n = 0;
+
+    latency = (uint32_t *)mod_mem_malloc(BENCH_FS_APPEND_COUNT * sizeof(uint32_t), MOD_MEM_DEFAULT);
+    if (latency == NULL) {
+        ESP_LOGE(TAG, "malloc failed");
+        return -1;
+    }
+
+    fp = mod_fs_open(MOD_FS_DEFAULT, BENCH_FS_APPEND_FILE, "w");
+    if (fp == NULL) {
+        printf("%s open failed\n", BENCH_FS_APPEND_FILE);
+        goto exit;
+    }
+
+    esp_fill_random(buf, BENCH_FS_APPEND_CHUNK);
+    for (n = 0; n < BENCH_FS_APPEND_COUNT; n++) {
+        start = esp_timer_get_time();
+        if ((mod_fs_write(fp, buf, BENCH_FS_APPEND_CHUNK) != BENCH_FS_APPEND_CHUNK) || (fflush(fp) != 0) ||
+            (fsync(fileno(fp)) != 0)) {
+            printf("%s write failed after %d B\n", BENCH_FS_APPEND_FILE, n * BENCH_FS_APPEND_CHUNK);
+            break;
+        }
+        latency[n] = esp_timer_get_time() - start;
+        total_us += latency[n];
+    }
+    mod_fs_close(fp);
+
+    snprintf(real_path, sizeof(real_path), "%s%s", mount, BENCH_FS_APPEND_FILE);
+    remove(real_path);
+
+    if (n == 0) {
+        goto exit;
+    }
+
+    qsort(latency, n, sizeof(uint32_t), priv_bench_cmp_u32);
+    printf("%-32s %7d B | append p50 %6lu us p90 %6lu us p99 %6lu us max %6lu us | %7.2f MB/s\n",
+           BENCH_FS_APPEND_FILE, n * BENCH_FS_APPEND_CHUNK,
+           latency[n * 50 / 100], latency[n * 90 / 100], latency[n * 99 / 100], latency[n - 1],
+           priv_bench_mbps(n * BENCH_FS_APPEND_CHUNK, 1, total_us));
+    ret = (n == BENCH_FS_APPEND_COUNT) ? 0 : -1;
+
+exit:
+    mod_mem_free(latency);
+
+    return ret;
+}
+
+/* 在当前挂载的文件系统上测试, 切换分区类型重新编译后对比 SPIFFS, LittleFS 和 FATFS */
+static int priv_bench_fs(int iterations)
+{
+    mod_fs_type_t type = mod_fs_get_type();
+    const char *mount = mod_fs_get_mount_path(MOD_FS_DEFAULT);
+    bench_fs_list_t *list = NULL;
+    mod_fs_gc_stats_t gc = {0};
+    uint8_t *buf = NULL;
+    char real_path[128];
+    FILE *fp = NULL;
+    size_t total_size = 0;
+    int64_t total_read_us = 0;
+    int64_t total_small_us = 0;
+    int64_t total_seq_us = 0;
+    int64_t total_pread_us = 0;
+    int64_t list_us = 0;
+    int64_t open_us = 0;
+    int64_t read_us = 0;
+    int64_t small_us = 0;
+    int64_t seq_us = 0;
+    int64_t pread_us = 0;
+    int64_t write_us = 0;
+    int64_t atomic_us = 0;
+    int64_t start = 0;
+    int ret = -1;
+
+    if (type == MOD_FS_DEFAULT) {
+        printf("no file system mounted\n");
+        return -1;
+    }
+
+    list = (bench_fs_list_t *)mod_mem_calloc(1, sizeof(bench_fs_list_t), MOD_MEM_BULK);
+    buf = (uint8_t *)mod_mem_malloc(BENCH_FS_READ_CHUNK, MOD_MEM_DEFAULT);
+    if ((list == NULL) || (buf == NULL)) {
+        ESP_LOGE(TAG, "malloc failed");
+        goto exit;
+    }
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        list->count = 0;
+        list->total = 0;
+        priv_bench_fs_walk(mount, "", list, 0);
+    }
+    list_us = esp_timer_get_time() - start;
+
+    printf("%-10s %s | list %d files %8.1f us\n", priv_bench_fs_name(type), mount, list->total, (double)list_us / iterations);
+
+    for (int n = 0; n < list->count; n++) {
+        start = esp_timer_get_time();
+        for (int i = 0; i < iterations; i++) {
+            fp = mod_fs_open(MOD_FS_DEFAULT, list->path[n], "r");
+            if (fp == NULL) {
+                printf("%s open failed\n", list->path[n]);
+                goto exit;
+            }
+            mod_fs_close(fp);
+        }
+        open_us = esp_timer_get_time() - start;
+
+        read_us = priv_bench_fs_read(list->path[n], MOD_FS_HINT_DEFAULT, BENCH_FS_READ_CHUNK, buf, iterations);
+        small_us = priv_bench_fs_read(list->path[n], MOD_FS_HINT_DEFAULT, BENCH_FS_SMALL_READ, buf, iterations);
+        seq_us = priv_bench_fs_read(list->path[n], MOD_FS_HINT_SEQUENTIAL, BENCH_FS_SMALL_READ, buf, iterations);
+        pread_us = priv_bench_fs_pread(list->path[n], BENCH_FS_SMALL_READ, buf, iterations);
+        if ((read_us < 0) || (small_us < 0) || (seq_us < 0) || (pread_us < 0)) {
+            printf("%s open failed\n", list->path[n]);
+            goto exit;
+        }
+        /* 只算读取, 扣掉打开关闭的时间 */
+        read_us = (read_us > open_us) ? (read_us - open_us) : 1;
+        small_us = (small_us > open_us) ? (small_us - open_us) : 1;
+        seq_us = (seq_us > open_us) ? (seq_us - open_us) : 1;
+
+        total_size += list->size[n];
+        total_read_us += read_us;
+        total_small_us += small_us;
+        total_seq_us += seq_us;
+        total_pread_us += pread_us;
+        printf("%-32s %7d B | open %8.1f us | read %7.2f MB/s | %d B reads %7.2f MB/s sequential hint %7.2f MB/s pread %7.2f MB/s\n",
+               list->path[n], list->size[n], (double)open_us / iterations,
+               priv_bench_mbps(list->size[n], iterations, read_us), BENCH_FS_SMALL_READ,
+               priv_bench_mbps(list->size[n], iterations, small_us), priv_bench_mbps(list->size[n], iterations, seq_us),
+               priv_bench_mbps(list->size[n], iterations, pread_us));
+    }
+
+    if (list->count > 0) {
+        printf("%-32s %7d B | read %7.2f MB/s | %d B reads %7.2f MB/s sequential hint %7.2f MB/s pread %7.2f MB/s\n", "total",
+               total_size, priv_bench_mbps(total_size, iterations, total_read_us), BENCH_FS_SMALL_READ,
+               priv_bench_mbps(total_size, iterations, total_small_us), priv_bench_mbps(total_size, iterations, total_seq_us),
+               priv_bench_mbps(total_size, iterations, total_pread_us));
+    }
+
+    esp_fill_random(buf, BENCH_FS_WRITE_SIZE);
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        fp = mod_fs_open(MOD_FS_DEFAULT, BENCH_FS_WRITE_FILE, "w");
+        if (fp == NULL) {
+            printf("%s open failed\n", BENCH_FS_WRITE_FILE);
+            goto exit;
+        }
+        mod_fs_write(fp, buf, BENCH_FS_WRITE_SIZE);
+        mod_fs_close(fp);
+    }
+    write_us = esp_timer_get_time() - start;
+
+    /* 临时文件 + fsync + 改名的代价 */
+    start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        if (mod_fs_file_write(MOD_FS_DEFAULT, BENCH_FS_WRITE_FILE, buf, BENCH_FS_WRITE_SIZE) != 0) {
+            printf("%s atomic write failed\n", BENCH_FS_WRITE_FILE);
+            goto exit;
+        }
+    }
+    atomic_us = esp_timer_get_time() - start;
+
+    snprintf(real_path, sizeof(real_path), "%s%s", mount, BENCH_FS_WRITE_FILE);
+    remove(real_path);
+
+    printf("%-32s %7d B | write %8.1f us | atomic write %8.1f us\n", BENCH_FS_WRITE_FILE, BENCH_FS_WRITE_SIZE,
+           (double)write_us / iterations, (double)atomic_us / iterations);
+
+    ret = priv_bench_fs_append(mount, buf);
+
+    if (type == MOD_FS_SPIFFS) {
+        mod_fs_get_gc_stats(&gc);
+        printf("background gc | checks %lu runs %lu errors %lu | total %llu us max %lu us | free %lu%%\n", gc.checks,
+               gc.runs, gc.errors, gc.total_us, gc.max_us, gc.free_pct);
+    }
+
+exit:
+    mod_mem_free(list);
+    mod_mem_free(buf);
+
+    return ret;
+}
+
+static int priv_bench_cmd(int argc, char **argv)
+{
+    int iterations = BENCH_DEFAULT_ITERATIONS;
+    size_t size = BENCH_BASE64_DEFAULT_SIZE;
+    bench_doc_fn_t bench = NULL;
+    const char *target = NULL;
+
+    int nerrors = arg_parse(argc, argv, (void **)&s_bench_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, s_bench_args.end, argv[0]);
+        return 1;
+    }
+
+    if ((s_bench_args.iterations->count > 0) && (s_bench_args.iterations->ival[0] > 0)) {
+        iterations = s_bench_args.iterations->ival[0];
+    }
+
+    if ((s_bench_args.size->count > 0) && (s_bench_args.size->ival[0] > 0)) {
+        size = s_bench_args.size->ival[0];
+    }
+
+    target = s_bench_args.target->sval[0];
+    if (strcmp(target, "json") == 0) {
+        bench = priv_bench_json;
+    } else if (strcmp(target, "cbor") == 0) {
+        bench = priv_bench_cbor;
+    }
+
+    if (bench != NULL) {
+        if (s_bench_args.file->count > 0) {
+            return (priv_bench_file(bench, s_bench_args.file->sval[0], iterations) == 0) ? 0 : 1;
+        }
+        return (priv_bench_corpus(bench, iterations) == 0) ? 0 : 1;
+    }
+
+    if (strcmp(target, "base64") == 0) {
+        return (priv_bench_base64(size, iterations) == 0) ? 0 : 1;
+    }
+
+    if (strcmp(target, "fs") == 0) {
+        return (priv_bench_fs(iterations) == 0) ? 0 : 1;
+    }
+
+    printf("unknown target: %s\n", target);
+
+    return 1;
+}
+
+int mod_bench_init(void)
+{
+    esp_err_t err = ESP_OK;
+
+    s_bench_args.target = arg_str1(NULL, NULL, "<json|cbor|base64|fs>", "benchmark target");
+    s_bench_args.file = arg_str0("f", "file", "<path>", "json/cbor: file on the file system instead of the built-in corpus");
+    s_bench_args.iterations = arg_int0("n", "iterations", "<n>", "iterations per measurement");
+    s_bench_args.size = arg_int0("s", "size", "<bytes>", "base64: input size");
+    s_bench_args.end = arg_end(4);
+
+    const esp_console_cmd_t cmd = {
+        .command = "bench",
+        .help = "Measure cJSON parse/print/validate throughput, allocations and memory, JSON vs CBOR size and time, base64 encode/decode throughput, file system open/read/write/list latency and append percentiles",
+        .hint = NULL,
+        .func = &priv_bench_cmd,
+        .argtable = &s_bench_args,
+    };
+
+    err = esp_console_cmd_register(&cmd);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "bench command register failed: %s", esp_err_to_name(err));
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,27 @@
+/*
+ * mod_bench.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef __MOD_BENCH_H__
+#define __MOD_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize Benchmark Module, registers the "bench" console command
+ * @note Must be called after mod_cmd_init
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_bench_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOD_BENCH_H__ */
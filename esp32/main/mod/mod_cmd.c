@@ -9,6 +9,8 @@
 #include "esp_log.h"
 #include "esp_console.h"
 
+#include "mod_mem.h"
+#include "mod_fs.h"
 #include "mod_cmd.h"
 
 #define CMD_PROMPT    "cmd>"
@@ -17,6 +19,29 @@ static const char *TAG = "mod_cmd";
 
 static esp_console_repl_t *s_repl = NULL;
 
+static struct {
+    struct arg_lit *reset;
+    struct arg_end *end;
+} s_stats_args;
+
+static int priv_stats_cmd(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **)&s_stats_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, s_stats_args.end, argv[0]);
+        return 1;
+    }
+
+    mod_mem_dump();
+    mod_fs_dump();
+
+    if (s_stats_args.reset->count > 0) {
+        mod_fs_reset_stats();
+    }
+
+    return 0;
+}
+
 int mod_cmd_init(void)
 {
     if (s_repl != NULL) {
@@ -31,6 +56,19 @@ int mod_cmd_init(void)
     esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
 
     ESP_ERROR_CHECK(esp_console_new_repl_uart(&uart_config, &repl_config, &s_repl));
+
+    s_stats_args.reset = arg_lit0("r", "reset", "clear the file system statistics after printing");
+    s_stats_args.end = arg_end(1);
+
+    const esp_console_cmd_t stats_cmd = {
+        .command = "stats",
+        .help = "Print memory usage and per mount file system open/read/write/close counts, bytes, latency histograms and open file high-water marks",
+        .hint = NULL,
+        .func = &priv_stats_cmd,
+        .argtable = &s_stats_args,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&stats_cmd));
+
     ESP_ERROR_CHECK(esp_console_start_repl(s_repl));
 
     return 0;
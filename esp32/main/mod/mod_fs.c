@@ -4,20 +4,171 @@
  * SPDX-License-Identifier: Apache-2.0
  * SPDX-FileCopyrightText: 2026 Zeepunt
  */
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_partition.h"
+#include "esp_timer.h"
 #include "esp_spiffs.h"
-// #include "esp_littlefs.h"
+#include "esp_littlefs.h"
+#include "esp_vfs_fat.h"
+#include "wear_levelling.h"
 
+#include "mod_mem.h"
 #include "mod_fs.h"
+#include "mod_fs_www.h"
 
 #define FS_PARTITION_NAME    "fs"
 
 #define SPIFFS_MOUNT_PATH    "/spiffs"
+#define LITTLEFS_MOUNT_PATH  "/littlefs"
+#define FATFS_MOUNT_PATH     "/fatfs"
+
+#define SPIFFS_MAX_FILES     20
+
+/**
+ * FAT 簇大小, 只在格式化时生效, 大簇减少追加写时的 FAT 表更新, 小簇节省小文件空间.
+ * 扇区大小由 menuconfig 的 CONFIG_WL_SECTOR_SIZE 决定.
+ */
+#define FATFS_ALLOCATION_UNIT (16 * 1024)
+#define FATFS_MAX_FILES      20
+
+/**
+ * stdio 缓冲区池, 按打开提示给 FILE 设置缓冲区, 关闭时归还.
+ * 顺序读 4096: 预读 16 个 SPIFFS 页 (CONFIG_SPIFFS_PAGE_SIZE 256), 或 LittleFS/FAT 的一个扇区.
+ * 随机读 512: 每次 seek 后少读无用数据.
+ * 一次写入 4096: 攒满整页再写 flash.
+ */
+#define FS_BUF_POOL_NUM      4
+#define FS_BUF_SIZE          4096
+#define FS_BUF_RANDOM_SIZE   512
+
+typedef struct {
+    FILE *owner;    /* NULL: free */
+    char *buf;      /* allocated on first use, kept afterwards */
+} fs_buf_slot_t;
+
+#define FS_PATH_MAX          128
+#define FS_HANDLE_NUM        16
+
+/* 句柄缓存, 路径只在解析时处理一次, 之后按下标访问 */
+typedef struct {
+    uint32_t hash;      /* 0: unused */
+    mod_fs_type_t type;
+    char *path;         /* logical path */
+    char *real_path;    /* mount path + logical path, not length limited */
+    size_t size;
+    ino_t ino;
+    int fd;             /* opened on first read, -1: closed */
+    int refs;
+    bool stale;         /* written since resolved, size/ino reloaded on next open, detached if fd reads a replaced file */
+    bool detached;      /* dropped while referenced, freed on last close */
+    uint32_t last_used;
+} fs_handle_t;
+
+/**
+ * 原子写: 先写 path~ 并 fsync, 再改名为 path^ 表示已写完, 最后替换 path.
+ * LittleFS 的 rename 可以直接覆盖目标, SPIFFS/FATFS 目标存在时失败, 需要先删除目标.
+ * 掉电后 path~ 直接删除, path^ 用来替换 path. 后缀只有一个字符, SPIFFS 文件名长度有限.
+ */
+#define FS_TMP_SUFFIX        "~"
+#define FS_DONE_SUFFIX       "^"
+
+/* 流式原子写从 open 到 commit/abort 占用 path, 期间 path~ 属于它, 其他写入和恢复都不能动 */
+#define FS_ATOMIC_NUM        4
+
+typedef struct {
+    FILE *fp;           /* NULL: free */
+    mod_fs_type_t type;
+    char path[FS_PATH_MAX];
+} fs_atomic_t;
+
+/* 批量写: 同一文件在时间窗口内的多次写入只保留最后一次, 由后台任务写出 */
+#define FS_BATCH_NUM         4
+#define FS_BATCH_TASK_NAME   "mod_fs_batch"
+#define FS_BATCH_TASK_STACK  (3 * 1024)
+#define FS_BATCH_TASK_PRIORITY 2
+#define FS_BATCH_BUSY_MS     100 /* 文件正在流式原子写时推迟的时间 */
+
+typedef struct {
+    mod_fs_type_t type;
+    char *path;         /* NULL: unused */
+    void *buf;
+    size_t size;
+    int64_t deadline;   /* set by the first write, later writes don't extend it */
+} fs_batch_t;
+
+/* 目录迭代器, 一次只保存一个条目 */
+struct mod_fs_dir {
+    DIR *dp;
+    size_t base_len;        /* 目录路径加 '/' 的长度 */
+    char path[FS_PATH_MAX]; /* 目录路径, 后面接当前条目的名字 */
+};
+
+/**
+ * SPIFFS 后台垃圾回收: 写入停下一段时间后提前整理出干净的页, 写入时就不用在内部做 GC.
+ * 每次要求的干净空间是分区的 FS_GC_TARGET_PCT, 最多剩余空间的一半, 已经足够时 esp_spiffs_gc 立即返回.
+ */
+#define FS_GC_TASK_NAME      "mod_fs_gc"
+#define FS_GC_TASK_STACK     (3 * 1024)
+#define FS_GC_TASK_PRIORITY  1 /* 只比 idle 高 */
+#define FS_GC_INTERVAL_MS    1000
+#define FS_GC_QUIET_MS       2000
+#define FS_GC_TARGET_PCT     10
+#define FS_GC_RUN_MIN_US     1000 /* 比这短说明没有回收 */
+
+/**
+ * 操作统计, 按挂载点 (下标是 mod_fs_type_t) 和操作分开.
+ * 打开的 FILE 记在跟踪表里, 读写时用来找到所属挂载点, 表满时算到默认挂载点.
+ * 句柄的 fd 从句柄项得到挂载点, 不进跟踪表.
+ */
+#define FS_TYPE_NUM          (MOD_FS_WWW + 1)
+#define FS_FILE_TRACK_NUM    32
+
+typedef struct {
+    FILE *fp;           /* NULL: free */
+    mod_fs_type_t type;
+} fs_file_t;
 
 static const char *TAG = "mod_fs";
 
+/* 实际挂载的文件系统, MOD_FS_DEFAULT 表示还没有挂载 */
+static mod_fs_type_t s_fs_type = MOD_FS_DEFAULT;
+static wl_handle_t s_wl_handle = WL_INVALID_HANDLE;
+
+static fs_buf_slot_t s_buf_pool[FS_BUF_POOL_NUM];
+static portMUX_TYPE s_buf_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static fs_handle_t s_handles[FS_HANDLE_NUM];
+static uint32_t s_handle_clock = 0;
+static SemaphoreHandle_t s_handle_lock = NULL;
+static StaticSemaphore_t s_handle_lock_buf;
+
+static fs_batch_t s_batch[FS_BATCH_NUM];
+static TaskHandle_t s_batch_task = NULL;
+static SemaphoreHandle_t s_batch_lock = NULL; /* s_batch */
+static StaticSemaphore_t s_batch_lock_buf;
+static SemaphoreHandle_t s_write_lock = NULL; /* 原子写一个接一个执行, 保证写入顺序 */
+static StaticSemaphore_t s_write_lock_buf;
+static fs_atomic_t s_atomic[FS_ATOMIC_NUM]; /* s_write_lock */
+
+static int64_t s_last_write_us = 0;
+static uint32_t s_write_seq = 0;
+static mod_fs_gc_stats_t s_gc_stats = {0};
+static portMUX_TYPE s_gc_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static mod_fs_stats_t s_stats[FS_TYPE_NUM];
+static fs_file_t s_files[FS_FILE_TRACK_NUM];
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED; /* s_stats, s_files */
+
+static void priv_handle_invalidate(mod_fs_type_t type, const char *path);
+
 static const char *priv_get_subtype_str(esp_partition_subtype_t subtype)
 {
     switch (subtype) {
@@ -45,7 +196,7 @@ static int priv_spiffs_init(void)
     esp_vfs_spiffs_conf_t conf = {
         .base_path = SPIFFS_MOUNT_PATH,
         .partition_label = FS_PARTITION_NAME,
-        .max_files = 20,
+        .max_files = SPIFFS_MAX_FILES,
         .format_if_mount_failed = true,
     };
 
@@ -65,150 +216,1578 @@ static int priv_spiffs_init(void)
     return -1;
 }
 
+static int priv_littlefs_init(void)
+{
+    esp_err_t err = ESP_OK;
+
+    size_t total = 0;
+    size_t used = 0;
+
+    esp_vfs_littlefs_conf_t conf = {
+        .base_path = LITTLEFS_MOUNT_PATH,
+        .partition_label = FS_PARTITION_NAME,
+        .format_if_mount_failed = true,
+        .dont_mount = false,
+    };
+
+    err = esp_vfs_littlefs_register(&conf);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "LittleFS register failed: %s", esp_err_to_name(err));
+        return -1;
+    }
+
+    err = esp_littlefs_info(conf.partition_label, &total, &used);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "LittleFS info: total: %d, used: %d", total, used);
+        return 0;
+    }
+
+    ESP_LOGE(TAG, "LittleFS partition information get failed: %s", esp_err_to_name(err));
+    return -1;
+}
+
+static int priv_fatfs_init(void)
+{
+    esp_err_t err = ESP_OK;
+
+    uint64_t total = 0;
+    uint64_t free_bytes = 0;
+
+    esp_vfs_fat_mount_config_t conf = {
+        .format_if_mount_failed = true,
+        .max_files = FATFS_MAX_FILES,
+        .allocation_unit_size = FATFS_ALLOCATION_UNIT,
+    };
+
+    err = esp_vfs_fat_spiflash_mount_rw_wl(FATFS_MOUNT_PATH, FS_PARTITION_NAME, &conf, &s_wl_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "FATFS mount failed: %s", esp_err_to_name(err));
+        return -1;
+    }
+
+    err = esp_vfs_fat_info(FATFS_MOUNT_PATH, &total, &free_bytes);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "FATFS info: total: %lu, used: %lu, sector: %d, cluster: %d",
+                 (uint32_t)total, (uint32_t)(total - free_bytes), wl_sector_size(s_wl_handle), FATFS_ALLOCATION_UNIT);
+        return 0;
+    }
+
+    ESP_LOGE(TAG, "FATFS information get failed: %s", esp_err_to_name(err));
+    return -1;
+}
+
+mod_fs_type_t mod_fs_get_type(void)
+{
+    return s_fs_type;
+}
+
+const char *mod_fs_get_mount_path(mod_fs_type_t type)
+{
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+
+    switch (type) {
+        case MOD_FS_SPIFFS:
+            return SPIFFS_MOUNT_PATH;
+
+        case MOD_FS_LITTLEFS:
+            return LITTLEFS_MOUNT_PATH;
+
+        case MOD_FS_FATFS:
+            return FATFS_MOUNT_PATH;
+
+        case MOD_FS_WWW:
+            return mod_fs_www_get_mount_path();
+
+        default:
+            return "";
+    }
+}
+
+static void priv_stats_record(mod_fs_type_t type, mod_fs_op_t op, int64_t start, size_t bytes, bool ok)
+{
+    uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+    mod_fs_op_stats_t *stats = NULL;
+    int bucket = 0;
+
+    if ((type <= MOD_FS_DEFAULT) || (type >= FS_TYPE_NUM)) {
+        return;
+    }
+
+    while ((bucket < (MOD_FS_HIST_NUM - 1)) && (us >= ((uint32_t)MOD_FS_HIST_BASE_US << (2 * bucket)))) {
+        bucket++;
+    }
+
+    taskENTER_CRITICAL(&s_stats_lock);
+    stats = &s_stats[type].ops[op];
+    stats->count++;
+    if (!ok) {
+        stats->errors++;
+    }
+    stats->bytes += bytes;
+    stats->total_us += us;
+    if (us > stats->max_us) {
+        stats->max_us = us;
+    }
+    stats->hist[bucket]++;
+    taskEXIT_CRITICAL(&s_stats_lock);
+}
+
+/* 找到 fp 所属的挂载点, remove 时同时移出跟踪表 */
+static mod_fs_type_t priv_file_type(FILE *fp, bool remove)
+{
+    mod_fs_type_t type = s_fs_type;
+
+    taskENTER_CRITICAL(&s_stats_lock);
+    for (int i = 0; i < FS_FILE_TRACK_NUM; i++) {
+        if (s_files[i].fp == fp) {
+            type = s_files[i].type;
+            if (remove) {
+                s_files[i].fp = NULL;
+                s_stats[type].open_files--;
+            }
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&s_stats_lock);
+
+    return type;
+}
+
+static FILE *priv_fs_fopen(mod_fs_type_t type, const char *real_path, const char *mode)
+{
+    int64_t start = esp_timer_get_time();
+    FILE *fp = fopen(real_path, mode);
+
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+    priv_stats_record(type, MOD_FS_OP_OPEN, start, 0, fp != NULL);
+
+    if ((fp == NULL) || (type <= MOD_FS_DEFAULT) || (type >= FS_TYPE_NUM)) {
+        return fp;
+    }
+
+    taskENTER_CRITICAL(&s_stats_lock);
+    for (int i = 0; i < FS_FILE_TRACK_NUM; i++) {
+        if (s_files[i].fp == NULL) {
+            s_files[i].fp = fp;
+            s_files[i].type = type;
+            s_stats[type].open_files++;
+            if (s_stats[type].open_files > s_stats[type].open_files_max) {
+                s_stats[type].open_files_max = s_stats[type].open_files;
+            }
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&s_stats_lock);
+
+    return fp;
+}
+
+static int priv_fs_fclose(FILE *fp)
+{
+    /* 先移出跟踪表, 关闭后 fp 的值可能马上被其他任务的 fopen 复用 */
+    mod_fs_type_t type = priv_file_type(fp, true);
+    int64_t start = esp_timer_get_time();
+    int ret = fclose(fp);
+
+    priv_stats_record(type, MOD_FS_OP_CLOSE, start, 0, ret == 0);
+
+    return ret;
+}
+
+/* 句柄用的 fd, 挂载点已知, 不进跟踪表, 和 FILE 一样计入打开文件数 */
+static int priv_fs_open_fd(mod_fs_type_t type, const char *real_path)
+{
+    int64_t start = esp_timer_get_time();
+    int fd = open(real_path, O_RDONLY);
+
+    priv_stats_record(type, MOD_FS_OP_OPEN, start, 0, fd >= 0);
+
+    if ((fd >= 0) && (type > MOD_FS_DEFAULT) && (type < FS_TYPE_NUM)) {
+        taskENTER_CRITICAL(&s_stats_lock);
+        s_stats[type].open_files++;
+        if (s_stats[type].open_files > s_stats[type].open_files_max) {
+            s_stats[type].open_files_max = s_stats[type].open_files;
+        }
+        taskEXIT_CRITICAL(&s_stats_lock);
+    }
+
+    return fd;
+}
+
+static void priv_fs_close_fd(mod_fs_type_t type, int fd)
+{
+    int64_t start = esp_timer_get_time();
+    int ret = close(fd);
+
+    if ((type > MOD_FS_DEFAULT) && (type < FS_TYPE_NUM)) {
+        taskENTER_CRITICAL(&s_stats_lock);
+        s_stats[type].open_files--;
+        taskEXIT_CRITICAL(&s_stats_lock);
+    }
+    priv_stats_record(type, MOD_FS_OP_CLOSE, start, 0, ret == 0);
+}
+
+/* 记录写入活动, 后台 GC 只在写入停下后运行 */
+static void priv_fs_touch(void)
+{
+    taskENTER_CRITICAL(&s_gc_lock);
+    s_last_write_us = esp_timer_get_time();
+    s_write_seq++;
+    taskEXIT_CRITICAL(&s_gc_lock);
+}
+
 FILE *mod_fs_open(mod_fs_type_t type, const char *path, const char *mode)
 {
-    char real_path[128] = {0};
+    char real_path[FS_PATH_MAX] = {0};
 
     if ((path == NULL) || (mode == NULL)) {
         return NULL;
     }
 
-    if (type == MOD_FS_SPIFFS) {
-        snprintf(real_path, sizeof(real_path) / sizeof(real_path[0]), "%s%s", SPIFFS_MOUNT_PATH, path);
-    } else {
-        snprintf(real_path, sizeof(real_path) / sizeof(real_path[0]), "%s", path);
+    if (snprintf(real_path, sizeof(real_path) / sizeof(real_path[0]), "%s%s", mod_fs_get_mount_path(type), path) >=
+        sizeof(real_path)) {
+        ESP_LOGE(TAG, "path too long: %s", path);
+        return NULL;
+    }
+
+    /* 写打开会改变大小, 缓存的句柄信息作废 */
+    if ((mode[0] != 'r') || (strchr(mode, '+') != NULL)) {
+        priv_handle_invalidate(type, path);
+        priv_fs_touch();
+    }
+
+    return priv_fs_fopen(type, real_path, mode);
+}
+
+static char *priv_buf_acquire(FILE *fp)
+{
+    fs_buf_slot_t *slot = NULL;
+
+    taskENTER_CRITICAL(&s_buf_lock);
+    for (int i = 0; i < FS_BUF_POOL_NUM; i++) {
+        if (s_buf_pool[i].owner == NULL) {
+            slot = &s_buf_pool[i];
+            slot->owner = fp;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&s_buf_lock);
+
+    if (slot == NULL) {
+        return NULL;
+    }
+
+    /* 槽位已被占用, 在临界区外分配 */
+    if (slot->buf == NULL) {
+        slot->buf = (char *)mod_mem_malloc(FS_BUF_SIZE, MOD_MEM_DEFAULT);
+        if (slot->buf == NULL) {
+            slot->owner = NULL;
+            return NULL;
+        }
+    }
+
+    return slot->buf;
+}
+
+static fs_buf_slot_t *priv_buf_find(FILE *fp)
+{
+    fs_buf_slot_t *slot = NULL;
+
+    taskENTER_CRITICAL(&s_buf_lock);
+    for (int i = 0; i < FS_BUF_POOL_NUM; i++) {
+        if (s_buf_pool[i].owner == fp) {
+            slot = &s_buf_pool[i];
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&s_buf_lock);
+
+    return slot;
+}
+
+static void priv_buf_release(fs_buf_slot_t *slot)
+{
+    if (slot == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&s_buf_lock);
+    slot->owner = NULL;
+    taskEXIT_CRITICAL(&s_buf_lock);
+}
+
+FILE *mod_fs_open_ex(mod_fs_type_t type, const char *path, const char *mode, mod_fs_hint_t hint)
+{
+    FILE *fp = NULL;
+    char *buf = NULL;
+
+    fp = mod_fs_open(type, path, mode);
+    if ((fp == NULL) || (hint == MOD_FS_HINT_DEFAULT)) {
+        return fp;
+    }
+
+    /* 池用完时保持 stdio 默认缓冲 */
+    buf = priv_buf_acquire(fp);
+    if (buf == NULL) {
+        ESP_LOGD(TAG, "buffer pool exhausted, %s keeps default buffering", path);
+        return fp;
     }
 
-    return fopen(real_path, mode);
+    if (setvbuf(fp, buf, _IOFBF, (hint == MOD_FS_HINT_RANDOM) ? FS_BUF_RANDOM_SIZE : FS_BUF_SIZE) != 0) {
+        priv_buf_release(priv_buf_find(fp));
+    }
+
+    return fp;
 }
 
 void mod_fs_close(FILE *fp)
 {
+    fs_buf_slot_t *slot = NULL;
+
     if (fp == NULL) {
         return;
     }
 
-    fclose(fp);
+    /**
+     * fclose 还会用缓冲区刷写, 之后才能归还.
+     * 先找到槽位, 关闭后 fp 的值可能马上被其他任务的 fopen 复用.
+     */
+    slot = priv_buf_find(fp);
+    priv_fs_fclose(fp);
+    priv_buf_release(slot);
 }
 
 size_t mod_fs_read(FILE *fp, void *buf, size_t size)
 {
+    int64_t start = 0;
+    size_t len = 0;
+
     if ((fp == NULL) || (buf == NULL) || (size == 0)) {
         return 0;
     }
 
-    return fread(buf, 1, size, fp);
+    start = esp_timer_get_time();
+    len = fread(buf, 1, size, fp);
+    priv_stats_record(priv_file_type(fp, false), MOD_FS_OP_READ, start, len, (len == size) || !ferror(fp));
+
+    return len;
 }
 
 size_t mod_fs_write(FILE *fp, const void *buf, size_t size)
 {
+    int64_t start = 0;
+    size_t len = 0;
+
     if ((fp == NULL) || (buf == NULL) || (size == 0)) {
         return 0;
     }
 
-    return fwrite(buf, 1, size, fp);
+    priv_fs_touch();
+
+    start = esp_timer_get_time();
+    len = fwrite(buf, 1, size, fp);
+    priv_stats_record(priv_file_type(fp, false), MOD_FS_OP_WRITE, start, len, len == size);
+
+    return len;
 }
 
-void *mod_fs_file_read(mod_fs_type_t type, const char *path)
+static int priv_atomic_path(mod_fs_type_t type, const char *path, const char *suffix, char *buf, size_t size)
 {
-    FILE *fp = NULL;
+    if (snprintf(buf, size, "%s%s%s", mod_fs_get_mount_path(type), path, suffix) >= size) {
+        ESP_LOGE(TAG, "path too long: %s", path);
+        return -1;
+    }
 
-    char *buf = NULL;
-    size_t size = 0;
+    return 0;
+}
 
-    if (path == NULL) {
-        return NULL;
+/* 查找正在进行的流式原子写, 调用者持有 s_write_lock */
+static fs_atomic_t *priv_atomic_find(mod_fs_type_t type, const char *path)
+{
+    for (int i = 0; i < FS_ATOMIC_NUM; i++) {
+        if ((s_atomic[i].fp != NULL) && (s_atomic[i].type == type) && (strcmp(s_atomic[i].path, path) == 0)) {
+            return &s_atomic[i];
+        }
     }
 
-    fp = mod_fs_open(type, path, "r");
-    if (fp == NULL) {
-        return NULL;
+    return NULL;
+}
+
+/* 释放 fp 占用的 path, 调用者持有 s_write_lock */
+static void priv_atomic_release(FILE *fp)
+{
+    for (int i = 0; i < FS_ATOMIC_NUM; i++) {
+        if (s_atomic[i].fp == fp) {
+            memset(&s_atomic[i], 0, sizeof(fs_atomic_t));
+            return;
+        }
     }
+}
 
-    fseek(fp, 0, SEEK_END);
-    size = ftell(fp);
+/* 处理上次原子写中断留下的文件, 调用者持有 s_write_lock */
+static void priv_atomic_recover(mod_fs_type_t type, const char *path)
+{
+    char real_path[FS_PATH_MAX];
+    char tmp_path[FS_PATH_MAX];
+    struct stat st;
 
-    buf = (char *)malloc(size + 1);
-    if (buf == NULL) {
-        mod_fs_close(fp);
-        return NULL;
+    /* path~ 是正在进行的流式原子写 */
+    if (priv_atomic_find(type, path) != NULL) {
+        return;
     }
 
-    fseek(fp, 0, SEEK_SET);
-    fread(buf, 1, size, fp);
-    buf[size] = '\0';
-    mod_fs_close(fp);
+    if (priv_atomic_path(type, path, "", real_path, sizeof(real_path)) != 0) {
+        return;
+    }
 
-    return buf;
+    /* 没写完的临时文件, 原文件完好 */
+    if ((priv_atomic_path(type, path, FS_TMP_SUFFIX, tmp_path, sizeof(tmp_path)) == 0) && (stat(tmp_path, &st) == 0)) {
+        remove(tmp_path);
+    }
+
+    /* 已写完但没来得及替换 */
+    if ((priv_atomic_path(type, path, FS_DONE_SUFFIX, tmp_path, sizeof(tmp_path)) == 0) && (stat(tmp_path, &st) == 0)) {
+        ESP_LOGW(TAG, "recover %s", path);
+        remove(real_path);
+        rename(tmp_path, real_path);
+        priv_handle_invalidate(type, path);
+    }
 }
 
-int mod_fs_file_write(mod_fs_type_t type, const char *path, const void *buf, size_t size)
+/* 打开临时文件, 调用者持有 s_write_lock */
+static FILE *priv_atomic_open(mod_fs_type_t type, const char *path)
 {
+    char tmp_path[FS_PATH_MAX];
     FILE *fp = NULL;
-    size_t write_len = 0;
 
-    if ((path == NULL) || (buf == NULL) || (size == 0)) {
-        return -1;
+    if (priv_atomic_path(type, path, FS_TMP_SUFFIX, tmp_path, sizeof(tmp_path)) != 0) {
+        return NULL;
     }
 
-    fp = mod_fs_open(type, path, "w");
+    priv_atomic_recover(type, path);
+    priv_fs_touch();
+
+    fp = priv_fs_fopen(type, tmp_path, "w");
     if (fp == NULL) {
-        return -1;
+        ESP_LOGE(TAG, "open %s failed", tmp_path);
     }
 
-    write_len = fwrite(buf, 1, size, fp);
-    mod_fs_close(fp);
-
-    return write_len;
+    return fp;
 }
 
-void mod_fs_buf_free(void *buf)
+/* 临时文件落盘后替换 path, fp 总是被关闭, 调用者持有 s_write_lock */
+static int priv_atomic_commit(mod_fs_type_t type, const char *path, FILE *fp)
 {
-    if (buf == NULL) {
-        return;
+    char real_path[FS_PATH_MAX];
+    char tmp_path[FS_PATH_MAX];
+    char done_path[FS_PATH_MAX];
+
+    if ((priv_atomic_path(type, path, "", real_path, sizeof(real_path)) != 0) ||
+        (priv_atomic_path(type, path, FS_TMP_SUFFIX, tmp_path, sizeof(tmp_path)) != 0) ||
+        (priv_atomic_path(type, path, FS_DONE_SUFFIX, done_path, sizeof(done_path)) != 0)) {
+        priv_fs_fclose(fp);
+        return -1;
+    }
+
+    priv_fs_touch();
+
+    if ((fflush(fp) != 0) || (fsync(fileno(fp)) != 0)) {
+        ESP_LOGE(TAG, "write %s failed", tmp_path);
+        priv_fs_fclose(fp);
+        remove(tmp_path);
+        return -1;
+    }
+    priv_fs_fclose(fp);
+
+    priv_handle_invalidate(type, path);
+
+    if (rename(tmp_path, real_path) == 0) {
+        return 0;
+    }
+
+    if (rename(tmp_path, done_path) != 0) {
+        ESP_LOGE(TAG, "rename %s failed", tmp_path);
+        remove(tmp_path);
+        return -1;
+    }
+
+    remove(real_path);
+    if (rename(done_path, real_path) != 0) {
+        /* path^ 留给下次恢复 */
+        ESP_LOGE(TAG, "rename %s failed", done_path);
+        return -1;
     }
 
-    free(buf);
+    return 0;
 }
 
-int mod_fs_init(mod_fs_type_t type)
+/* 调用者持有 s_write_lock */
+static int priv_atomic_write(mod_fs_type_t type, const char *path, const void *buf, size_t size)
 {
-    esp_partition_t *part = NULL;
+    char tmp_path[FS_PATH_MAX];
+    FILE *fp = NULL;
 
-    part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, FS_PARTITION_NAME);
-    if (part == NULL) {
-        ESP_LOGE(TAG, "Partition %s not found", FS_PARTITION_NAME);
+    fp = priv_atomic_open(type, path);
+    if (fp == NULL) {
         return -1;
     }
-    ESP_LOGI(TAG, "Partition %s - %s", FS_PARTITION_NAME, priv_get_subtype_str(part->subtype));
 
-    switch (type) {
-        case MOD_FS_SPIFFS:
-            if (part->subtype != ESP_PARTITION_SUBTYPE_DATA_SPIFFS) {
+    if (mod_fs_write(fp, buf, size) != size) {
+        ESP_LOGE(TAG, "write %s failed", path);
+        priv_fs_fclose(fp);
+        if (priv_atomic_path(type, path, FS_TMP_SUFFIX, tmp_path, sizeof(tmp_path)) == 0) {
+            remove(tmp_path);
+        }
+        return -1;
+    }
+
+    return priv_atomic_commit(type, path, fp);
+}
+
+/* 取出批量写中 path 的数据, 调用者持有 s_batch_lock */
+static fs_batch_t *priv_batch_find(mod_fs_type_t type, const char *path)
+{
+    for (int i = 0; i < FS_BATCH_NUM; i++) {
+        if ((s_batch[i].path != NULL) && (s_batch[i].type == type) && (strcmp(s_batch[i].path, path) == 0)) {
+            return &s_batch[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void priv_batch_free(fs_batch_t *batch)
+{
+    mod_mem_free(batch->path);
+    mod_mem_free(batch->buf);
+    memset(batch, 0, sizeof(fs_batch_t));
+}
+
+/* 新的写入比还没写出的批量写新, 丢弃批量写 */
+static void priv_batch_drop(mod_fs_type_t type, const char *path)
+{
+    fs_batch_t *batch = NULL;
+
+    xSemaphoreTake(s_batch_lock, portMAX_DELAY);
+    batch = priv_batch_find(type, path);
+    if (batch != NULL) {
+        priv_batch_free(batch);
+    }
+    xSemaphoreGive(s_batch_lock);
+}
+
+/**
+ * @brief 写出到期的批量写
+ * @param all 忽略截止时间全部写出
+ * @return
+ *  - 最近一个还没到期的截止时间, 0: 没有待写数据
+ */
+static int64_t priv_batch_flush(bool all)
+{
+    fs_batch_t batch;
+    int64_t next = 0;
+
+    xSemaphoreTake(s_write_lock, portMAX_DELAY);
+
+    for (int i = 0; i < FS_BATCH_NUM; i++) {
+        xSemaphoreTake(s_batch_lock, portMAX_DELAY);
+        if ((s_batch[i].path == NULL) || (!all && (s_batch[i].deadline > esp_timer_get_time()))) {
+            if ((s_batch[i].path != NULL) && ((next == 0) || (s_batch[i].deadline < next))) {
+                next = s_batch[i].deadline;
+            }
+            xSemaphoreGive(s_batch_lock);
+            continue;
+        }
+        /* 流式原子写还没结束, 推迟到它提交或放弃之后, 提交时会丢弃这份旧数据 */
+        if (priv_atomic_find(s_batch[i].type, s_batch[i].path) != NULL) {
+            s_batch[i].deadline = esp_timer_get_time() + FS_BATCH_BUSY_MS * 1000;
+            if ((next == 0) || (s_batch[i].deadline < next)) {
+                next = s_batch[i].deadline;
+            }
+            xSemaphoreGive(s_batch_lock);
+            continue;
+        }
+        /* 取出后写入期间不占用 s_batch_lock, 新的写入进入新的批次 */
+        batch = s_batch[i];
+        memset(&s_batch[i], 0, sizeof(fs_batch_t));
+        xSemaphoreGive(s_batch_lock);
+
+        if (priv_atomic_write(batch.type, batch.path, batch.buf, batch.size) != 0) {
+            ESP_LOGE(TAG, "batch write %s failed", batch.path);
+        }
+        priv_batch_free(&batch);
+    }
+
+    xSemaphoreGive(s_write_lock);
+
+    return next;
+}
+
+static void priv_batch_task(void *arg)
+{
+    TickType_t wait = portMAX_DELAY;
+    int64_t next = 0;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        next = priv_batch_flush(false);
+        if (next == 0) {
+            wait = portMAX_DELAY;
+        } else {
+            next -= esp_timer_get_time();
+            wait = (next > 0) ? pdMS_TO_TICKS((next + 999) / 1000) : 0;
+        }
+    }
+}
+
+void *mod_fs_file_read(mod_fs_type_t type, const char *path)
+{
+    fs_batch_t *batch = NULL;
+    FILE *fp = NULL;
+
+    char *buf = NULL;
+    size_t size = 0;
+
+    if (path == NULL) {
+        return NULL;
+    }
+
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+
+    /* 还在批量写中的数据比文件新 */
+    if (s_batch_lock != NULL) {
+        xSemaphoreTake(s_batch_lock, portMAX_DELAY);
+        batch = priv_batch_find(type, path);
+        if (batch != NULL) {
+            buf = (char *)mod_mem_malloc(batch->size + 1, MOD_MEM_BULK);
+            if (buf != NULL) {
+                memcpy(buf, batch->buf, batch->size);
+                buf[batch->size] = '\0';
+            }
+        }
+        xSemaphoreGive(s_batch_lock);
+        if (batch != NULL) {
+            return buf;
+        }
+    }
+
+    fp = mod_fs_open(type, path, "r");
+    if ((fp == NULL) && (s_write_lock != NULL)) {
+        /* 可能是原子写替换时掉电 */
+        xSemaphoreTake(s_write_lock, portMAX_DELAY);
+        priv_atomic_recover(type, path);
+        xSemaphoreGive(s_write_lock);
+        fp = mod_fs_open(type, path, "r");
+    }
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+
+    buf = (char *)mod_mem_malloc(size + 1, MOD_MEM_BULK);
+    if (buf == NULL) {
+        mod_fs_close(fp);
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_SET);
+    mod_fs_read(fp, buf, size);
+    buf[size] = '\0';
+    mod_fs_close(fp);
+
+    return buf;
+}
+
+int mod_fs_file_write(mod_fs_type_t type, const char *path, const void *buf, size_t size)
+{
+    int ret = -1;
+
+    if ((path == NULL) || (buf == NULL) || (size == 0) || (s_write_lock == NULL)) {
+        return -1;
+    }
+
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+
+    xSemaphoreTake(s_write_lock, portMAX_DELAY);
+    if (priv_atomic_find(type, path) != NULL) {
+        ESP_LOGE(TAG, "%s is being replaced", path);
+    } else {
+        priv_batch_drop(type, path);
+        ret = priv_atomic_write(type, path, buf, size);
+    }
+    xSemaphoreGive(s_write_lock);
+
+    return ret;
+}
+
+FILE *mod_fs_atomic_open(mod_fs_type_t type, const char *path)
+{
+    fs_atomic_t *atomic = NULL;
+    FILE *fp = NULL;
+
+    if ((path == NULL) || (s_write_lock == NULL)) {
+        return NULL;
+    }
+
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+
+    xSemaphoreTake(s_write_lock, portMAX_DELAY);
+
+    if (priv_atomic_find(type, path) != NULL) {
+        ESP_LOGE(TAG, "%s is being replaced", path);
+        goto exit;
+    }
+    for (int i = 0; (atomic == NULL) && (i < FS_ATOMIC_NUM); i++) {
+        if (s_atomic[i].fp == NULL) {
+            atomic = &s_atomic[i];
+        }
+    }
+    if (atomic == NULL) {
+        ESP_LOGE(TAG, "too many atomic writes");
+        goto exit;
+    }
+
+    /* 打开成功说明挂载路径加 path 放得下 FS_PATH_MAX */
+    fp = priv_atomic_open(type, path);
+    if (fp != NULL) {
+        atomic->fp = fp;
+        atomic->type = type;
+        strcpy(atomic->path, path);
+    }
+
+exit:
+    xSemaphoreGive(s_write_lock);
+
+    return fp;
+}
+
+int mod_fs_atomic_commit(mod_fs_type_t type, const char *path, FILE *fp)
+{
+    int ret = -1;
+
+    if ((path == NULL) || (fp == NULL) || (s_write_lock == NULL)) {
+        return -1;
+    }
+
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+
+    xSemaphoreTake(s_write_lock, portMAX_DELAY);
+    priv_atomic_release(fp);
+    priv_batch_drop(type, path);
+    ret = priv_atomic_commit(type, path, fp);
+    xSemaphoreGive(s_write_lock);
+
+    return ret;
+}
+
+void mod_fs_atomic_abort(mod_fs_type_t type, const char *path, FILE *fp)
+{
+    char tmp_path[FS_PATH_MAX];
+
+    if ((path == NULL) || (fp == NULL)) {
+        return;
+    }
+
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+
+    if (s_write_lock != NULL) {
+        xSemaphoreTake(s_write_lock, portMAX_DELAY);
+    }
+    priv_atomic_release(fp);
+    priv_fs_fclose(fp);
+    if (priv_atomic_path(type, path, FS_TMP_SUFFIX, tmp_path, sizeof(tmp_path)) == 0) {
+        remove(tmp_path);
+    }
+    if (s_write_lock != NULL) {
+        xSemaphoreGive(s_write_lock);
+    }
+}
+
+int mod_fs_file_write_batch(mod_fs_type_t type, const char *path, const void *buf, size_t size, uint32_t window_ms)
+{
+    fs_batch_t *batch = NULL;
+    char *path_copy = NULL;
+    void *buf_copy = NULL;
+    int ret = -1;
+
+    if ((path == NULL) || (buf == NULL) || (size == 0) || (s_batch_lock == NULL)) {
+        return -1;
+    }
+
+    if (window_ms == 0) {
+        return mod_fs_file_write(type, path, buf, size);
+    }
+
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+
+    /* 在锁外分配 */
+    path_copy = (char *)mod_mem_malloc(strlen(path) + 1, MOD_MEM_DEFAULT);
+    buf_copy = mod_mem_malloc(size, MOD_MEM_BULK);
+    if ((path_copy == NULL) || (buf_copy == NULL)) {
+        ESP_LOGE(TAG, "malloc failed");
+        goto exit;
+    }
+    strcpy(path_copy, path);
+    memcpy(buf_copy, buf, size);
+
+    xSemaphoreTake(s_batch_lock, portMAX_DELAY);
+
+    if (s_batch_task == NULL) {
+        if (xTaskCreate(priv_batch_task, FS_BATCH_TASK_NAME, FS_BATCH_TASK_STACK, NULL, FS_BATCH_TASK_PRIORITY,
+                        &s_batch_task) != pdPASS) {
+            s_batch_task = NULL;
+            xSemaphoreGive(s_batch_lock);
+            ESP_LOGE(TAG, "task create failed");
+            goto exit;
+        }
+    }
+
+    batch = priv_batch_find(type, path);
+    if (batch != NULL) {
+        /* 只保留最后一次写入 */
+        mod_mem_free(batch->buf);
+        batch->buf = buf_copy;
+        batch->size = size;
+        buf_copy = NULL;
+    } else {
+        for (int i = 0; i < FS_BATCH_NUM; i++) {
+            if (s_batch[i].path == NULL) {
+                batch = &s_batch[i];
+                break;
+            }
+        }
+        if (batch != NULL) {
+            batch->type = type;
+            batch->path = path_copy;
+            batch->buf = buf_copy;
+            batch->size = size;
+            batch->deadline = esp_timer_get_time() + (int64_t)window_ms * 1000;
+            path_copy = NULL;
+            buf_copy = NULL;
+        }
+    }
+
+    xSemaphoreGive(s_batch_lock);
+
+    if (batch == NULL) {
+        /* 批次已满, 直接写 */
+        ret = mod_fs_file_write(type, path, buf, size);
+        goto exit;
+    }
+
+    xTaskNotifyGive(s_batch_task);
+    ret = 0;
+
+exit:
+    mod_mem_free(path_copy);
+    mod_mem_free(buf_copy);
+
+    return ret;
+}
+
+void mod_fs_file_flush(void)
+{
+    if (s_write_lock == NULL) {
+        return;
+    }
+
+    priv_batch_flush(true);
+}
+
+void mod_fs_buf_free(void *buf)
+{
+    if (buf == NULL) {
+        return;
+    }
+
+    mod_mem_free(buf);
+}
+
+static uint32_t priv_path_hash(mod_fs_type_t type, const char *path)
+{
+    uint32_t hash = 2166136261UL ^ (uint32_t)type;
+
+    while (*path != '\0') {
+        hash = (hash ^ (uint8_t)*path++) * 16777619UL;
+    }
+
+    return (hash != 0) ? hash : 1;
+}
+
+/* 调用者持有 s_handle_lock */
+static fs_handle_t *priv_handle_find(uint32_t hash, mod_fs_type_t type, const char *path)
+{
+    for (int i = 0; i < FS_HANDLE_NUM; i++) {
+        if ((s_handles[i].hash == hash) && (s_handles[i].type == type) && !s_handles[i].detached &&
+            (strcmp(s_handles[i].path, path) == 0)) {
+            return &s_handles[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void priv_handle_free(fs_handle_t *handle)
+{
+    mod_mem_free(handle->path);
+    mod_mem_free(handle->real_path);
+    memset(handle, 0, sizeof(fs_handle_t));
+    handle->fd = -1;
+}
+
+static int priv_handle_load(fs_handle_t *handle)
+{
+    struct stat st;
+
+    if (stat(handle->real_path, &st) != 0) {
+        return -1;
+    }
+
+    handle->size = st.st_size;
+    handle->ino = st.st_ino;
+    handle->stale = false;
+
+    return 0;
+}
+
+/* 已打开的 fd 和路径是否还是同一个文件, 原子替换或删除后 fd 还在读旧文件.
+ * 不是每个文件系统都有 inode 号, 再比较一次大小, 读不到状态也按已替换处理 */
+static bool priv_handle_replaced(const fs_handle_t *handle)
+{
+    struct stat st;
+    struct stat fd_st;
+
+    if ((stat(handle->real_path, &st) != 0) || (fstat(handle->fd, &fd_st) != 0)) {
+        return true;
+    }
+
+    return (st.st_ino != fd_st.st_ino) || (st.st_size != fd_st.st_size);
+}
+
+static void priv_handle_invalidate(mod_fs_type_t type, const char *path)
+{
+    fs_handle_t *handle = NULL;
+
+    if (s_handle_lock == NULL) {
+        return;
+    }
+
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+
+    xSemaphoreTake(s_handle_lock, portMAX_DELAY);
+    handle = priv_handle_find(priv_path_hash(type, path), type, path);
+    if (handle != NULL) {
+        handle->stale = true;
+    }
+    xSemaphoreGive(s_handle_lock);
+}
+
+mod_fs_handle_t mod_fs_handle_open(mod_fs_type_t type, const char *path)
+{
+    fs_handle_t *handle = NULL;
+    const char *mount = NULL;
+    size_t mount_len = 0;
+    size_t path_len = 0;
+    uint32_t hash = 0;
+    mod_fs_handle_t id = MOD_FS_HANDLE_INVALID;
+
+    if ((path == NULL) || (s_handle_lock == NULL)) {
+        return MOD_FS_HANDLE_INVALID;
+    }
+
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+    hash = priv_path_hash(type, path);
+
+    xSemaphoreTake(s_handle_lock, portMAX_DELAY);
+
+    handle = priv_handle_find(hash, type, path);
+    if ((handle != NULL) && handle->stale && (handle->fd >= 0) && priv_handle_replaced(handle)) {
+        /* 旧项的大小和 fd 都描述旧文件, 留给现有的引用, 新的打开另建一项 */
+        handle->detached = true;
+        handle->stale = false;
+        handle = NULL;
+    }
+    if (handle == NULL) {
+        /* 空闲项, 否则淘汰最久未用且没有引用的项 */
+        for (int i = 0; i < FS_HANDLE_NUM; i++) {
+            if (s_handles[i].hash == 0) {
+                handle = &s_handles[i];
+                break;
+            }
+            if ((s_handles[i].refs == 0) && ((handle == NULL) || (s_handles[i].last_used < handle->last_used))) {
+                handle = &s_handles[i];
+            }
+        }
+        if (handle == NULL) {
+            ESP_LOGE(TAG, "handle table full");
+            goto exit;
+        }
+        if (handle->hash != 0) {
+            if (handle->fd >= 0) {
+                priv_fs_close_fd(handle->type, handle->fd);
+            }
+            priv_handle_free(handle);
+        }
+
+        mount = mod_fs_get_mount_path(type);
+        mount_len = strlen(mount);
+        path_len = strlen(path);
+        handle->path = (char *)mod_mem_malloc(path_len + 1, MOD_MEM_DEFAULT);
+        handle->real_path = (char *)mod_mem_malloc(mount_len + path_len + 1, MOD_MEM_DEFAULT);
+        if ((handle->path == NULL) || (handle->real_path == NULL)) {
+            ESP_LOGE(TAG, "malloc failed");
+            priv_handle_free(handle);
+            goto exit;
+        }
+        memcpy(handle->path, path, path_len + 1);
+        memcpy(handle->real_path, mount, mount_len);
+        memcpy(handle->real_path + mount_len, path, path_len + 1);
+        handle->hash = hash;
+        handle->type = type;
+        handle->fd = -1;
+        handle->stale = true;
+    }
+
+    if (handle->stale && (priv_handle_load(handle) != 0)) {
+        /* 文件不存在 */
+        if (handle->refs == 0) {
+            priv_handle_free(handle);
+        }
+        goto exit;
+    }
+
+    handle->refs++;
+    handle->last_used = ++s_handle_clock;
+    id = handle - s_handles;
+
+exit:
+    xSemaphoreGive(s_handle_lock);
+
+    return id;
+}
+
+/* 校验句柄并返回表项, 调用者持有 s_handle_lock */
+static fs_handle_t *priv_handle_get(mod_fs_handle_t id)
+{
+    if ((id < 0) || (id >= FS_HANDLE_NUM) || (s_handles[id].hash == 0) || (s_handles[id].refs == 0)) {
+        return NULL;
+    }
+
+    return &s_handles[id];
+}
+
+int mod_fs_handle_info(mod_fs_handle_t id, mod_fs_handle_info_t *info)
+{
+    fs_handle_t *handle = NULL;
+    int ret = -1;
+
+    if ((info == NULL) || (s_handle_lock == NULL)) {
+        return -1;
+    }
+
+    xSemaphoreTake(s_handle_lock, portMAX_DELAY);
+    handle = priv_handle_get(id);
+    if ((handle != NULL) && handle->stale && (handle->fd >= 0) && priv_handle_replaced(handle)) {
+        /* fd 还在读旧文件, 返回旧文件的信息, 路径的新文件由下一次打开另建一项 */
+        handle->detached = true;
+        handle->stale = false;
+    }
+    if ((handle != NULL) && (!handle->stale || (priv_handle_load(handle) == 0))) {
+        info->type = handle->type;
+        info->size = handle->size;
+        info->ino = handle->ino;
+        ret = 0;
+    }
+    xSemaphoreGive(s_handle_lock);
+
+    return ret;
+}
+
+int mod_fs_pread(mod_fs_handle_t id, void *buf, size_t size, size_t offset)
+{
+    mod_fs_type_t type = MOD_FS_DEFAULT;
+    fs_handle_t *handle = NULL;
+    int64_t start = 0;
+    ssize_t len = -1;
+    int fd = -1;
+
+    if ((buf == NULL) || (s_handle_lock == NULL)) {
+        return -1;
+    }
+
+    xSemaphoreTake(s_handle_lock, portMAX_DELAY);
+    handle = priv_handle_get(id);
+    if (handle != NULL) {
+        if (handle->fd < 0) {
+            handle->fd = priv_fs_open_fd(handle->type, handle->real_path);
+        }
+        fd = handle->fd;
+        type = handle->type;
+    }
+    xSemaphoreGive(s_handle_lock);
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    /* 调用者持有引用, fd 在读取期间不会被关闭 */
+    start = esp_timer_get_time();
+    len = pread(fd, buf, size, offset);
+    if ((len < 0) && (errno == ENOSYS)) {
+        /* 文件系统没有实现 pread, 加锁 lseek + read, 防止其他读者改变位置 */
+        xSemaphoreTake(s_handle_lock, portMAX_DELAY);
+        if (lseek(fd, offset, SEEK_SET) >= 0) {
+            len = read(fd, buf, size);
+        }
+        xSemaphoreGive(s_handle_lock);
+    }
+    priv_stats_record(type, MOD_FS_OP_READ, start, (len > 0) ? len : 0, len >= 0);
+
+    return (len < 0) ? -1 : (int)len;
+}
+
+void mod_fs_handle_close(mod_fs_handle_t id)
+{
+    fs_handle_t *handle = NULL;
+
+    if (s_handle_lock == NULL) {
+        return;
+    }
+
+    /* 没有引用后关闭 fd, 路径和大小留在缓存里, 再次打开不需要处理路径 */
+    xSemaphoreTake(s_handle_lock, portMAX_DELAY);
+    handle = priv_handle_get(id);
+    if (handle != NULL) {
+        handle->refs--;
+        if ((handle->refs == 0) && (handle->fd >= 0)) {
+            priv_fs_close_fd(handle->type, handle->fd);
+            handle->fd = -1;
+        }
+        if ((handle->refs == 0) && handle->detached) {
+            priv_handle_free(handle);
+        }
+    }
+    xSemaphoreGive(s_handle_lock);
+}
+
+void mod_fs_handle_drop(mod_fs_type_t type)
+{
+    if (s_handle_lock == NULL) {
+        return;
+    }
+
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+
+    /* 有引用的项保留到最后一次关闭, 已打开的 fd 继续读旧文件 */
+    xSemaphoreTake(s_handle_lock, portMAX_DELAY);
+    for (int i = 0; i < FS_HANDLE_NUM; i++) {
+        if ((s_handles[i].hash == 0) || (s_handles[i].type != type)) {
+            continue;
+        }
+        if (s_handles[i].refs > 0) {
+            s_handles[i].detached = true;
+            continue;
+        }
+        if (s_handles[i].fd >= 0) {
+            priv_fs_close_fd(s_handles[i].type, s_handles[i].fd);
+        }
+        priv_handle_free(&s_handles[i]);
+    }
+    xSemaphoreGive(s_handle_lock);
+}
+
+mod_fs_dir_t *mod_fs_dir_open(mod_fs_type_t type, const char *path)
+{
+    mod_fs_dir_t *dir = NULL;
+    int len = 0;
+
+    if (path == NULL) {
+        return NULL;
+    }
+
+    dir = (mod_fs_dir_t *)mod_mem_calloc(1, sizeof(mod_fs_dir_t), MOD_MEM_DEFAULT);
+    if (dir == NULL) {
+        ESP_LOGE(TAG, "malloc failed");
+        return NULL;
+    }
+
+    len = snprintf(dir->path, sizeof(dir->path), "%s%s", mod_fs_get_mount_path(type), path);
+    if (len >= (sizeof(dir->path) - 1)) {
+        ESP_LOGE(TAG, "path too long: %s", path);
+        goto fail;
+    }
+    while ((len > 1) && (dir->path[len - 1] == '/')) {
+        dir->path[--len] = '\0';
+    }
+
+    dir->dp = opendir(dir->path);
+    if (dir->dp == NULL) {
+        goto fail;
+    }
+    dir->path[len] = '/';
+    dir->base_len = len + 1;
+
+    return dir;
+
+fail:
+    mod_mem_free(dir);
+
+    return NULL;
+}
+
+int mod_fs_dir_next(mod_fs_dir_t *dir, mod_fs_entry_t *entry)
+{
+    struct dirent *de = NULL;
+    struct stat st;
+    size_t len = 0;
+
+    if ((dir == NULL) || (entry == NULL)) {
+        return -1;
+    }
+
+    while ((de = readdir(dir->dp)) != NULL) {
+        len = strlen(de->d_name);
+        if ((strcmp(de->d_name, ".") == 0) || (strcmp(de->d_name, "..") == 0)) {
+            continue;
+        }
+        /* 原子写的临时文件 */
+        if ((len > 0) && ((de->d_name[len - 1] == FS_TMP_SUFFIX[0]) || (de->d_name[len - 1] == FS_DONE_SUFFIX[0]))) {
+            continue;
+        }
+        if ((dir->base_len + len) >= sizeof(dir->path)) {
+            ESP_LOGW(TAG, "name too long: %s", de->d_name);
+            continue;
+        }
+
+        memcpy(dir->path + dir->base_len, de->d_name, len + 1);
+        entry->name = dir->path + dir->base_len;
+        entry->is_dir = (de->d_type == DT_DIR);
+        entry->size = 0;
+        entry->mtime = 0;
+        if (stat(dir->path, &st) == 0) {
+            entry->size = entry->is_dir ? 0 : st.st_size;
+            entry->mtime = st.st_mtime;
+        }
+
+        return 1;
+    }
+
+    return 0;
+}
+
+long mod_fs_dir_tell(mod_fs_dir_t *dir)
+{
+    return (dir != NULL) ? telldir(dir->dp) : -1;
+}
+
+void mod_fs_dir_seek(mod_fs_dir_t *dir, long pos)
+{
+    if (dir != NULL) {
+        seekdir(dir->dp, pos);
+    }
+}
+
+void mod_fs_dir_close(mod_fs_dir_t *dir)
+{
+    if (dir == NULL) {
+        return;
+    }
+
+    closedir(dir->dp);
+    mod_mem_free(dir);
+}
+
+static void priv_gc_task(void *arg)
+{
+    esp_err_t err = ESP_OK;
+    uint32_t seen_seq = 0;
+    uint32_t write_seq = 0;
+    int64_t last_write_us = 0;
+    int64_t start = 0;
+    uint32_t run_us = 0;
+    size_t total = 0;
+    size_t used = 0;
+    size_t target = 0;
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(FS_GC_INTERVAL_MS));
+
+        taskENTER_CRITICAL(&s_gc_lock);
+        write_seq = s_write_seq;
+        last_write_us = s_last_write_us;
+        taskEXIT_CRITICAL(&s_gc_lock);
+
+        /* 上次检查后没有写入, 或者还在写 */
+        if ((write_seq == seen_seq) || ((esp_timer_get_time() - last_write_us) < (FS_GC_QUIET_MS * 1000LL))) {
+            continue;
+        }
+        seen_seq = write_seq;
+
+        if ((esp_spiffs_info(FS_PARTITION_NAME, &total, &used) != ESP_OK) || (total == 0)) {
+            continue;
+        }
+
+        target = total * FS_GC_TARGET_PCT / 100;
+        if (target > ((total - used) / 2)) {
+            target = (total - used) / 2;
+        }
+
+        err = ESP_OK;
+        start = esp_timer_get_time();
+        if (target > 0) {
+            err = esp_spiffs_gc(FS_PARTITION_NAME, target);
+        }
+        run_us = esp_timer_get_time() - start;
+
+        taskENTER_CRITICAL(&s_gc_lock);
+        s_gc_stats.checks++;
+        s_gc_stats.free_pct = (total - used) * 100 / total;
+        if (err != ESP_OK) {
+            s_gc_stats.errors++;
+        } else if (run_us >= FS_GC_RUN_MIN_US) {
+            s_gc_stats.runs++;
+            s_gc_stats.total_us += run_us;
+            if (run_us > s_gc_stats.max_us) {
+                s_gc_stats.max_us = run_us;
+            }
+        }
+        taskEXIT_CRITICAL(&s_gc_lock);
+
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "SPIFFS gc failed: %s", esp_err_to_name(err));
+        } else if (run_us >= FS_GC_RUN_MIN_US) {
+            ESP_LOGD(TAG, "SPIFFS gc %d B: %lu us", target, run_us);
+        }
+    }
+}
+
+int mod_fs_get_gc_stats(mod_fs_gc_stats_t *stats)
+{
+    if (stats == NULL) {
+        return -1;
+    }
+
+    taskENTER_CRITICAL(&s_gc_lock);
+    memcpy(stats, &s_gc_stats, sizeof(mod_fs_gc_stats_t));
+    taskEXIT_CRITICAL(&s_gc_lock);
+
+    return 0;
+}
+
+int mod_fs_get_stats(mod_fs_type_t type, mod_fs_stats_t *stats)
+{
+    if (type == MOD_FS_DEFAULT) {
+        type = s_fs_type;
+    }
+
+    if ((stats == NULL) || (type <= MOD_FS_DEFAULT) || (type >= FS_TYPE_NUM)) {
+        return -1;
+    }
+
+    taskENTER_CRITICAL(&s_stats_lock);
+    memcpy(stats, &s_stats[type], sizeof(mod_fs_stats_t));
+    taskEXIT_CRITICAL(&s_stats_lock);
+
+    switch (type) {
+        case MOD_FS_SPIFFS:
+            stats->max_files = SPIFFS_MAX_FILES;
+            break;
+
+        case MOD_FS_FATFS:
+            stats->max_files = FATFS_MAX_FILES;
+            break;
+
+        case MOD_FS_WWW:
+            stats->max_files = MOD_FS_WWW_MAX_FILES;
+            break;
+
+        default:
+            stats->max_files = 0;
+            break;
+    }
+
+    return 0;
+}
+
+void mod_fs_reset_stats(void)
+{
+    taskENTER_CRITICAL(&s_stats_lock);
+    for (int i = 0; i < FS_TYPE_NUM; i++) {
+        memset(s_stats[i].ops, 0, sizeof(s_stats[i].ops));
+        s_stats[i].open_files_max = s_stats[i].open_files;
+    }
+    taskEXIT_CRITICAL(&s_stats_lock);
+}
+
+const char *mod_fs_get_type_name(mod_fs_type_t type)
+{
+    switch (type) {
+        case MOD_FS_SPIFFS:
+            return "spiffs";
+
+        case MOD_FS_LITTLEFS:
+            return "littlefs";
+
+        case MOD_FS_FATFS:
+            return "fatfs";
+
+        case MOD_FS_WWW:
+            return "www";
+
+        default:
+            return "unknown";
+    }
+}
+
+const char *mod_fs_get_op_name(mod_fs_op_t op)
+{
+    switch (op) {
+        case MOD_FS_OP_OPEN:
+            return "open";
+
+        case MOD_FS_OP_READ:
+            return "read";
+
+        case MOD_FS_OP_WRITE:
+            return "write";
+
+        case MOD_FS_OP_CLOSE:
+            return "close";
+
+        default:
+            return "unknown";
+    }
+}
+
+void mod_fs_dump(void)
+{
+    mod_fs_stats_t stats;
+    mod_fs_op_stats_t *op = NULL;
+    char hist[MOD_FS_HIST_NUM * 11 + 1];
+    int len = 0;
+
+    for (mod_fs_type_t type = MOD_FS_SPIFFS; type < FS_TYPE_NUM; type++) {
+        if ((mod_fs_get_stats(type, &stats) != 0) || (stats.open_files_max == 0)) {
+            continue;
+        }
+
+        ESP_LOGI(TAG, "%s: open files: %lu, peak: %lu, limit: %lu", mod_fs_get_type_name(type), stats.open_files,
+                 stats.open_files_max, stats.max_files);
+
+        for (int i = 0; i < MOD_FS_OP_NUM; i++) {
+            op = &stats.ops[i];
+            if (op->count == 0) {
+                continue;
+            }
+
+            len = 0;
+            for (int j = 0; j < MOD_FS_HIST_NUM; j++) {
+                len += snprintf(hist + len, sizeof(hist) - len, (j == 0) ? "%lu" : "/%lu", op->hist[j]);
+            }
+
+            ESP_LOGI(TAG, "%s %s: count: %lu, errors: %lu, bytes: %llu, avg: %lu us, max: %lu us, hist: %s",
+                     mod_fs_get_type_name(type), mod_fs_get_op_name(i), op->count, op->errors, op->bytes,
+                     (uint32_t)(op->total_us / op->count), op->max_us, hist);
+        }
+    }
+}
+
+int mod_fs_init(mod_fs_type_t type)
+{
+    esp_partition_t *part = NULL;
+    int ret = -1;
+
+    if (s_handle_lock == NULL) {
+        s_handle_lock = xSemaphoreCreateMutexStatic(&s_handle_lock_buf);
+        s_batch_lock = xSemaphoreCreateMutexStatic(&s_batch_lock_buf);
+        s_write_lock = xSemaphoreCreateMutexStatic(&s_write_lock_buf);
+    }
+
+    part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, FS_PARTITION_NAME);
+    if (part == NULL) {
+        ESP_LOGE(TAG, "Partition %s not found", FS_PARTITION_NAME);
+        return -1;
+    }
+    ESP_LOGI(TAG, "Partition %s - %s", FS_PARTITION_NAME, priv_get_subtype_str(part->subtype));
+
+    switch (type) {
+        case MOD_FS_SPIFFS:
+            if (part->subtype != ESP_PARTITION_SUBTYPE_DATA_SPIFFS) {
                 return -1;
             }
-            return priv_spiffs_init();
+            ret = priv_spiffs_init();
             break;
 
         case MOD_FS_LITTLEFS:
             if (part->subtype != ESP_PARTITION_SUBTYPE_DATA_LITTLEFS) {
                 return -1;
             }
+            ret = priv_littlefs_init();
             break;
 
         case MOD_FS_FATFS:
             if (part->subtype != ESP_PARTITION_SUBTYPE_DATA_FAT) {
                 return -1;
             }
+            ret = priv_fatfs_init();
             break;
 
+        case MOD_FS_WWW:
+            /* 由 mod_fs_www_init 挂载 */
+            return -1;
+
         case MOD_FS_DEFAULT:
         default:
             if (part->subtype == ESP_PARTITION_SUBTYPE_DATA_SPIFFS) {
-                return priv_spiffs_init();
+                type = MOD_FS_SPIFFS;
+                ret = priv_spiffs_init();
+            } else if (part->subtype == ESP_PARTITION_SUBTYPE_DATA_LITTLEFS) {
+                type = MOD_FS_LITTLEFS;
+                ret = priv_littlefs_init();
+            } else if (part->subtype == ESP_PARTITION_SUBTYPE_DATA_FAT) {
+                type = MOD_FS_FATFS;
+                ret = priv_fatfs_init();
+            } else {
+                return 0;
             }
             break;
     }
 
-    return 0;
+    if (ret == 0) {
+        s_fs_type = type;
+    }
+
+    /* 只有 SPIFFS 在写入时做 GC, LittleFS/FATFS 不需要 */
+    if ((ret == 0) && (type == MOD_FS_SPIFFS)) {
+        if (xTaskCreate(priv_gc_task, FS_GC_TASK_NAME, FS_GC_TASK_STACK, NULL, FS_GC_TASK_PRIORITY, NULL) != pdPASS) {
+            ESP_LOGW(TAG, "gc task create failed");
+        }
+    }
+
+    return ret;
 }
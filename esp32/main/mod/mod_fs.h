@@ -7,6 +7,8 @@
 #ifndef __MOD_FS_H__
 #define __MOD_FS_H__ 
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -21,11 +23,95 @@ typedef enum {
     MOD_FS_SPIFFS   = 1,
     MOD_FS_LITTLEFS = 2,
     MOD_FS_FATFS    = 3,
+    MOD_FS_WWW      = 4, /* active web asset slot, see mod_fs_www.h */
 } mod_fs_type_t;
 
+typedef enum {
+    MOD_FS_HINT_DEFAULT    = 0, /* stdio default buffering */
+    MOD_FS_HINT_SEQUENTIAL = 1, /* large buffer, reads ahead several pages */
+    MOD_FS_HINT_RANDOM     = 2, /* small buffer, little data wasted per seek */
+    MOD_FS_HINT_WRITE_ONCE = 3, /* large buffer, writes reach flash in whole pages */
+} mod_fs_hint_t;
+
+/* Cached handle of a resolved path */
+typedef int mod_fs_handle_t;
+
+#define MOD_FS_HANDLE_INVALID    (-1)
+
+typedef struct {
+    mod_fs_type_t type; /* resolved file system type */
+    size_t size;
+    ino_t ino;
+} mod_fs_handle_info_t;
+
+/* Directory iterator */
+typedef struct mod_fs_dir mod_fs_dir_t;
+
+typedef struct {
+    const char *name;   /* valid until the next mod_fs_dir_next */
+    size_t size;        /* 0 for directories */
+    time_t mtime;       /* 0 if unknown */
+    bool is_dir;
+} mod_fs_entry_t;
+
+/* Background SPIFFS garbage collection */
+typedef struct {
+    uint32_t checks;    /* quiet periods after writes */
+    uint32_t runs;      /* checks that had to collect pages */
+    uint32_t errors;
+    uint64_t total_us;  /* time spent collecting */
+    uint32_t max_us;
+    uint32_t free_pct;  /* free space at the last check */
+} mod_fs_gc_stats_t;
+
+typedef enum {
+    MOD_FS_OP_OPEN  = 0,
+    MOD_FS_OP_READ  = 1,
+    MOD_FS_OP_WRITE = 2,
+    MOD_FS_OP_CLOSE = 3, /* includes flushing the stdio buffer */
+    MOD_FS_OP_NUM,
+} mod_fs_op_t;
+
+/* Latency histogram: bucket i counts operations below MOD_FS_HIST_BASE_US << (2 * i), the last one the rest */
+#define MOD_FS_HIST_NUM         8
+#define MOD_FS_HIST_BASE_US     64
+
+typedef struct {
+    uint32_t count;
+    uint32_t errors;
+    uint64_t bytes;
+    uint64_t total_us;
+    uint32_t max_us;
+    uint32_t hist[MOD_FS_HIST_NUM];
+} mod_fs_op_stats_t;
+
+/* Per mount statistics, files and handles opened through mod_fs only */
+typedef struct {
+    mod_fs_op_stats_t ops[MOD_FS_OP_NUM];
+    uint32_t open_files;
+    uint32_t open_files_max;    /* high-water mark */
+    uint32_t max_files;         /* mount limit, 0 if none */
+} mod_fs_stats_t;
+
+/**
+ * @brief Get the mounted file system type
+ * @return
+ *  - File system type: success
+ *  - MOD_FS_DEFAULT: nothing mounted
+ */
+mod_fs_type_t mod_fs_get_type(void);
+
+/**
+ * @brief Get the mount path of a file system
+ * @param type File system type, MOD_FS_DEFAULT for the mounted one
+ * @return
+ *  - Mount path, "" for file systems without a mount point
+ */
+const char *mod_fs_get_mount_path(mod_fs_type_t type);
+
 /**
  * @brief Open file
- * @param type File system type
+ * @param type File system type, MOD_FS_DEFAULT for the mounted one
  * @param path File path
  * @param mode File mode
  * @return
@@ -34,6 +120,20 @@ typedef enum {
  */
 FILE *mod_fs_open(mod_fs_type_t type, const char *path, const char *mode);
 
+/**
+ * @brief Open file with an access pattern hint
+ * @param type File system type, MOD_FS_DEFAULT for the mounted one
+ * @param path File path
+ * @param mode File mode
+ * @param hint Access pattern, selects the stdio buffer from a shared pool
+ * @return
+ *  - File pointer: success
+ *  - NULL: failure
+ * @note The buffer is returned to the pool by mod_fs_close, when the pool is exhausted the file keeps
+ *       the stdio default buffering.
+ */
+FILE *mod_fs_open_ex(mod_fs_type_t type, const char *path, const char *mode, mod_fs_hint_t hint);
+
 /**
  * @brief Close file
  * @param fp File pointer
@@ -63,6 +163,57 @@ size_t mod_fs_read(FILE *fp, void *buf, size_t size);
  */
 size_t mod_fs_write(FILE *fp, const void *buf, size_t size);
 
+/**
+ * @brief Resolve a path to a cached handle and take a reference
+ * @param type File system type, MOD_FS_DEFAULT for the mounted one
+ * @param path File path, any length
+ * @return
+ *  - Handle: success
+ *  - MOD_FS_HANDLE_INVALID: file not found or handle table full
+ * @note The path is resolved once, reopening a cached path and reading through the handle do no string work.
+ *       Opening the path for writing with mod_fs_open refreshes the cached size on next use. Once a file
+ *       replaced the path (atomic rename, delete), a handle that has already read keeps describing and reading
+ *       the old file until closed, and the next open resolves the new file to a new handle.
+ */
+mod_fs_handle_t mod_fs_handle_open(mod_fs_type_t type, const char *path);
+
+/**
+ * @brief Get cached file information
+ * @param handle Handle
+ * @param info File information
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_fs_handle_info(mod_fs_handle_t handle, mod_fs_handle_info_t *info);
+
+/**
+ * @brief Read at an offset without changing any file position
+ * @param handle Handle
+ * @param buf Buffer
+ * @param size Buffer size
+ * @param offset File offset
+ * @return
+ *  - Number of bytes read: success
+ *  - 0: end of file
+ *  - -1: failure
+ * @note Safe to call from several tasks on the same handle.
+ */
+int mod_fs_pread(mod_fs_handle_t handle, void *buf, size_t size, size_t offset);
+
+/**
+ * @brief Drop a reference taken by mod_fs_handle_open
+ * @param handle Handle
+ */
+void mod_fs_handle_close(mod_fs_handle_t handle);
+
+/**
+ * @brief Drop all cached handles of a file system type, e.g. after its mount point changed
+ * @param type File system type
+ * @note Handles still referenced keep working on the old file until closed, new opens resolve again.
+ */
+void mod_fs_handle_drop(mod_fs_type_t type);
+
 /**
  * @brief Read file
  * @param type File system type
@@ -70,6 +221,7 @@ size_t mod_fs_write(FILE *fp, const void *buf, size_t size);
  * @return
  *  - Buffer pointer: success
  *  - NULL: failure
+ * @note Returns data still pending in mod_fs_file_write_batch, and finishes an interrupted atomic write of the file.
  */
 void *mod_fs_file_read(mod_fs_type_t type, const char *path);
 
@@ -81,16 +233,162 @@ void *mod_fs_file_read(mod_fs_type_t type, const char *path);
  * @param size Buffer size
  * @return
  *  - 0: success
- *  - -1: failure
+ *  - -1: failure, or path is being replaced by mod_fs_atomic_open
+ * @note The file is replaced atomically: the data goes to a temporary file that is fsynced and renamed over path,
+ *       a reset leaves either the old or the new content. Pending batched data for path is dropped.
  */
 int mod_fs_file_write(mod_fs_type_t type, const char *path, const void *buf, size_t size);
 
+/**
+ * @brief Write file later, coalescing writes to the same file
+ * @param type File system type
+ * @param path File path
+ * @param buf Buffer, copied
+ * @param size Buffer size
+ * @param window_ms Delay before the data is written, 0 writes immediately
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ * @note The first write to a file starts the window, later writes within it only replace the data,
+ *       so only the last one reaches flash. The file is then replaced atomically by a background task.
+ *       Data written this way is lost on reset before the window ends, see mod_fs_file_flush.
+ */
+int mod_fs_file_write_batch(mod_fs_type_t type, const char *path, const void *buf, size_t size, uint32_t window_ms);
+
+/**
+ * @brief Write all pending batched data now
+ * @note Call before restart or deep sleep.
+ */
+void mod_fs_file_flush(void);
+
+/**
+ * @brief Start replacing a file atomically, for data that doesn't fit in one buffer
+ * @param type File system type
+ * @param path File path
+ * @return
+ *  - File pointer of a temporary file: success
+ *  - NULL: failure
+ * @note Write with mod_fs_write, then finish with mod_fs_atomic_commit or mod_fs_atomic_abort.
+ *       path keeps its old content until the commit.
+ *       Until then path is reserved: another mod_fs_atomic_open or mod_fs_file_write of it fails,
+ *       batched writes of it are held back.
+ */
+FILE *mod_fs_atomic_open(mod_fs_type_t type, const char *path);
+
+/**
+ * @brief Sync the temporary file and replace path with it
+ * @param type File system type
+ * @param path File path, as passed to mod_fs_atomic_open
+ * @param fp File pointer returned by mod_fs_atomic_open, always closed
+ * @return
+ *  - 0: success
+ *  - -1: failure, path keeps its old content
+ */
+int mod_fs_atomic_commit(mod_fs_type_t type, const char *path, FILE *fp);
+
+/**
+ * @brief Close and delete the temporary file
+ * @param type File system type
+ * @param path File path, as passed to mod_fs_atomic_open
+ * @param fp File pointer returned by mod_fs_atomic_open
+ */
+void mod_fs_atomic_abort(mod_fs_type_t type, const char *path, FILE *fp);
+
 /**
  * @brief Free buffer
  * @param buf Buffer pointer
  */
 void mod_fs_buf_free(void *buf);
 
+/**
+ * @brief Open a directory for iteration
+ * @param type File system type
+ * @param path Directory path, "/" for the root
+ * @return
+ *  - Iterator: success
+ *  - NULL: failure
+ * @note SPIFFS has no directories, its root lists every file with '/' in the name.
+ *       Temporary files of atomic writes are skipped.
+ */
+mod_fs_dir_t *mod_fs_dir_open(mod_fs_type_t type, const char *path);
+
+/**
+ * @brief Get the next entry
+ * @param dir Iterator
+ * @param entry Entry
+ * @return
+ *  - 1: entry filled in
+ *  - 0: no more entries
+ *  - -1: failure
+ */
+int mod_fs_dir_next(mod_fs_dir_t *dir, mod_fs_entry_t *entry);
+
+/**
+ * @brief Get the position of the next entry, to resume a listing later with mod_fs_dir_seek
+ * @param dir Iterator
+ * @return
+ *  - Position: success
+ *  - -1: failure
+ */
+long mod_fs_dir_tell(mod_fs_dir_t *dir);
+
+/**
+ * @brief Continue at a position returned by mod_fs_dir_tell on the same directory
+ * @param dir Iterator
+ * @param pos Position
+ */
+void mod_fs_dir_seek(mod_fs_dir_t *dir, long pos);
+
+/**
+ * @brief Close the iterator
+ * @param dir Iterator
+ */
+void mod_fs_dir_close(mod_fs_dir_t *dir);
+
+/**
+ * @brief Get background garbage collection statistics
+ * @param stats Statistics
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ * @note Only SPIFFS is collected in the background, the statistics stay zero on other file systems.
+ */
+int mod_fs_get_gc_stats(mod_fs_gc_stats_t *stats);
+
+/**
+ * @brief Get operation statistics of a mount
+ * @param type File system type, MOD_FS_DEFAULT for the mounted one
+ * @param stats Statistics
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_fs_get_stats(mod_fs_type_t type, mod_fs_stats_t *stats);
+
+/**
+ * @brief Clear operation statistics, open files stay counted and become the new high-water mark
+ */
+void mod_fs_reset_stats(void);
+
+/**
+ * @brief Get the name of a file system type
+ * @param type File system type
+ * @return Name, "unknown" if invalid
+ */
+const char *mod_fs_get_type_name(mod_fs_type_t type);
+
+/**
+ * @brief Get the name of an operation
+ * @param op Operation
+ * @return Name, "unknown" if invalid
+ */
+const char *mod_fs_get_op_name(mod_fs_op_t op);
+
+/**
+ * @brief Log operation statistics of every mount that has been used
+ */
+void mod_fs_dump(void);
+
 /**
  * @brief Initialize File System Module
  * @return
@@ -0,0 +1,202 @@
+/*
+ * mod_fs_async.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "mod_fs_async.h"
+
+#define ASYNC_TASK_NAME         "mod_fs_io"
+#define ASYNC_TASK_STACK        (4 * 1024)
+#define ASYNC_TASK_PRIORITY     5 /* 与 httpd 任务相同 */
+#define ASYNC_QUEUE_LEN         8
+#define ASYNC_SUBMIT_TIMEOUT_MS 1000
+
+static const char *TAG = "mod_fs_async";
+
+static QueueHandle_t s_async_queue = NULL;
+
+static void priv_async_execute(mod_fs_async_req_t *req)
+{
+    char real_path[128] = {0};
+
+    req->result = -1;
+
+    switch (req->op) {
+        case MOD_FS_ASYNC_READ:
+        case MOD_FS_ASYNC_WRITE:
+            if ((req->fp == NULL) || (req->buf == NULL)) {
+                break;
+            }
+            if ((req->offset != MOD_FS_ASYNC_CURRENT) && (fseek(req->fp, req->offset, SEEK_SET) != 0)) {
+                break;
+            }
+            if (req->op == MOD_FS_ASYNC_READ) {
+                req->result = mod_fs_read(req->fp, req->buf, req->size);
+                if ((req->result == 0) && ferror(req->fp)) {
+                    req->result = -1;
+                }
+            } else {
+                req->result = mod_fs_write(req->fp, req->buf, req->size);
+                if (req->result != req->size) {
+                    req->result = -1;
+                }
+            }
+            break;
+
+        case MOD_FS_ASYNC_STAT:
+            if (req->path == NULL) {
+                break;
+            }
+            /* 路径被截断时不能 stat 到别的文件 */
+            if (snprintf(real_path, sizeof(real_path), "%s%s", mod_fs_get_mount_path(req->type), req->path) >= (int)sizeof(real_path)) {
+                ESP_LOGE(TAG, "path too long: %s", req->path);
+                break;
+            }
+            req->result = (stat(real_path, &req->st) == 0) ? 0 : -1;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void priv_async_complete(mod_fs_async_req_t *req)
+{
+    if (req->cb != NULL) {
+        req->cb(req);
+    } else {
+        xSemaphoreGive(req->done);
+    }
+}
+
+static void priv_async_task(void *arg)
+{
+    mod_fs_async_req_t *req = NULL;
+
+    while (1) {
+        if (xQueueReceive(s_async_queue, &req, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        priv_async_execute(req);
+        /* 完成后请求归调用者所有, 不能再访问 */
+        priv_async_complete(req);
+    }
+}
+
+int mod_fs_async_submit(mod_fs_async_req_t *req)
+{
+    if (req == NULL) {
+        return -1;
+    }
+
+    req->result = -1;
+    if (req->cb == NULL) {
+        req->done = xSemaphoreCreateBinaryStatic(&req->done_buf);
+    }
+
+    if (s_async_queue == NULL) {
+        priv_async_execute(req);
+        priv_async_complete(req);
+        return 0;
+    }
+
+    if (xQueueSend(s_async_queue, &req, pdMS_TO_TICKS(ASYNC_SUBMIT_TIMEOUT_MS)) != pdTRUE) {
+        ESP_LOGE(TAG, "request queue full");
+        return -1;
+    }
+
+    return 0;
+}
+
+int mod_fs_async_wait(mod_fs_async_req_t *req, uint32_t timeout_ms)
+{
+    TickType_t ticks = 0;
+
+    if ((req == NULL) || (req->cb != NULL) || (req->done == NULL)) {
+        return -1;
+    }
+
+    ticks = (timeout_ms == MOD_FS_ASYNC_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+
+    return (xSemaphoreTake(req->done, ticks) == pdTRUE) ? 0 : -1;
+}
+
+int mod_fs_async_read(mod_fs_async_req_t *req, FILE *fp, void *buf, size_t size, mod_fs_async_cb_t cb, void *user)
+{
+    if (req == NULL) {
+        return -1;
+    }
+
+    req->op = MOD_FS_ASYNC_READ;
+    req->fp = fp;
+    req->offset = MOD_FS_ASYNC_CURRENT;
+    req->buf = buf;
+    req->size = size;
+    req->cb = cb;
+    req->user = user;
+
+    return mod_fs_async_submit(req);
+}
+
+int mod_fs_async_write(mod_fs_async_req_t *req, FILE *fp, const void *buf, size_t size, mod_fs_async_cb_t cb, void *user)
+{
+    if (req == NULL) {
+        return -1;
+    }
+
+    req->op = MOD_FS_ASYNC_WRITE;
+    req->fp = fp;
+    req->offset = MOD_FS_ASYNC_CURRENT;
+    req->buf = (void *)buf;
+    req->size = size;
+    req->cb = cb;
+    req->user = user;
+
+    return mod_fs_async_submit(req);
+}
+
+int mod_fs_async_stat(mod_fs_async_req_t *req, mod_fs_type_t type, const char *path, mod_fs_async_cb_t cb, void *user)
+{
+    if (req == NULL) {
+        return -1;
+    }
+
+    req->op = MOD_FS_ASYNC_STAT;
+    req->type = type;
+    req->path = path;
+    req->cb = cb;
+    req->user = user;
+
+    return mod_fs_async_submit(req);
+}
+
+int mod_fs_async_init(void)
+{
+    if (s_async_queue != NULL) {
+        ESP_LOGI(TAG, "async I/O already initialized");
+        return 0;
+    }
+
+    s_async_queue = xQueueCreate(ASYNC_QUEUE_LEN, sizeof(mod_fs_async_req_t *));
+    if (s_async_queue == NULL) {
+        ESP_LOGE(TAG, "queue create failed");
+        return -1;
+    }
+
+    if (xTaskCreate(priv_async_task, ASYNC_TASK_NAME, ASYNC_TASK_STACK, NULL, ASYNC_TASK_PRIORITY, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "task create failed");
+        vQueueDelete(s_async_queue);
+        s_async_queue = NULL;
+        return -1;
+    }
+
+    return 0;
+}
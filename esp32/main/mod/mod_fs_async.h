@@ -0,0 +1,128 @@
+/*
+ * mod_fs_async.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef __MOD_FS_ASYNC_H__
+#define __MOD_FS_ASYNC_H__
+
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "mod_fs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOD_FS_ASYNC_CURRENT    (-1) /* offset: continue at the current file position */
+#define MOD_FS_ASYNC_FOREVER    UINT32_MAX /* timeout: wait until the request completes */
+
+typedef enum {
+    MOD_FS_ASYNC_READ  = 0,
+    MOD_FS_ASYNC_WRITE = 1,
+    MOD_FS_ASYNC_STAT  = 2,
+} mod_fs_async_op_t;
+
+typedef struct mod_fs_async_req mod_fs_async_req_t;
+
+/* Runs on the I/O task, the request may be reused or freed from here on */
+typedef void (*mod_fs_async_cb_t)(mod_fs_async_req_t *req);
+
+/* Owned by the caller and must stay valid until the request completes */
+struct mod_fs_async_req {
+    mod_fs_async_op_t op;
+    FILE *fp;               /* read/write */
+    long offset;            /* read/write: position to seek to first, or MOD_FS_ASYNC_CURRENT */
+    void *buf;              /* read: destination, write: source */
+    size_t size;
+    mod_fs_type_t type;     /* stat */
+    const char *path;       /* stat */
+    mod_fs_async_cb_t cb;   /* NULL: wait with mod_fs_async_wait */
+    void *user;
+
+    int result;             /* read/write: bytes transferred, stat: 0, -1: failure */
+    struct stat st;         /* stat result */
+
+    SemaphoreHandle_t done;
+    StaticSemaphore_t done_buf;
+};
+
+/**
+ * @brief Queue a request to the I/O task
+ * @param req Request, op and the fields of that op must be filled in
+ * @return
+ *  - 0: success
+ *  - -1: failure, the queue stayed full
+ * @note Without the I/O task the request is executed on the calling task before returning.
+ */
+int mod_fs_async_submit(mod_fs_async_req_t *req);
+
+/**
+ * @brief Wait for a request submitted without callback
+ * @param req Request
+ * @param timeout_ms Timeout in milliseconds, MOD_FS_ASYNC_FOREVER to wait without timeout
+ * @return
+ *  - 0: completed, see req->result
+ *  - -1: timeout
+ */
+int mod_fs_async_wait(mod_fs_async_req_t *req, uint32_t timeout_ms);
+
+/**
+ * @brief Read into a buffer at the current file position
+ * @param req Request
+ * @param fp File pointer
+ * @param buf Buffer
+ * @param size Buffer size
+ * @param cb Completion callback, NULL to wait with mod_fs_async_wait
+ * @param user User data
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_fs_async_read(mod_fs_async_req_t *req, FILE *fp, void *buf, size_t size, mod_fs_async_cb_t cb, void *user);
+
+/**
+ * @brief Write a buffer at the current file position
+ * @param req Request
+ * @param fp File pointer
+ * @param buf Buffer
+ * @param size Buffer size
+ * @param cb Completion callback, NULL to wait with mod_fs_async_wait
+ * @param user User data
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_fs_async_write(mod_fs_async_req_t *req, FILE *fp, const void *buf, size_t size, mod_fs_async_cb_t cb, void *user);
+
+/**
+ * @brief Stat a file
+ * @param req Request
+ * @param type File system type
+ * @param path File path
+ * @param cb Completion callback, NULL to wait with mod_fs_async_wait
+ * @param user User data
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_fs_async_stat(mod_fs_async_req_t *req, mod_fs_type_t type, const char *path, mod_fs_async_cb_t cb, void *user);
+
+/**
+ * @brief Initialize Asynchronous File I/O Module, starts the I/O task
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_fs_async_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOD_FS_ASYNC_H__ */
@@ -0,0 +1,343 @@
+/*
+ * mod_fs_www.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <string.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_spiffs.h"
+#include "mbedtls/sha256.h"
+
+#include "mod_mem.h"
+#include "mod_nvs.h"
+#include "mod_fs.h"
+#include "mod_fs_www.h"
+
+#define WWW_SLOT_NUM        2
+#define WWW_NVS_KEY         "www_slot"
+#define WWW_INDEX_PATH      "/index.html" /* 镜像必须包含, 用来判断槽位是否可用 */
+#define WWW_SECTOR_SIZE     4096
+#define WWW_VERIFY_CHUNK    4096
+
+typedef struct {
+    const char *label;
+    const char *mount;
+    const esp_partition_t *part;
+    bool mounted;
+} www_slot_t;
+
+static const char *TAG = "mod_fs_www";
+
+static www_slot_t s_slots[WWW_SLOT_NUM] = {
+    { .label = "www_a", .mount = "/www_a" },
+    { .label = "www_b", .mount = "/www_b" },
+};
+
+/* 当前使用的槽位, -1 表示没有可用的槽位. 切换只是一次整数写入, 读者看到的是旧值或新值 */
+static volatile int s_active = -1;
+
+/* 升级状态, 同一时间只有一个升级 */
+static bool s_updating = false;
+static portMUX_TYPE s_update_lock = portMUX_INITIALIZER_UNLOCKED;
+static int s_update_slot = -1;
+static size_t s_update_size = 0;
+static size_t s_update_written = 0;
+static size_t s_update_erased = 0;
+static mbedtls_sha256_context s_update_sha;
+
+static int priv_slot_mount(int slot)
+{
+    www_slot_t *s = &s_slots[slot];
+    char path[32] = {0};
+    struct stat st;
+    esp_err_t err = ESP_OK;
+
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = s->mount,
+        .partition_label = s->label,
+        .max_files = MOD_FS_WWW_MAX_FILES,
+        .format_if_mount_failed = false, /* 坏镜像不能格式化成空槽位 */
+    };
+
+    if (!s->mounted) {
+        err = esp_vfs_spiffs_register(&conf);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "%s mount failed: %s", s->label, esp_err_to_name(err));
+            return -1;
+        }
+        s->mounted = true;
+    }
+
+    snprintf(path, sizeof(path), "%s%s", s->mount, WWW_INDEX_PATH);
+    if (stat(path, &st) != 0) {
+        ESP_LOGE(TAG, "%s: %s not found", s->label, WWW_INDEX_PATH);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void priv_slot_unmount(int slot)
+{
+    www_slot_t *s = &s_slots[slot];
+
+    if (s->mounted) {
+        esp_vfs_spiffs_unregister(s->label);
+        s->mounted = false;
+    }
+}
+
+/* 从 flash 读回整个镜像计算 SHA-256, 确认写入的数据和收到的一致 */
+static int priv_slot_digest(int slot, size_t size, uint8_t *digest)
+{
+    mbedtls_sha256_context sha;
+    uint8_t *buf = NULL;
+    size_t off = 0;
+    size_t len = 0;
+    int ret = -1;
+
+    buf = (uint8_t *)mod_mem_malloc(WWW_VERIFY_CHUNK, MOD_MEM_DEFAULT);
+    if (buf == NULL) {
+        ESP_LOGE(TAG, "malloc failed");
+        return -1;
+    }
+
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+
+    while (off < size) {
+        len = ((size - off) < WWW_VERIFY_CHUNK) ? (size - off) : WWW_VERIFY_CHUNK;
+        if (esp_partition_read(s_slots[slot].part, off, buf, len) != ESP_OK) {
+            ESP_LOGE(TAG, "%s read failed at %d", s_slots[slot].label, off);
+            goto exit;
+        }
+        mbedtls_sha256_update(&sha, buf, len);
+        off += len;
+    }
+
+    mbedtls_sha256_finish(&sha, digest);
+    ret = 0;
+
+exit:
+    mbedtls_sha256_free(&sha);
+    mod_mem_free(buf);
+
+    return ret;
+}
+
+const char *mod_fs_www_get_mount_path(void)
+{
+    int slot = s_active;
+
+    if (slot < 0) {
+        return mod_fs_get_mount_path(MOD_FS_DEFAULT);
+    }
+
+    return s_slots[slot].mount;
+}
+
+int mod_fs_www_get_slot(void)
+{
+    return s_active;
+}
+
+int mod_fs_www_update_begin(size_t size)
+{
+    int slot = 0;
+
+    if ((s_slots[0].part == NULL) || (s_slots[1].part == NULL)) {
+        ESP_LOGE(TAG, "www partitions not found");
+        return -1;
+    }
+
+    taskENTER_CRITICAL(&s_update_lock);
+    if (s_updating) {
+        taskEXIT_CRITICAL(&s_update_lock);
+        ESP_LOGE(TAG, "update already running");
+        return -1;
+    }
+    s_updating = true;
+    taskEXIT_CRITICAL(&s_update_lock);
+
+    slot = (s_active < 0) ? 0 : (s_active ^ 1);
+    if ((size == 0) || (size > s_slots[slot].part->size)) {
+        ESP_LOGE(TAG, "image size %d does not fit %s (%lu)", size, s_slots[slot].label, s_slots[slot].part->size);
+        goto fail;
+    }
+
+    /* 上一次切换前打开的文件还在读这个槽位时, 读取会失败, 不影响新槽位 */
+    priv_slot_unmount(slot);
+
+    s_update_slot = slot;
+    s_update_size = size;
+    s_update_written = 0;
+    s_update_erased = 0;
+    mbedtls_sha256_init(&s_update_sha);
+    mbedtls_sha256_starts(&s_update_sha, 0);
+
+    ESP_LOGI(TAG, "update %s: %d B", s_slots[slot].label, size);
+
+    return 0;
+
+fail:
+    taskENTER_CRITICAL(&s_update_lock);
+    s_updating = false;
+    taskEXIT_CRITICAL(&s_update_lock);
+
+    return -1;
+}
+
+int mod_fs_www_update_write(const void *data, size_t len)
+{
+    const esp_partition_t *part = NULL;
+    esp_err_t err = ESP_OK;
+
+    if ((data == NULL) || (s_update_slot < 0)) {
+        return -1;
+    }
+
+    if (len > (s_update_size - s_update_written)) {
+        ESP_LOGE(TAG, "image larger than %d B", s_update_size);
+        return -1;
+    }
+    part = s_slots[s_update_slot].part;
+
+    /* 边写边擦除, 只擦除用到的扇区 */
+    while (s_update_erased < (s_update_written + len)) {
+        err = esp_partition_erase_range(part, s_update_erased, WWW_SECTOR_SIZE);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "erase failed: %s", esp_err_to_name(err));
+            return -1;
+        }
+        s_update_erased += WWW_SECTOR_SIZE;
+    }
+
+    err = esp_partition_write(part, s_update_written, data, len);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "write failed: %s", esp_err_to_name(err));
+        return -1;
+    }
+
+    mbedtls_sha256_update(&s_update_sha, (const unsigned char *)data, len);
+    s_update_written += len;
+
+    return 0;
+}
+
+int mod_fs_www_update_finish(const uint8_t *sha256)
+{
+    uint8_t digest[MOD_FS_WWW_SHA256_LEN];
+    uint8_t readback[MOD_FS_WWW_SHA256_LEN];
+    const esp_partition_t *part = NULL;
+    int slot = s_update_slot;
+    int ret = -1;
+
+    if (slot < 0) {
+        return -1;
+    }
+    part = s_slots[slot].part;
+
+    if (s_update_written != s_update_size) {
+        ESP_LOGE(TAG, "image incomplete: %d/%d B", s_update_written, s_update_size);
+        goto exit;
+    }
+
+    mbedtls_sha256_finish(&s_update_sha, digest);
+    if ((sha256 != NULL) && (memcmp(digest, sha256, sizeof(digest)) != 0)) {
+        ESP_LOGE(TAG, "checksum mismatch");
+        goto exit;
+    }
+
+    if ((priv_slot_digest(slot, s_update_size, readback) != 0) || (memcmp(digest, readback, sizeof(digest)) != 0)) {
+        ESP_LOGE(TAG, "%s verify failed", s_slots[slot].label);
+        goto exit;
+    }
+
+    /* 镜像后面残留的旧数据会被 SPIFFS 当成文件系统的一部分 */
+    if ((s_update_erased < part->size) &&
+        (esp_partition_erase_range(part, s_update_erased, part->size - s_update_erased) != ESP_OK)) {
+        ESP_LOGE(TAG, "erase failed");
+        goto exit;
+    }
+
+    if (priv_slot_mount(slot) != 0) {
+        priv_slot_unmount(slot);
+        goto exit;
+    }
+
+    /* 先持久化再切换: 中途掉电时重启后要么是旧槽位, 要么是已经验证过的新槽位 */
+    if (mod_nvs_set_u8(WWW_NVS_KEY, slot) != 0) {
+        priv_slot_unmount(slot);
+        goto exit;
+    }
+
+    s_active = slot;
+    mod_fs_handle_drop(MOD_FS_WWW);
+    ESP_LOGI(TAG, "switched to %s", s_slots[slot].label);
+    ret = 0;
+
+exit:
+    mod_fs_www_update_abort();
+
+    return ret;
+}
+
+void mod_fs_www_update_abort(void)
+{
+    if (s_update_slot < 0) {
+        return;
+    }
+
+    /* 槽位内容不完整, 保持卸载, 下次升级会重写 */
+    mbedtls_sha256_free(&s_update_sha);
+    s_update_slot = -1;
+
+    taskENTER_CRITICAL(&s_update_lock);
+    s_updating = false;
+    taskEXIT_CRITICAL(&s_update_lock);
+}
+
+int mod_fs_www_init(void)
+{
+    uint8_t slot = 0;
+
+    for (int i = 0; i < WWW_SLOT_NUM; i++) {
+        s_slots[i].part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS,
+                                                   s_slots[i].label);
+        if (s_slots[i].part == NULL) {
+            ESP_LOGW(TAG, "Partition %s not found, using %s", s_slots[i].label, mod_fs_get_mount_path(MOD_FS_DEFAULT));
+            return -1;
+        }
+    }
+
+    if ((mod_nvs_get_u8(WWW_NVS_KEY, &slot) != 0) || (slot >= WWW_SLOT_NUM)) {
+        slot = 0;
+    }
+
+    if (priv_slot_mount(slot) == 0) {
+        s_active = slot;
+    } else {
+        /* 选中的槽位不可用, 回退到另一个并记下来 */
+        priv_slot_unmount(slot);
+        slot ^= 1;
+        if (priv_slot_mount(slot) != 0) {
+            priv_slot_unmount(slot);
+            ESP_LOGE(TAG, "no usable slot, using %s", mod_fs_get_mount_path(MOD_FS_DEFAULT));
+            return -1;
+        }
+        s_active = slot;
+        mod_nvs_set_u8(WWW_NVS_KEY, slot);
+    }
+
+    ESP_LOGI(TAG, "active slot: %s", s_slots[s_active].label);
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * mod_fs_www.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef __MOD_FS_WWW_H__
+#define __MOD_FS_WWW_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A/B web asset slots.
+ * The web assets live in two SPIFFS partitions (www_a, www_b), a key in NVS selects the one served after boot.
+ * An update is written as a whole SPIFFS image into the inactive slot, verified and mounted there,
+ * then the NVS key and the active slot are switched in one step. Files are read with MOD_FS_WWW.
+ */
+
+#define MOD_FS_WWW_SHA256_LEN    32
+#define MOD_FS_WWW_MAX_FILES     10 /* per slot */
+
+/**
+ * @brief Get the mount path of the active slot
+ * @return Mount path, the one of the default file system if no slot is usable
+ */
+const char *mod_fs_www_get_mount_path(void);
+
+/**
+ * @brief Get the active slot
+ * @return
+ *  - 0, 1: active slot
+ *  - -1: no slot usable
+ */
+int mod_fs_www_get_slot(void);
+
+/**
+ * @brief Start an update of the inactive slot
+ * @param size Image size
+ * @return
+ *  - 0: success
+ *  - -1: failure, or another update is running
+ * @note The inactive slot is unmounted and overwritten, the active slot is not touched.
+ */
+int mod_fs_www_update_begin(size_t size);
+
+/**
+ * @brief Write the next part of the image
+ * @param data Data
+ * @param len Data length
+ * @return
+ *  - 0: success
+ *  - -1: failure, the update must be aborted
+ */
+int mod_fs_www_update_write(const void *data, size_t len);
+
+/**
+ * @brief Verify the written image and switch to it
+ * @param sha256 Expected SHA-256 of the image, NULL to skip the check
+ * @return
+ *  - 0: success, the updated slot is active
+ *  - -1: failure, the active slot is unchanged and the update is aborted
+ * @note The image is read back from flash and must contain /index.html.
+ *       Files opened before the switch keep reading the old slot until closed.
+ */
+int mod_fs_www_update_finish(const uint8_t *sha256);
+
+/**
+ * @brief Abort an update, the active slot is unchanged
+ */
+void mod_fs_www_update_abort(void);
+
+/**
+ * @brief Initialize Web Asset Module, mounts the slot selected in NVS or the other one if it is not usable
+ * @note Must be called after mod_nvs_init and mod_fs_init
+ * @return
+ *  - 0: success
+ *  - -1: failure, the default file system is used
+ */
+int mod_fs_www_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOD_FS_WWW_H__ */
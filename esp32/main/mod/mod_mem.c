@@ -0,0 +1,203 @@
+/*
+ * mod_mem.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <string.h>
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "sdkconfig.h"
+
+#include "cJSON.h"
+#include "mod_mem.h"
+
+/* 默认分配超过该大小时放到 PSRAM */
+#define MEM_SPIRAM_THRESHOLD    4096
+
+#define MEM_CAPS_INTERNAL       (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define MEM_CAPS_SPIRAM         (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+static const char *TAG = "mod_mem";
+
+static portMUX_TYPE s_mem_lock = portMUX_INITIALIZER_UNLOCKED;
+static mod_mem_stats_t s_mem_stats = {0};
+static bool s_mem_init_flag = false;
+
+static mod_mem_caps_stats_t *priv_caps_stats(void *ptr)
+{
+    return esp_ptr_external_ram(ptr) ? &s_mem_stats.spiram : &s_mem_stats.internal;
+}
+
+static void priv_stats_add(void *ptr, bool fallback)
+{
+    mod_mem_caps_stats_t *stats = priv_caps_stats(ptr);
+    size_t size = heap_caps_get_allocated_size(ptr);
+
+    taskENTER_CRITICAL(&s_mem_lock);
+    stats->used += size;
+    stats->count++;
+    if (stats->used > stats->peak) {
+        stats->peak = stats->used;
+    }
+    if (fallback) {
+        s_mem_stats.fallbacks++;
+    }
+    taskEXIT_CRITICAL(&s_mem_lock);
+}
+
+static void priv_stats_failure(mod_mem_caps_stats_t *stats)
+{
+    taskENTER_CRITICAL(&s_mem_lock);
+    stats->failures++;
+    taskEXIT_CRITICAL(&s_mem_lock);
+}
+
+static bool priv_prefer_spiram(size_t size, mod_mem_tag_t tag)
+{
+#if CONFIG_SPIRAM
+    if (tag == MOD_MEM_INTERNAL) {
+        return false;
+    }
+
+    return (tag == MOD_MEM_BULK) || (size >= MEM_SPIRAM_THRESHOLD);
+#else
+    return false;
+#endif
+}
+
+static void *priv_alloc(size_t size, mod_mem_tag_t tag, bool zero)
+{
+    void *ptr = NULL;
+    bool spiram = priv_prefer_spiram(size, tag);
+    uint32_t caps = spiram ? MEM_CAPS_SPIRAM : MEM_CAPS_INTERNAL;
+
+    if (size == 0) {
+        return NULL;
+    }
+
+    ptr = zero ? heap_caps_calloc(1, size, caps) : heap_caps_malloc(size, caps);
+    if (ptr != NULL) {
+        priv_stats_add(ptr, false);
+        return ptr;
+    }
+    priv_stats_failure(spiram ? &s_mem_stats.spiram : &s_mem_stats.internal);
+
+#if CONFIG_SPIRAM
+    /* 内部 SRAM 专用的分配不回退 */
+    if (tag == MOD_MEM_INTERNAL) {
+        return NULL;
+    }
+
+    caps = spiram ? MEM_CAPS_INTERNAL : MEM_CAPS_SPIRAM;
+    ptr = zero ? heap_caps_calloc(1, size, caps) : heap_caps_malloc(size, caps);
+    if (ptr != NULL) {
+        priv_stats_add(ptr, true);
+        return ptr;
+    }
+    priv_stats_failure(spiram ? &s_mem_stats.internal : &s_mem_stats.spiram);
+#endif
+
+    ESP_LOGE(TAG, "alloc %d bytes failed", size);
+
+    return NULL;
+}
+
+static void *priv_cjson_malloc(size_t size)
+{
+    return priv_alloc(size, MOD_MEM_DEFAULT, false);
+}
+
+void *mod_mem_malloc(size_t size, mod_mem_tag_t tag)
+{
+    return priv_alloc(size, tag, false);
+}
+
+void *mod_mem_calloc(size_t n, size_t size, mod_mem_tag_t tag)
+{
+    if ((n != 0) && (size > (SIZE_MAX / n))) {
+        return NULL;
+    }
+
+    return priv_alloc(n * size, tag, true);
+}
+
+void mod_mem_free(void *ptr)
+{
+    mod_mem_caps_stats_t *stats = NULL;
+    size_t size = 0;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    stats = priv_caps_stats(ptr);
+    size = heap_caps_get_allocated_size(ptr);
+
+    taskENTER_CRITICAL(&s_mem_lock);
+    stats->used -= size;
+    stats->count--;
+    taskEXIT_CRITICAL(&s_mem_lock);
+
+    heap_caps_free(ptr);
+}
+
+int mod_mem_get_stats(mod_mem_stats_t *stats)
+{
+    if (stats == NULL) {
+        return -1;
+    }
+
+    taskENTER_CRITICAL(&s_mem_lock);
+    memcpy(stats, &s_mem_stats, sizeof(mod_mem_stats_t));
+    taskEXIT_CRITICAL(&s_mem_lock);
+
+    return 0;
+}
+
+void mod_mem_dump(void)
+{
+    mod_mem_stats_t stats = {0};
+
+    mod_mem_get_stats(&stats);
+
+    ESP_LOGI(TAG, "internal: used: %d, peak: %d, blocks: %lu, failures: %lu, heap free: %d, largest: %d",
+             stats.internal.used, stats.internal.peak, stats.internal.count, stats.internal.failures,
+             heap_caps_get_free_size(MEM_CAPS_INTERNAL), heap_caps_get_largest_free_block(MEM_CAPS_INTERNAL));
+#if CONFIG_SPIRAM
+    ESP_LOGI(TAG, "spiram: used: %d, peak: %d, blocks: %lu, failures: %lu, heap free: %d, largest: %d",
+             stats.spiram.used, stats.spiram.peak, stats.spiram.count, stats.spiram.failures,
+             heap_caps_get_free_size(MEM_CAPS_SPIRAM), heap_caps_get_largest_free_block(MEM_CAPS_SPIRAM));
+#endif
+    ESP_LOGI(TAG, "fallbacks: %lu", stats.fallbacks);
+}
+
+int mod_mem_init(void)
+{
+    cJSON_Hooks hooks = {
+        .malloc_fn = priv_cjson_malloc,
+        .free_fn = mod_mem_free,
+    };
+
+    if (s_mem_init_flag) {
+        ESP_LOGI(TAG, "MEM already initialized");
+        return 0;
+    }
+
+    cJSON_InitHooks(&hooks);
+    s_mem_init_flag = true;
+
+#if CONFIG_SPIRAM
+    ESP_LOGI(TAG, "PSRAM free: %d, threshold: %d", heap_caps_get_free_size(MEM_CAPS_SPIRAM), MEM_SPIRAM_THRESHOLD);
+#else
+    ESP_LOGI(TAG, "PSRAM disabled, all allocations internal");
+#endif
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * mod_mem.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef __MOD_MEM_H__
+#define __MOD_MEM_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    MOD_MEM_DEFAULT  = 0, /* placed by size */
+    MOD_MEM_INTERNAL = 1, /* small or latency sensitive, always internal SRAM */
+    MOD_MEM_BULK     = 2, /* large or long lived data, PSRAM when available */
+} mod_mem_tag_t;
+
+typedef struct {
+    size_t used;        /* bytes currently allocated */
+    size_t peak;        /* highest value of used */
+    uint32_t count;     /* blocks currently allocated */
+    uint32_t failures;  /* allocations that could not be served from this memory */
+} mod_mem_caps_stats_t;
+
+typedef struct {
+    mod_mem_caps_stats_t internal;
+    mod_mem_caps_stats_t spiram;
+    uint32_t fallbacks; /* allocations served from the other memory than the policy preferred */
+} mod_mem_stats_t;
+
+/**
+ * @brief Allocate memory according to the allocation policy
+ * @param size Size in bytes
+ * @param tag Allocation tag
+ * @return
+ *  - Memory pointer: success
+ *  - NULL: failure
+ */
+void *mod_mem_malloc(size_t size, mod_mem_tag_t tag);
+
+/**
+ * @brief Allocate zeroed memory according to the allocation policy
+ * @param n Number of elements
+ * @param size Element size in bytes
+ * @param tag Allocation tag
+ * @return
+ *  - Memory pointer: success
+ *  - NULL: failure
+ */
+void *mod_mem_calloc(size_t n, size_t size, mod_mem_tag_t tag);
+
+/**
+ * @brief Free memory allocated by mod_mem_malloc/mod_mem_calloc
+ * @param ptr Memory pointer
+ */
+void mod_mem_free(void *ptr);
+
+/**
+ * @brief Get allocation statistics
+ * @param stats Statistics
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_mem_get_stats(mod_mem_stats_t *stats);
+
+/**
+ * @brief Print allocation statistics and heap state
+ */
+void mod_mem_dump(void);
+
+/**
+ * @brief Initialize Memory Module, routes cJSON allocations through the policy
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_mem_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOD_MEM_H__ */
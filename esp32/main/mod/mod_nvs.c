@@ -12,10 +12,61 @@
 
 #include "mod_nvs.h"
 
+#define NVS_NAMESPACE   "mod"
+
 static const char *TAG = "mod_nvs";
 
 static bool s_nvs_init_flag = false;
 
+int mod_nvs_get_u8(const char *key, uint8_t *value)
+{
+    nvs_handle_t handle = 0;
+    esp_err_t err = ESP_OK;
+
+    if ((key == NULL) || (value == NULL)) {
+        return -1;
+    }
+
+    err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return -1;
+    }
+
+    err = nvs_get_u8(handle, key, value);
+    nvs_close(handle);
+
+    return (err == ESP_OK) ? 0 : -1;
+}
+
+int mod_nvs_set_u8(const char *key, uint8_t value)
+{
+    nvs_handle_t handle = 0;
+    esp_err_t err = ESP_OK;
+
+    if (key == NULL) {
+        return -1;
+    }
+
+    err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS open failed: %s", esp_err_to_name(err));
+        return -1;
+    }
+
+    err = nvs_set_u8(handle, key, value);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS set %s failed: %s", key, esp_err_to_name(err));
+        return -1;
+    }
+
+    return 0;
+}
+
 int mod_nvs_init(void)
 {
     esp_err_t err = ESP_OK;
@@ -7,10 +7,33 @@
 #ifndef __MOD_NVS_H__
 #define __MOD_NVS_H__ 
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Read a value from the module namespace
+ * @param key Key
+ * @param value Value
+ * @return
+ *  - 0: success
+ *  - -1: failure or not found
+ */
+int mod_nvs_get_u8(const char *key, uint8_t *value);
+
+/**
+ * @brief Write and commit a value to the module namespace
+ * @param key Key
+ * @param value Value
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ * @note A single value is updated atomically, it reads back either old or new after a reset.
+ */
+int mod_nvs_set_u8(const char *key, uint8_t value);
+
 /**
  * @brief Initialize NVS Module
  * @return
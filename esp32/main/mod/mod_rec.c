@@ -0,0 +1,551 @@
+/*
+ * mod_rec.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <dirent.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+
+#include "mod_mem.h"
+#include "mod_fs.h"
+#include "mod_rec.h"
+
+/**
+ * 分段文件 /recNNNNN.log, 由页组成, 记录不跨页, 页尾不够放下一条记录时用 0xFF 填满.
+ * 页大小取一个 flash 扇区, 攒满一页再写, 减少 SPIFFS/LittleFS 的元数据更新.
+ * 掉电只会损坏最后一页, 每页从记录开始, 恢复时只需要读各页的第一个记录头和最后一页.
+ */
+#define REC_FILE_FMT         "/rec%05lu.log"
+#define REC_NAME_LEN         32
+#define REC_PAGE_SIZE        4096
+#define REC_SEGMENT_PAGES    16
+#define REC_SEGMENT_NUM      8
+#define REC_MAGIC            0x5243
+#define REC_TS_NONE          UINT64_MAX
+
+typedef struct {
+    uint16_t magic;
+    uint16_t len;
+    uint32_t crc;   /* ts and data */
+    uint64_t ts;
+} rec_header_t;
+
+_Static_assert(MOD_REC_DATA_MAX == REC_PAGE_SIZE - sizeof(rec_header_t), "MOD_REC_DATA_MAX mismatch");
+
+/* 稀疏索引, 每页记录第一条记录的时间 */
+typedef struct {
+    uint32_t id;
+    uint32_t pages;
+    uint64_t last_ts;
+    uint64_t page_ts[REC_SEGMENT_PAGES];
+} rec_segment_t;
+
+typedef struct {
+    uint64_t from;
+    uint64_t to;
+    mod_rec_cb_t cb;
+    void *user;
+    int count;
+    uint64_t last_ts;
+    bool stop;
+} rec_scan_t;
+
+static const char *TAG = "mod_rec";
+
+static rec_segment_t s_segments[REC_SEGMENT_NUM]; /* 按时间从旧到新, 最后一个正在写 */
+static int s_segment_count = 0;
+static FILE *s_fp = NULL;
+static uint8_t *s_page = NULL;  /* 正在写的页, 从页首开始 */
+static size_t s_page_used = 0;
+static size_t s_page_written = 0; /* 已经写入文件的部分 */
+static uint32_t s_page_index = 0;
+static uint64_t s_last_ts = 0;
+static SemaphoreHandle_t s_rec_lock = NULL;
+static StaticSemaphore_t s_rec_lock_buf;
+
+static void priv_rec_name(uint32_t id, char *name)
+{
+    snprintf(name, REC_NAME_LEN, REC_FILE_FMT, (unsigned long)id);
+}
+
+static uint32_t priv_rec_crc(const rec_header_t *hdr, const uint8_t *data)
+{
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)&hdr->ts, sizeof(hdr->ts));
+
+    return esp_rom_crc32_le(crc, data, hdr->len);
+}
+
+/**
+ * @brief 解析一页中的记录, 在范围内的交给回调
+ * @return
+ *  - 有效数据的长度, 之后是填充或者没写完的数据
+ */
+static size_t priv_rec_scan(const uint8_t *page, size_t size, rec_scan_t *scan)
+{
+    rec_header_t hdr;
+    size_t offset = 0;
+
+    while (!scan->stop && ((offset + sizeof(hdr)) <= size)) {
+        memcpy(&hdr, page + offset, sizeof(hdr));
+        if ((hdr.magic != REC_MAGIC) || (hdr.len > (size - offset - sizeof(hdr))) ||
+            (priv_rec_crc(&hdr, page + offset + sizeof(hdr)) != hdr.crc)) {
+            break;
+        }
+
+        scan->last_ts = hdr.ts;
+        if ((scan->cb != NULL) && (hdr.ts >= scan->from) && (hdr.ts <= scan->to)) {
+            scan->count++;
+            if (scan->cb(hdr.ts, page + offset + sizeof(hdr), hdr.len, scan->user) != 0) {
+                scan->stop = true;
+            }
+        }
+        offset += sizeof(hdr) + hdr.len;
+    }
+
+    return offset;
+}
+
+/* 把当前页还没写入的部分写进文件 */
+static int priv_rec_write(void)
+{
+    if (s_page_used == s_page_written) {
+        return 0;
+    }
+
+    if ((s_fp == NULL) || (mod_fs_write(s_fp, s_page + s_page_written, s_page_used - s_page_written) !=
+                           (s_page_used - s_page_written)) || (fflush(s_fp) != 0)) {
+        ESP_LOGE(TAG, "write failed");
+        return -1;
+    }
+    s_page_written = s_page_used;
+
+    return 0;
+}
+
+static void priv_rec_remove_oldest(void)
+{
+    char name[REC_NAME_LEN];
+    char real_path[128];
+
+    priv_rec_name(s_segments[0].id, name);
+    snprintf(real_path, sizeof(real_path), "%s%s", mod_fs_get_mount_path(MOD_FS_DEFAULT), name);
+    remove(real_path);
+
+    s_segment_count--;
+    memmove(&s_segments[0], &s_segments[1], s_segment_count * sizeof(rec_segment_t));
+}
+
+/* 开始一个新的分段, 分段数到上限时删除最旧的 */
+static int priv_rec_roll(void)
+{
+    rec_segment_t *seg = NULL;
+    char name[REC_NAME_LEN];
+    uint32_t id = 1;
+
+    if (s_fp != NULL) {
+        fsync(fileno(s_fp));
+        mod_fs_close(s_fp);
+        s_fp = NULL;
+    }
+
+    if (s_segment_count > 0) {
+        id = s_segments[s_segment_count - 1].id + 1;
+    }
+    if (s_segment_count == REC_SEGMENT_NUM) {
+        priv_rec_remove_oldest();
+    }
+
+    priv_rec_name(id, name);
+    s_fp = mod_fs_open(MOD_FS_DEFAULT, name, "w");
+    if (s_fp == NULL) {
+        ESP_LOGE(TAG, "create %s failed", name);
+        return -1;
+    }
+
+    seg = &s_segments[s_segment_count++];
+    seg->id = id;
+    seg->pages = 0;
+    seg->last_ts = 0;
+    for (int i = 0; i < REC_SEGMENT_PAGES; i++) {
+        seg->page_ts[i] = REC_TS_NONE;
+    }
+
+    s_page_index = 0;
+    s_page_used = 0;
+    s_page_written = 0;
+
+    return 0;
+}
+
+/* 当前页填充后写出, 移到下一页 */
+static int priv_rec_next_page(void)
+{
+    memset(s_page + s_page_used, 0xFF, REC_PAGE_SIZE - s_page_used);
+    s_page_used = REC_PAGE_SIZE;
+    if (priv_rec_write() != 0) {
+        return -1;
+    }
+
+    /* 换分段失败时停在写满的最后一页, 下次追加会再走到这里重试 */
+    if ((s_page_index + 1) == REC_SEGMENT_PAGES) {
+        return priv_rec_roll();
+    }
+
+    s_page_index++;
+    s_page_used = 0;
+    s_page_written = 0;
+
+    return 0;
+}
+
+int mod_rec_append(uint64_t ts, const void *data, size_t len)
+{
+    rec_segment_t *seg = NULL;
+    rec_header_t hdr;
+    int ret = -1;
+
+    if ((s_rec_lock == NULL) || ((data == NULL) && (len > 0)) || (len > MOD_REC_DATA_MAX)) {
+        return -1;
+    }
+
+    xSemaphoreTake(s_rec_lock, portMAX_DELAY);
+
+    /* 稀疏索引要求时间不减 */
+    if (ts < s_last_ts) {
+        ESP_LOGE(TAG, "timestamp goes backwards");
+        goto exit;
+    }
+
+    if ((s_page_used + sizeof(hdr) + len) > REC_PAGE_SIZE) {
+        if (priv_rec_next_page() != 0) {
+            goto exit;
+        }
+    }
+
+    if ((s_fp == NULL) || (s_page_index >= REC_SEGMENT_PAGES)) {
+        ESP_LOGE(TAG, "no segment to write");
+        goto exit;
+    }
+
+    hdr.magic = REC_MAGIC;
+    hdr.len = len;
+    hdr.ts = ts;
+    hdr.crc = priv_rec_crc(&hdr, (const uint8_t *)data);
+    memcpy(s_page + s_page_used, &hdr, sizeof(hdr));
+    if (len > 0) {
+        memcpy(s_page + s_page_used + sizeof(hdr), data, len);
+    }
+
+    seg = &s_segments[s_segment_count - 1];
+    if (s_page_used == 0) {
+        seg->page_ts[s_page_index] = ts;
+        seg->pages = s_page_index + 1;
+    }
+    seg->last_ts = ts;
+    s_page_used += sizeof(hdr) + len;
+    s_last_ts = ts;
+    ret = 0;
+
+exit:
+    xSemaphoreGive(s_rec_lock);
+
+    return ret;
+}
+
+int mod_rec_flush(void)
+{
+    int ret = -1;
+
+    if (s_rec_lock == NULL) {
+        return -1;
+    }
+
+    xSemaphoreTake(s_rec_lock, portMAX_DELAY);
+    if ((s_fp != NULL) && (priv_rec_write() == 0) && (fsync(fileno(s_fp)) == 0)) {
+        ret = 0;
+    }
+    xSemaphoreGive(s_rec_lock);
+
+    return ret;
+}
+
+int mod_rec_read(uint64_t from, uint64_t to, mod_rec_cb_t cb, void *user)
+{
+    rec_scan_t scan = {.from = from, .to = to, .cb = cb, .user = user};
+    mod_fs_handle_t handle = MOD_FS_HANDLE_INVALID;
+    rec_segment_t *seg = NULL;
+    char name[REC_NAME_LEN];
+    uint8_t *buf = NULL;
+    uint32_t start = 0;
+    int len = 0;
+    int ret = -1;
+
+    if ((s_rec_lock == NULL) || (cb == NULL) || (from > to)) {
+        return -1;
+    }
+
+    buf = (uint8_t *)mod_mem_malloc(REC_PAGE_SIZE, MOD_MEM_BULK);
+    if (buf == NULL) {
+        ESP_LOGE(TAG, "malloc failed");
+        return -1;
+    }
+
+    xSemaphoreTake(s_rec_lock, portMAX_DELAY);
+
+    for (int i = 0; (i < s_segment_count) && !scan.stop; i++) {
+        seg = &s_segments[i];
+        if ((seg->pages == 0) || (seg->page_ts[0] > to) || (seg->last_ts < from)) {
+            continue;
+        }
+
+        /* 从最后一个首条记录早于 from 的页开始, 时间等于 from 的记录可能从前一页的末尾开始 */
+        start = 0;
+        for (uint32_t p = 1; p < seg->pages; p++) {
+            if ((seg->page_ts[p] != REC_TS_NONE) && (seg->page_ts[p] < from)) {
+                start = p;
+            }
+        }
+
+        priv_rec_name(seg->id, name);
+        handle = mod_fs_handle_open(MOD_FS_DEFAULT, name);
+        if (handle == MOD_FS_HANDLE_INVALID) {
+            ESP_LOGE(TAG, "open %s failed", name);
+            goto exit;
+        }
+
+        for (uint32_t p = start; (p < seg->pages) && !scan.stop; p++) {
+            if ((seg->page_ts[p] != REC_TS_NONE) && (seg->page_ts[p] > to)) {
+                break;
+            }
+
+            /* 正在写的页以内存为准 */
+            if ((i == (s_segment_count - 1)) && (p == s_page_index)) {
+                priv_rec_scan(s_page, s_page_used, &scan);
+                continue;
+            }
+
+            len = mod_fs_pread(handle, buf, REC_PAGE_SIZE, p * REC_PAGE_SIZE);
+            if (len <= 0) {
+                break;
+            }
+            priv_rec_scan(buf, len, &scan);
+        }
+
+        mod_fs_handle_close(handle);
+    }
+    ret = scan.count;
+
+exit:
+    xSemaphoreGive(s_rec_lock);
+    mod_mem_free(buf);
+
+    return ret;
+}
+
+int mod_rec_compact(uint64_t before)
+{
+    int removed = 0;
+
+    if (s_rec_lock == NULL) {
+        return -1;
+    }
+
+    xSemaphoreTake(s_rec_lock, portMAX_DELAY);
+    while ((s_segment_count > 1) && (s_segments[0].last_ts < before)) {
+        priv_rec_remove_oldest();
+        removed++;
+    }
+    xSemaphoreGive(s_rec_lock);
+
+    return removed;
+}
+
+/**
+ * @brief 读取分段, 建立稀疏索引
+ * @param seg 分段, id 已经填好
+ * @param buf 一页大小的缓冲区
+ * @param last 是否是最后一个分段, 是的话把最后一页载入 s_page, 截掉没写完的记录
+ */
+static int priv_rec_load(rec_segment_t *seg, uint8_t *buf, bool last)
+{
+    rec_scan_t scan = {0};
+    mod_fs_handle_info_t info;
+    mod_fs_handle_t handle = MOD_FS_HANDLE_INVALID;
+    rec_header_t hdr;
+    char name[REC_NAME_LEN];
+    char real_path[128];
+    size_t valid = 0;
+    int len = 0;
+    int ret = -1;
+
+    priv_rec_name(seg->id, name);
+    handle = mod_fs_handle_open(MOD_FS_DEFAULT, name);
+    if ((handle == MOD_FS_HANDLE_INVALID) || (mod_fs_handle_info(handle, &info) != 0)) {
+        goto exit;
+    }
+
+    seg->pages = (info.size + REC_PAGE_SIZE - 1) / REC_PAGE_SIZE;
+    if (seg->pages > REC_SEGMENT_PAGES) {
+        seg->pages = REC_SEGMENT_PAGES;
+    }
+    for (uint32_t p = 0; p < REC_SEGMENT_PAGES; p++) {
+        seg->page_ts[p] = REC_TS_NONE;
+        if ((p < seg->pages) && (mod_fs_pread(handle, &hdr, sizeof(hdr), p * REC_PAGE_SIZE) == sizeof(hdr)) &&
+            (hdr.magic == REC_MAGIC)) {
+            seg->page_ts[p] = hdr.ts;
+        }
+    }
+
+    seg->last_ts = 0;
+    len = 0;
+    if (seg->pages > 0) {
+        len = mod_fs_pread(handle, buf, REC_PAGE_SIZE, (seg->pages - 1) * REC_PAGE_SIZE);
+        if (len < 0) {
+            goto exit;
+        }
+        valid = priv_rec_scan(buf, len, &scan);
+        seg->last_ts = scan.last_ts;
+    }
+    /* 截断前关闭, FATFS 不允许 */
+    mod_fs_handle_close(handle);
+    handle = MOD_FS_HANDLE_INVALID;
+    if (valid == 0) {
+        /* 最后一页没有有效记录 */
+        seg->page_ts[(seg->pages > 0) ? (seg->pages - 1) : 0] = REC_TS_NONE;
+    }
+
+    if (last) {
+        s_page_index = (seg->pages > 0) ? (seg->pages - 1) : 0;
+        memcpy(s_page, buf, valid);
+        /* 整页写完的当作已填充, 不再追加 */
+        s_page_used = (len == REC_PAGE_SIZE) ? REC_PAGE_SIZE : valid;
+        s_page_written = s_page_used;
+        if ((len < REC_PAGE_SIZE) && (valid < len)) {
+            ESP_LOGW(TAG, "%s: drop %d B torn tail", name, len - valid);
+            snprintf(real_path, sizeof(real_path), "%s%s", mod_fs_get_mount_path(MOD_FS_DEFAULT), name);
+            if (truncate(real_path, s_page_index * REC_PAGE_SIZE + valid) != 0) {
+                ESP_LOGE(TAG, "truncate %s failed", name);
+                goto exit;
+            }
+        }
+    }
+    ret = 0;
+
+exit:
+    if (handle != MOD_FS_HANDLE_INVALID) {
+        mod_fs_handle_close(handle);
+    }
+
+    return ret;
+}
+
+/* 按编号升序插入, 超过上限时删除最旧的文件 */
+static void priv_rec_add_id(uint32_t id)
+{
+    char name[REC_NAME_LEN];
+    char real_path[128];
+    int pos = s_segment_count;
+
+    while ((pos > 0) && (s_segments[pos - 1].id > id)) {
+        pos--;
+    }
+
+    if (s_segment_count == REC_SEGMENT_NUM) {
+        if (pos == 0) {
+            /* 比已有的都旧 */
+            priv_rec_name(id, name);
+            snprintf(real_path, sizeof(real_path), "%s%s", mod_fs_get_mount_path(MOD_FS_DEFAULT), name);
+            remove(real_path);
+            return;
+        }
+        priv_rec_remove_oldest();
+        pos--;
+    }
+
+    memmove(&s_segments[pos + 1], &s_segments[pos], (s_segment_count - pos) * sizeof(rec_segment_t));
+    s_segments[pos].id = id;
+    s_segment_count++;
+}
+
+int mod_rec_init(void)
+{
+    struct dirent *entry = NULL;
+    unsigned long id = 0;
+    char name[REC_NAME_LEN];
+    uint8_t *buf = NULL;
+    DIR *dp = NULL;
+    int ret = -1;
+
+    if (s_rec_lock != NULL) {
+        ESP_LOGI(TAG, "record store already initialized");
+        return 0;
+    }
+
+    if (mod_fs_get_type() == MOD_FS_DEFAULT) {
+        ESP_LOGE(TAG, "no file system mounted");
+        return -1;
+    }
+
+    s_page = (uint8_t *)mod_mem_malloc(REC_PAGE_SIZE, MOD_MEM_DEFAULT);
+    buf = (uint8_t *)mod_mem_malloc(REC_PAGE_SIZE, MOD_MEM_BULK);
+    if ((s_page == NULL) || (buf == NULL)) {
+        ESP_LOGE(TAG, "malloc failed");
+        goto exit;
+    }
+
+    dp = opendir(mod_fs_get_mount_path(MOD_FS_DEFAULT));
+    if (dp != NULL) {
+        while ((entry = readdir(dp)) != NULL) {
+            /* 只认 REC_FILE_FMT 生成的文件名 */
+            if ((sscanf(entry->d_name, "rec%lu.log", &id) != 1) || (id == 0)) {
+                continue;
+            }
+            priv_rec_name(id, name);
+            if (strcmp(name + 1, entry->d_name) == 0) {
+                priv_rec_add_id(id);
+            }
+        }
+        closedir(dp);
+    }
+
+    for (int i = 0; i < s_segment_count; i++) {
+        if (priv_rec_load(&s_segments[i], buf, i == (s_segment_count - 1)) != 0) {
+            ESP_LOGE(TAG, "load segment %lu failed", s_segments[i].id);
+            goto exit;
+        }
+    }
+
+    if (s_segment_count == 0) {
+        ret = priv_rec_roll();
+    } else {
+        for (int i = 0; i < s_segment_count; i++) {
+            if (s_segments[i].last_ts > s_last_ts) {
+                s_last_ts = s_segments[i].last_ts;
+            }
+        }
+        priv_rec_name(s_segments[s_segment_count - 1].id, name);
+        s_fp = mod_fs_open(MOD_FS_DEFAULT, name, "a");
+        ret = (s_fp != NULL) ? 0 : -1;
+    }
+
+    ESP_LOGI(TAG, "%d segments, page %lu", s_segment_count, s_page_index);
+
+exit:
+    mod_mem_free(buf);
+    if (ret != 0) {
+        mod_mem_free(s_page);
+        s_page = NULL;
+        s_segment_count = 0;
+        return -1;
+    }
+
+    s_rec_lock = xSemaphoreCreateMutexStatic(&s_rec_lock_buf);
+
+    return 0;
+}
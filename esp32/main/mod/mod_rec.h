@@ -0,0 +1,83 @@
+/*
+ * mod_rec.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef __MOD_REC_H__
+#define __MOD_REC_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Append-only record store on the mounted file system.
+ * Records are packed into pages that are written whole, pages into segment files that are
+ * rolled over when full, the oldest segment is dropped once the segment limit is reached.
+ */
+
+#define MOD_REC_DATA_MAX    (4096 - 16) /* page size minus record header */
+
+/* Return non-zero to stop reading */
+typedef int (*mod_rec_cb_t)(uint64_t ts, const void *data, size_t len, void *user);
+
+/**
+ * @brief Append a record
+ * @param ts Timestamp, must not be smaller than the one of the previous record
+ * @param data Record data
+ * @param len Record length, up to MOD_REC_DATA_MAX
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ * @note The record stays in RAM until its page is full or mod_rec_flush is called.
+ */
+int mod_rec_append(uint64_t ts, const void *data, size_t len);
+
+/**
+ * @brief Write buffered records to flash
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_rec_flush(void);
+
+/**
+ * @brief Read the records with from <= ts <= to, oldest first
+ * @param from First timestamp
+ * @param to Last timestamp
+ * @param cb Callback for each record, must not call other mod_rec functions
+ * @param user User data
+ * @return
+ *  - Number of records passed to cb: success
+ *  - -1: failure
+ */
+int mod_rec_read(uint64_t from, uint64_t to, mod_rec_cb_t cb, void *user);
+
+/**
+ * @brief Delete the segments that only hold records older than before
+ * @param before Timestamp
+ * @return
+ *  - Number of segments deleted: success
+ *  - -1: failure
+ * @note The segment being written is never deleted.
+ */
+int mod_rec_compact(uint64_t before);
+
+/**
+ * @brief Initialize Record Store Module, loads the segments and repairs a torn tail
+ * @note Must be called after mod_fs_init
+ * @return
+ *  - 0: success
+ *  - -1: failure
+ */
+int mod_rec_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOD_REC_H__ */
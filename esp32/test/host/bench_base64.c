@@ -0,0 +1,88 @@
+/*
+ * bench_base64.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ *
+ * Base64 encode/decode throughput. Usage: bench_base64 [-n iterations]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base64.h"
+#include "bench_common.h"
+
+static const int s_sizes[] = { 16, 256, 4096, 65536 };
+
+static int priv_bench_size(int size, int iterations)
+{
+    uint8_t *bin = NULL;
+    uint8_t *back = NULL;
+    char *text = NULL;
+    int text_max = ((size + 2) / 3) * 4 + 1;
+    int text_len = 0;
+    int64_t encode_us = 0;
+    int64_t decode_us = 0;
+    int64_t start = 0;
+    int ret = -1;
+
+    bin = (uint8_t *)malloc(size);
+    back = (uint8_t *)malloc(size);
+    text = (char *)malloc(text_max);
+    if ((bin == NULL) || (back == NULL) || (text == NULL)) {
+        goto exit;
+    }
+
+    srand(size);
+    for (int i = 0; i < size; i++) {
+        bin[i] = (uint8_t)rand();
+    }
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        text_len = bin_to_b64(bin, size, text, text_max);
+    }
+    encode_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        if (b64_to_bin(text, text_len, back, size) != size) {
+            printf("%6d B decode failed\n", size);
+            goto exit;
+        }
+    }
+    decode_us = bench_now_us() - start;
+
+    if (memcmp(bin, back, size) != 0) {
+        printf("%6d B does not round-trip\n", size);
+        goto exit;
+    }
+
+    printf("%6d B | encode %8.2f MB/s | decode %8.2f MB/s\n", size,
+           bench_mbps(size, iterations, encode_us), bench_mbps(size, iterations, decode_us));
+    ret = 0;
+
+exit:
+    free(text);
+    free(back);
+    free(bin);
+
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 0;
+
+    bench_parse_args(argc, argv, &iterations);
+    printf("%d iterations\n", iterations);
+
+    for (size_t i = 0; i < sizeof(s_sizes) / sizeof(s_sizes[0]); i++) {
+        if (priv_bench_size(s_sizes[i], iterations) != 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
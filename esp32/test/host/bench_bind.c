@@ -0,0 +1,592 @@
+/*
+ * bench_bind.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ *
+ * cJSON_BindParse/cJSON_BindWrite against the DOM route (parse, pick the members into the struct,
+ * delete / build a tree, print, delete) on the same struct: throughput, allocations and peak memory.
+ * Both routes must produce the same struct and the same text. Also checks that integers are range checked
+ * against the size and signedness of their member. Usage: bench_bind [-n iterations] [corpus dir]
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "cJSON_Writer.h"
+#include "cJSON_Bind.h"
+#include "bench_common.h"
+
+#define TELEMETRY_SAMPLES_MAX   128
+
+typedef struct {
+    int ts;
+    double temp;
+    double hum;
+    int rssi;
+    bool ok;
+} sample_t;
+
+typedef struct {
+    char device[16];
+    sample_t samples[TELEMETRY_SAMPLES_MAX];
+    size_t sample_count;
+} telemetry_t;
+
+typedef struct {
+    char mode[8];
+    bool dhcp;
+    char ip[16];
+    char netmask[16];
+    char gateway[16];
+    char dns[2][16];
+    size_t dns_count;
+} network_t;
+
+typedef struct {
+    int port;
+    int max_uri_handlers;
+    bool auth;
+} http_t;
+
+typedef struct {
+    char type[8];
+    int max_files;
+    bool format_if_mount_failed;
+} fs_t;
+
+typedef struct {
+    network_t network;
+    http_t http;
+    fs_t fs;
+} config_t;
+
+static const cJSON_BindField s_sample_fields[] = {
+    CJSON_BIND_INT(sample_t, ts),
+    CJSON_BIND_DOUBLE(sample_t, temp),
+    CJSON_BIND_DOUBLE(sample_t, hum),
+    CJSON_BIND_INT(sample_t, rssi),
+    CJSON_BIND_BOOL(sample_t, ok),
+};
+
+static const cJSON_BindField s_telemetry_fields[] = {
+    CJSON_BIND_STRING(telemetry_t, device),
+    CJSON_BIND_OBJECT_ARRAY(telemetry_t, samples, sample_count, s_sample_fields),
+};
+
+static const cJSON_BindField s_network_fields[] = {
+    CJSON_BIND_STRING(network_t, mode),
+    CJSON_BIND_BOOL(network_t, dhcp),
+    CJSON_BIND_STRING(network_t, ip),
+    CJSON_BIND_STRING(network_t, netmask),
+    CJSON_BIND_STRING(network_t, gateway),
+    CJSON_BIND_ARRAY(network_t, dns, dns_count, cJSON_BindString),
+};
+
+static const cJSON_BindField s_http_fields[] = {
+    CJSON_BIND_INT(http_t, port),
+    CJSON_BIND_INT(http_t, max_uri_handlers),
+    CJSON_BIND_BOOL(http_t, auth),
+};
+
+static const cJSON_BindField s_fs_fields[] = {
+    CJSON_BIND_STRING(fs_t, type),
+    CJSON_BIND_INT(fs_t, max_files),
+    CJSON_BIND_BOOL(fs_t, format_if_mount_failed),
+};
+
+static const cJSON_BindField s_config_fields[] = {
+    CJSON_BIND_OBJECT(config_t, network, s_network_fields),
+    CJSON_BIND_OBJECT(config_t, http, s_http_fields),
+    CJSON_BIND_OBJECT(config_t, fs, s_fs_fields),
+};
+
+typedef struct {
+    int8_t i8;
+    uint8_t u8;
+    short s;
+    uint16_t u16;
+    int32_t i32;
+    uint32_t u32;
+    int64_t i64;
+    uint64_t u64;
+} integers_t;
+
+static const cJSON_BindField s_integers_fields[] = {
+    CJSON_BIND_INT(integers_t, i8),
+    CJSON_BIND_UINT(integers_t, u8),
+    CJSON_BIND_INT(integers_t, s),
+    CJSON_BIND_UINT(integers_t, u16),
+    CJSON_BIND_INT(integers_t, i32),
+    CJSON_BIND_UINT(integers_t, u32),
+    CJSON_BIND_INT(integers_t, i64),
+    CJSON_BIND_UINT(integers_t, u64),
+};
+
+/* 手写的 DOM 版本, 和 HTTP 处理函数里的写法一样 */
+static bool priv_dom_string(const cJSON *obj, const char *key, char *out, size_t size)
+{
+    const char *value = cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(obj, key));
+
+    if ((value == NULL) || (strlen(value) >= size)) {
+        return false;
+    }
+    strcpy(out, value);
+
+    return true;
+}
+
+static bool priv_dom_number(const cJSON *obj, const char *key, double *out)
+{
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(obj, key);
+
+    if (!cJSON_IsNumber(item)) {
+        return false;
+    }
+    *out = item->valuedouble;
+
+    return true;
+}
+
+static bool priv_dom_int(const cJSON *obj, const char *key, int *out)
+{
+    double value = 0;
+
+    if (!priv_dom_number(obj, key, &value)) {
+        return false;
+    }
+    *out = (int)value;
+
+    return true;
+}
+
+static bool priv_dom_bool(const cJSON *obj, const char *key, bool *out)
+{
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(obj, key);
+
+    if (!cJSON_IsBool(item)) {
+        return false;
+    }
+    *out = cJSON_IsTrue(item);
+
+    return true;
+}
+
+static bool priv_telemetry_dom_decode(const char *json, size_t len, void *object)
+{
+    telemetry_t *t = (telemetry_t *)object;
+    cJSON *root = cJSON_ParseWithLength(json, len);
+    const cJSON *samples = NULL;
+    const cJSON *item = NULL;
+    sample_t *s = NULL;
+    bool ok = false;
+
+    if (root == NULL) {
+        return false;
+    }
+
+    if (!priv_dom_string(root, "device", t->device, sizeof(t->device))) {
+        goto exit;
+    }
+
+    samples = cJSON_GetObjectItemCaseSensitive(root, "samples");
+    if (!cJSON_IsArray(samples)) {
+        goto exit;
+    }
+    t->sample_count = 0;
+    cJSON_ArrayForEach(item, samples) {
+        if (t->sample_count >= TELEMETRY_SAMPLES_MAX) {
+            goto exit;
+        }
+        s = &t->samples[t->sample_count++];
+        if (!priv_dom_int(item, "ts", &s->ts) || !priv_dom_number(item, "temp", &s->temp) ||
+            !priv_dom_number(item, "hum", &s->hum) || !priv_dom_int(item, "rssi", &s->rssi) ||
+            !priv_dom_bool(item, "ok", &s->ok)) {
+            goto exit;
+        }
+    }
+    ok = true;
+
+exit:
+    cJSON_Delete(root);
+
+    return ok;
+}
+
+static char *priv_telemetry_dom_encode(const void *object)
+{
+    const telemetry_t *t = (const telemetry_t *)object;
+    cJSON *root = cJSON_CreateObject();
+    cJSON *samples = NULL;
+    cJSON *item = NULL;
+    char *out = NULL;
+
+    if ((root == NULL) || (cJSON_AddStringToObject(root, "device", t->device) == NULL)) {
+        goto exit;
+    }
+    samples = cJSON_AddArrayToObject(root, "samples");
+    if (samples == NULL) {
+        goto exit;
+    }
+    for (size_t i = 0; i < t->sample_count; i++) {
+        item = cJSON_CreateObject();
+        if (!cJSON_AddItemToArray(samples, item) ||
+            (cJSON_AddNumberToObject(item, "ts", t->samples[i].ts) == NULL) ||
+            (cJSON_AddNumberToObject(item, "temp", t->samples[i].temp) == NULL) ||
+            (cJSON_AddNumberToObject(item, "hum", t->samples[i].hum) == NULL) ||
+            (cJSON_AddNumberToObject(item, "rssi", t->samples[i].rssi) == NULL) ||
+            (cJSON_AddBoolToObject(item, "ok", t->samples[i].ok) == NULL)) {
+            cJSON_Delete(item);
+            goto exit;
+        }
+    }
+    out = cJSON_PrintUnformatted(root);
+
+exit:
+    cJSON_Delete(root);
+
+    return out;
+}
+
+static bool priv_config_dom_decode(const char *json, size_t len, void *object)
+{
+    config_t *c = (config_t *)object;
+    cJSON *root = cJSON_ParseWithLength(json, len);
+    const cJSON *obj = NULL;
+    const cJSON *item = NULL;
+    bool ok = false;
+
+    if (root == NULL) {
+        return false;
+    }
+
+    obj = cJSON_GetObjectItemCaseSensitive(root, "network");
+    if (!priv_dom_string(obj, "mode", c->network.mode, sizeof(c->network.mode)) ||
+        !priv_dom_bool(obj, "dhcp", &c->network.dhcp) ||
+        !priv_dom_string(obj, "ip", c->network.ip, sizeof(c->network.ip)) ||
+        !priv_dom_string(obj, "netmask", c->network.netmask, sizeof(c->network.netmask)) ||
+        !priv_dom_string(obj, "gateway", c->network.gateway, sizeof(c->network.gateway))) {
+        goto exit;
+    }
+    c->network.dns_count = 0;
+    cJSON_ArrayForEach(item, cJSON_GetObjectItemCaseSensitive(obj, "dns")) {
+        if ((c->network.dns_count >= 2) || !cJSON_IsString(item) ||
+            (strlen(item->valuestring) >= sizeof(c->network.dns[0]))) {
+            goto exit;
+        }
+        strcpy(c->network.dns[c->network.dns_count++], item->valuestring);
+    }
+
+    obj = cJSON_GetObjectItemCaseSensitive(root, "http");
+    if (!priv_dom_int(obj, "port", &c->http.port) ||
+        !priv_dom_int(obj, "max_uri_handlers", &c->http.max_uri_handlers) ||
+        !priv_dom_bool(obj, "auth", &c->http.auth)) {
+        goto exit;
+    }
+
+    obj = cJSON_GetObjectItemCaseSensitive(root, "fs");
+    if (!priv_dom_string(obj, "type", c->fs.type, sizeof(c->fs.type)) ||
+        !priv_dom_int(obj, "max_files", &c->fs.max_files) ||
+        !priv_dom_bool(obj, "format_if_mount_failed", &c->fs.format_if_mount_failed)) {
+        goto exit;
+    }
+    ok = true;
+
+exit:
+    cJSON_Delete(root);
+
+    return ok;
+}
+
+static char *priv_config_dom_encode(const void *object)
+{
+    const config_t *c = (const config_t *)object;
+    cJSON *root = cJSON_CreateObject();
+    cJSON *obj = NULL;
+    cJSON *dns = NULL;
+    char *out = NULL;
+
+    obj = cJSON_AddObjectToObject(root, "network");
+    if ((cJSON_AddStringToObject(obj, "mode", c->network.mode) == NULL) ||
+        (cJSON_AddBoolToObject(obj, "dhcp", c->network.dhcp) == NULL) ||
+        (cJSON_AddStringToObject(obj, "ip", c->network.ip) == NULL) ||
+        (cJSON_AddStringToObject(obj, "netmask", c->network.netmask) == NULL) ||
+        (cJSON_AddStringToObject(obj, "gateway", c->network.gateway) == NULL)) {
+        goto exit;
+    }
+    dns = cJSON_AddArrayToObject(obj, "dns");
+    for (size_t i = 0; i < c->network.dns_count; i++) {
+        if (!cJSON_AddItemToArray(dns, cJSON_CreateString(c->network.dns[i]))) {
+            goto exit;
+        }
+    }
+
+    obj = cJSON_AddObjectToObject(root, "http");
+    if ((cJSON_AddNumberToObject(obj, "port", c->http.port) == NULL) ||
+        (cJSON_AddNumberToObject(obj, "max_uri_handlers", c->http.max_uri_handlers) == NULL) ||
+        (cJSON_AddBoolToObject(obj, "auth", c->http.auth) == NULL)) {
+        goto exit;
+    }
+
+    obj = cJSON_AddObjectToObject(root, "fs");
+    if ((cJSON_AddStringToObject(obj, "type", c->fs.type) == NULL) ||
+        (cJSON_AddNumberToObject(obj, "max_files", c->fs.max_files) == NULL) ||
+        (cJSON_AddBoolToObject(obj, "format_if_mount_failed", c->fs.format_if_mount_failed) == NULL)) {
+        goto exit;
+    }
+    out = cJSON_PrintUnformatted(root);
+
+exit:
+    cJSON_Delete(root);
+
+    return out;
+}
+
+typedef struct {
+    const char *file;
+    const cJSON_BindField *fields;
+    size_t field_count;
+    size_t size;
+    bool (*dom_decode)(const char *json, size_t len, void *object);
+    char *(*dom_encode)(const void *object);
+} bench_bind_doc_t;
+
+static const bench_bind_doc_t s_docs[] = {
+    { "telemetry.json", s_telemetry_fields, CJSON_BIND_COUNT(s_telemetry_fields), sizeof(telemetry_t),
+      priv_telemetry_dom_decode, priv_telemetry_dom_encode },
+    { "config.json", s_config_fields, CJSON_BIND_COUNT(s_config_fields), sizeof(config_t),
+      priv_config_dom_decode, priv_config_dom_encode },
+};
+
+typedef struct {
+    int iterations;
+    int docs;
+} bench_bind_ctx_t;
+
+static int priv_bind_encode(const bench_bind_doc_t *doc, const void *object, char *buf, size_t size)
+{
+    cJSON_Writer writer;
+
+    cJSON_WriterInit(&writer, buf, size, NULL, NULL);
+    cJSON_BindWrite(&writer, doc->fields, doc->field_count, object);
+    if (!cJSON_WriterFinish(&writer) || (writer.length >= size)) {
+        return -1;
+    }
+    buf[writer.length] = '\0';
+
+    return (int)writer.length;
+}
+
+static int priv_bench_doc(const char *name, const char *json, size_t len, void *user)
+{
+    bench_bind_ctx_t *bench = (bench_bind_ctx_t *)user;
+    int iterations = bench->iterations;
+    const bench_bind_doc_t *doc = NULL;
+    void *bind_obj = NULL;
+    void *dom_obj = NULL;
+    char *bind_out = NULL;
+    char *dom_out = NULL;
+    size_t out_size = len * 2 + 1;
+    int out_len = 0;
+
+    uint32_t bind_decode_allocs = 0;
+    size_t bind_decode_peak = 0;
+    uint32_t dom_decode_allocs = 0;
+    size_t dom_decode_peak = 0;
+    uint32_t dom_encode_allocs = 0;
+    size_t dom_encode_peak = 0;
+    int64_t bind_decode_us = 0;
+    int64_t dom_decode_us = 0;
+    int64_t bind_encode_us = 0;
+    int64_t dom_encode_us = 0;
+    int64_t start = 0;
+    int ret = -1;
+
+    for (size_t i = 0; i < sizeof(s_docs) / sizeof(s_docs[0]); i++) {
+        if (strcmp(name, s_docs[i].file) == 0) {
+            doc = &s_docs[i];
+        }
+    }
+    if (doc == NULL) {
+        return 0;
+    }
+
+    /* 清零后再解码, 两边的结构体可以直接比较 */
+    bind_obj = calloc(1, doc->size);
+    dom_obj = calloc(1, doc->size);
+    bind_out = (char *)malloc(out_size);
+    if ((bind_obj == NULL) || (dom_obj == NULL) || (bind_out == NULL)) {
+        goto exit;
+    }
+
+    bench_alloc_reset();
+    if (!cJSON_BindParse(doc->fields, doc->field_count, bind_obj, json, len)) {
+        printf("%-16s bind decode failed\n", name);
+        goto exit;
+    }
+    bind_decode_allocs = bench_alloc_get()->count;
+    bind_decode_peak = bench_alloc_get()->peak - bench_alloc_get()->used;
+
+    bench_alloc_reset();
+    if (!doc->dom_decode(json, len, dom_obj)) {
+        printf("%-16s dom decode failed\n", name);
+        goto exit;
+    }
+    dom_decode_allocs = bench_alloc_get()->count;
+    dom_decode_peak = bench_alloc_get()->peak - bench_alloc_get()->used;
+
+    if (memcmp(bind_obj, dom_obj, doc->size) != 0) {
+        printf("%-16s bind and dom decode differ\n", name);
+        goto exit;
+    }
+
+    out_len = priv_bind_encode(doc, bind_obj, bind_out, out_size);
+    if (out_len < 0) {
+        printf("%-16s bind encode failed\n", name);
+        goto exit;
+    }
+
+    bench_alloc_reset();
+    dom_out = doc->dom_encode(dom_obj);
+    dom_encode_allocs = bench_alloc_get()->count;
+    dom_encode_peak = bench_alloc_get()->peak - bench_alloc_get()->used;
+    if ((dom_out == NULL) || (strcmp(bind_out, dom_out) != 0)) {
+        printf("%-16s bind and dom encode differ\n", name);
+        goto exit;
+    }
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        cJSON_BindParse(doc->fields, doc->field_count, bind_obj, json, len);
+    }
+    bind_decode_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        doc->dom_decode(json, len, dom_obj);
+    }
+    dom_decode_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        priv_bind_encode(doc, bind_obj, bind_out, out_size);
+    }
+    bind_encode_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        cJSON_free(doc->dom_encode(dom_obj));
+    }
+    dom_encode_us = bench_now_us() - start;
+
+    printf("%-16s %6zu B | decode bind %7.2f MB/s %3u allocs peak %6zu B, dom %7.2f MB/s %4u allocs peak %6zu B | "
+           "encode bind %7.2f MB/s, dom %7.2f MB/s %4u allocs peak %6zu B\n",
+           name, len,
+           bench_mbps(len, iterations, bind_decode_us), bind_decode_allocs, bind_decode_peak,
+           bench_mbps(len, iterations, dom_decode_us), dom_decode_allocs, dom_decode_peak,
+           bench_mbps(out_len, iterations, bind_encode_us),
+           bench_mbps(out_len, iterations, dom_encode_us), dom_encode_allocs, dom_encode_peak);
+    bench->docs++;
+    ret = 0;
+
+exit:
+    cJSON_free(dom_out);
+    free(bind_out);
+    free(dom_obj);
+    free(bind_obj);
+
+    return ret;
+}
+
+/* 整数按成员的大小和符号检查范围, 超出范围的解码失败, 不截断 */
+static int priv_check_integers(void)
+{
+    static const struct {
+        const char *json;
+        bool ok;
+    } cases[] = {
+        { "{\"i8\":-128,\"u8\":255,\"s\":-32768,\"u16\":65535}", true },
+        { "{\"i8\":128}", false },
+        { "{\"u8\":256}", false },
+        { "{\"u8\":-1}", false },
+        { "{\"s\":70000}", false },
+        { "{\"u16\":1.5}", false },
+        { "{\"i32\":-2147483648,\"u32\":4294967295}", true },
+        { "{\"i32\":2147483648}", false },
+        { "{\"u32\":4294967296}", false },
+        { "{\"i64\":-9223372036854775808,\"u64\":18446744073709551615}", true },
+        { "{\"i64\":9223372036854775808}", false },
+        { "{\"u64\":18446744073709551616}", false },
+        { "{\"u32\":1e3,\"u8\":-0}", true },
+    };
+    static const char expect[] = "{\"i8\":-128,\"u8\":200,\"s\":-32768,\"u16\":65535,\"i32\":-2147483648,"
+                                 "\"u32\":4294967295,\"i64\":-9223372036854775808,\"u64\":18446744073709551615}";
+    integers_t integers;
+    cJSON_Writer writer;
+    char buf[256];
+    int ret = 0;
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        memset(&integers, 0, sizeof(integers));
+        if (cJSON_BindParse(s_integers_fields, CJSON_BIND_COUNT(s_integers_fields), &integers,
+                            cases[i].json, strlen(cases[i].json)) != cases[i].ok) {
+            printf("integers %s: bind decode %s\n", cases[i].json, cases[i].ok ? "failed" : "accepted");
+            ret = -1;
+        }
+    }
+
+    integers.i8 = INT8_MIN;
+    integers.u8 = 200;
+    integers.s = -32768;
+    integers.u16 = UINT16_MAX;
+    integers.i32 = INT32_MIN;
+    integers.u32 = UINT32_MAX;
+    integers.i64 = INT64_MIN;
+    integers.u64 = UINT64_MAX;
+    cJSON_WriterInit(&writer, buf, sizeof(buf), NULL, NULL);
+    if (!cJSON_BindWrite(&writer, s_integers_fields, CJSON_BIND_COUNT(s_integers_fields), &integers) ||
+        !cJSON_WriterFinish(&writer) || (writer.length >= sizeof(buf))) {
+        printf("integers: bind encode failed\n");
+        return -1;
+    }
+    buf[writer.length] = '\0';
+    if (strcmp(buf, expect) != 0) {
+        printf("integers: bind encode %s\n", buf);
+        ret = -1;
+    }
+
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    bench_bind_ctx_t bench = {0};
+    cJSON_Hooks hooks = {
+        .malloc_fn = bench_malloc,
+        .free_fn = bench_free,
+    };
+    const char *dir = BENCH_CORPUS_DIR "/json";
+    int i = bench_parse_args(argc, argv, &bench.iterations);
+
+    if (i < argc) {
+        dir = argv[i];
+    }
+
+    /* 两条路径都走同一个计数分配器 */
+    cJSON_InitHooks(&hooks);
+
+    if (priv_check_integers() != 0) {
+        return 1;
+    }
+
+    printf("corpus %s, %d iterations\n", dir, bench.iterations);
+
+    if (bench_for_each_file(dir, priv_bench_doc, &bench) < 0) {
+        return 1;
+    }
+
+    return (bench.docs == (int)(sizeof(s_docs) / sizeof(s_docs[0]))) ? 0 : 1;
+}
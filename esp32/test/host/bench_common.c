@@ -0,0 +1,181 @@
+/*
+ * bench_common.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "bench_common.h"
+
+#define BENCH_FILES_MAX     64
+#define BENCH_PATH_LEN      512
+
+/* 分配前加一个头记录大小, 释放时扣除 */
+typedef union {
+    size_t size;
+    max_align_t align;
+} bench_hdr_t;
+
+static bench_alloc_t s_alloc = {0};
+
+void *bench_malloc(size_t size)
+{
+    bench_hdr_t *hdr = (bench_hdr_t *)malloc(sizeof(bench_hdr_t) + size);
+
+    if (hdr == NULL) {
+        return NULL;
+    }
+
+    hdr->size = size;
+    s_alloc.count++;
+    s_alloc.used += size;
+    if (s_alloc.used > s_alloc.peak) {
+        s_alloc.peak = s_alloc.used;
+    }
+
+    return hdr + 1;
+}
+
+void bench_free(void *ptr)
+{
+    bench_hdr_t *hdr = NULL;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    hdr = (bench_hdr_t *)ptr - 1;
+    s_alloc.used -= hdr->size;
+    free(hdr);
+}
+
+void bench_alloc_reset(void)
+{
+    /* 还没释放的内存继续计入 used */
+    s_alloc.count = 0;
+    s_alloc.peak = s_alloc.used;
+}
+
+const bench_alloc_t *bench_alloc_get(void)
+{
+    return &s_alloc;
+}
+
+int64_t bench_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+double bench_mbps(size_t len, int iterations, int64_t us)
+{
+    if (us <= 0) {
+        return 0;
+    }
+
+    return ((double)len * iterations) / (double)us;
+}
+
+int bench_parse_args(int argc, char **argv, int *iterations)
+{
+    int i = 1;
+
+    *iterations = BENCH_DEFAULT_ITERATIONS;
+    if ((argc > 2) && (strcmp(argv[1], "-n") == 0)) {
+        *iterations = atoi(argv[2]);
+        if (*iterations <= 0) {
+            *iterations = 1;
+        }
+        i = 3;
+    }
+
+    return i;
+}
+
+static int priv_name_cmp(const void *a, const void *b)
+{
+    return strcmp((const char *)a, (const char *)b);
+}
+
+static char *priv_read_file(const char *path, size_t *len)
+{
+    FILE *fp = NULL;
+    char *buf = NULL;
+    long size = 0;
+
+    fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    buf = (char *)malloc(size + 1);
+    if ((buf != NULL) && (fread(buf, 1, size, fp) != (size_t)size)) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(fp);
+
+    if (buf != NULL) {
+        buf[size] = '\0';
+        *len = size;
+    }
+
+    return buf;
+}
+
+int bench_for_each_file(const char *dir, bench_file_cb_t cb, void *user)
+{
+    static char names[BENCH_FILES_MAX][256];
+    char path[BENCH_PATH_LEN];
+    struct dirent *entry = NULL;
+    struct stat st;
+    DIR *dp = NULL;
+    char *data = NULL;
+    size_t len = 0;
+    int count = 0;
+
+    dp = opendir(dir);
+    if (dp == NULL) {
+        fprintf(stderr, "open %s failed\n", dir);
+        return -1;
+    }
+
+    while (((entry = readdir(dp)) != NULL) && (count < BENCH_FILES_MAX)) {
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        if ((stat(path, &st) == 0) && S_ISREG(st.st_mode)) {
+            snprintf(names[count++], sizeof(names[0]), "%s", entry->d_name);
+        }
+    }
+    closedir(dp);
+
+    qsort(names, count, sizeof(names[0]), priv_name_cmp);
+
+    for (int i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        data = priv_read_file(path, &len);
+        if (data == NULL) {
+            fprintf(stderr, "read %s failed\n", path);
+            return -1;
+        }
+        if (cb(names[i], data, len, user) != 0) {
+            free(data);
+            return -1;
+        }
+        free(data);
+    }
+
+    return count;
+}
@@ -0,0 +1,64 @@
+/*
+ * bench_common.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ */
+#ifndef __BENCH_COMMON_H__
+#define __BENCH_COMMON_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_DEFAULT_ITERATIONS    1000
+
+typedef struct {
+    uint32_t count; /* allocations */
+    size_t used;
+    size_t peak;
+} bench_alloc_t;
+
+/* Called for every corpus file, return non-zero to stop */
+typedef int (*bench_file_cb_t)(const char *name, const char *data, size_t len, void *user);
+
+/**
+ * @brief Counting allocator, usable as cJSON hooks
+ */
+void *bench_malloc(size_t size);
+void bench_free(void *ptr);
+void bench_alloc_reset(void);
+const bench_alloc_t *bench_alloc_get(void);
+
+/**
+ * @brief Monotonic time in microseconds
+ */
+int64_t bench_now_us(void);
+
+/**
+ * @brief Throughput in MB/s
+ */
+double bench_mbps(size_t len, int iterations, int64_t us);
+
+/**
+ * @brief Parse "-n <iterations>" from the command line
+ * @return Index of the first other argument
+ */
+int bench_parse_args(int argc, char **argv, int *iterations);
+
+/**
+ * @brief Call cb for every regular file in dir, sorted by name
+ * @return
+ *  - Number of files: success
+ *  - -1: failure
+ */
+int bench_for_each_file(const char *dir, bench_file_cb_t cb, void *user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_COMMON_H__ */
@@ -0,0 +1,190 @@
+/*
+ * bench_json.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ *
+ * cJSON parse/print/validate/minify/SAX throughput, allocations and peak memory per document,
+ * JSON vs CBOR size and speed. Usage: bench_json [-n iterations] [corpus dir]
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "cJSON_Sax.h"
+#include "cJSON_Cbor.h"
+#include "bench_common.h"
+
+typedef struct {
+    int iterations;
+} bench_json_ctx_t;
+
+static int priv_bench_doc(const char *name, const char *json, size_t len, void *user)
+{
+    bench_json_ctx_t *bench = (bench_json_ctx_t *)user;
+    int iterations = bench->iterations;
+    cJSON_Hooks hooks = {
+        .malloc_fn = bench_malloc,
+        .free_fn = bench_free,
+    };
+    cJSON_Context ctx;
+    cJSON_SaxParser parser;
+    cJSON *item = NULL;
+    cJSON *copy = NULL;
+    char *out = NULL;
+    char *minify = NULL;
+    unsigned char *cbor = NULL;
+    size_t cbor_len = 0;
+    size_t out_len = 0;
+
+    uint32_t parse_allocs = 0;
+    size_t parse_peak = 0;
+    size_t tree_bytes = 0;
+    uint32_t print_allocs = 0;
+    size_t print_peak = 0;
+    int64_t parse_us = 0;
+    int64_t print_us = 0;
+    int64_t validate_us = 0;
+    int64_t minify_us = 0;
+    int64_t sax_us = 0;
+    int64_t encode_us = 0;
+    int64_t decode_us = 0;
+    int64_t start = 0;
+    int ret = -1;
+
+    cJSON_InitContext(&ctx, &hooks);
+
+    /* 单独跑一次统计分配次数和内存占用 */
+    bench_alloc_reset();
+    item = cJSON_ParseWithContext(&ctx, json, len, NULL, false);
+    if (item == NULL) {
+        printf("%-16s parse failed at offset %d\n", name, (ctx.error_ptr != NULL) ? (int)(ctx.error_ptr - json) : -1);
+        return -1;
+    }
+    parse_allocs = bench_alloc_get()->count;
+    parse_peak = bench_alloc_get()->peak;
+    tree_bytes = bench_alloc_get()->used;
+
+    bench_alloc_reset();
+    out = cJSON_PrintWithContext(&ctx, item, false);
+    print_allocs = bench_alloc_get()->count;
+    print_peak = bench_alloc_get()->peak - tree_bytes;
+    if (out == NULL) {
+        printf("%-16s print failed\n", name);
+        goto exit;
+    }
+    out_len = strlen(out);
+
+    /* 打印结果必须能还原同一棵树 */
+    copy = cJSON_ParseWithLength(out, out_len);
+    if ((copy == NULL) || !cJSON_Compare(item, copy, true)) {
+        printf("%-16s print does not round-trip\n", name);
+        goto exit;
+    }
+    bench_free(out);
+    out = NULL;
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        cJSON_DeleteWithContext(&ctx, cJSON_ParseWithContext(&ctx, json, len, NULL, false));
+    }
+    parse_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        bench_free(cJSON_PrintWithContext(&ctx, item, false));
+    }
+    print_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        if (!cJSON_ValidateWithLength(json, len)) {
+            printf("%-16s validate failed\n", name);
+            goto exit;
+        }
+    }
+    validate_us = bench_now_us() - start;
+
+    /* 原地压缩, 每次都从原文复制, 复制的时间也计算在内 */
+    minify = (char *)malloc(len + 1);
+    if (minify == NULL) {
+        goto exit;
+    }
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        memcpy(minify, json, len);
+        minify[len] = '\0';
+        cJSON_Minify(minify);
+    }
+    minify_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        cJSON_SaxInit(&parser, NULL, NULL);
+        if ((cJSON_SaxFeed(&parser, json, len) < 0) || (cJSON_SaxFinish(&parser) != cJSON_SaxDone)) {
+            printf("%-16s sax failed\n", name);
+            goto exit;
+        }
+    }
+    sax_us = bench_now_us() - start;
+
+    cbor_len = cJSON_CborEncode(item, NULL, 0);
+    cbor = (unsigned char *)malloc(cbor_len);
+    if ((cbor_len == 0) || (cbor == NULL)) {
+        printf("%-16s cbor encode failed\n", name);
+        goto exit;
+    }
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        cJSON_CborEncode(item, cbor, cbor_len);
+    }
+    encode_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int i = 0; i < iterations; i++) {
+        cJSON_Delete(cJSON_CborDecode(cbor, cbor_len, NULL));
+    }
+    decode_us = bench_now_us() - start;
+
+    printf("%-16s %6zu B | parse %7.2f MB/s %5u allocs peak %6zu B | print %7.2f MB/s %3u allocs peak %6zu B | "
+           "validate %7.2f MB/s | minify %7.2f MB/s | sax %7.2f MB/s | tree %6zu B | "
+           "cbor %6zu B (%3d%%) encode %7.2f MB/s decode %7.2f MB/s\n",
+           name, len,
+           bench_mbps(len, iterations, parse_us), parse_allocs, parse_peak,
+           bench_mbps(out_len, iterations, print_us), print_allocs, print_peak,
+           bench_mbps(len, iterations, validate_us),
+           bench_mbps(len, iterations, minify_us),
+           bench_mbps(len, iterations, sax_us),
+           tree_bytes,
+           cbor_len, (int)(cbor_len * 100 / out_len),
+           bench_mbps(cbor_len, iterations, encode_us),
+           bench_mbps(cbor_len, iterations, decode_us));
+    ret = 0;
+
+exit:
+    free(cbor);
+    free(minify);
+    bench_free(out);
+    cJSON_Delete(copy);
+    cJSON_DeleteWithContext(&ctx, item);
+
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    bench_json_ctx_t bench;
+    const char *dir = BENCH_CORPUS_DIR "/json";
+    int i = bench_parse_args(argc, argv, &bench.iterations);
+
+    if (i < argc) {
+        dir = argv[i];
+    }
+
+    printf("corpus %s, %d iterations\n", dir, bench.iterations);
+
+    return (bench_for_each_file(dir, priv_bench_doc, &bench) > 0) ? 0 : 1;
+}
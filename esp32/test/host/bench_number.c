@@ -0,0 +1,249 @@
+/*
+ * bench_number.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ *
+ * cJSON_FormatNumber (Grisu2) against the printer it replaced (sprintf "%1.15g", sscanf back,
+ * "%1.17g" if that does not match), and cJSON_ScanNumber against strtod, on several sets of doubles.
+ * Also counts how often each printer is longer than the shortest round-tripping text and how often
+ * its text does not read back as the same double. Usage: bench_number [-n iterations]
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+#include "cJSON.h"
+#include "bench_common.h"
+
+#define NUMBER_COUNT        1024
+#define NUMBER_TEXT_SIZE    CJSON_NUMBER_BUFFER_SIZE
+
+typedef enum {
+    NUMBER_SET_RANDOM = 0, /* any finite bit pattern */
+    NUMBER_SET_UNIT,       /* [0, 1) with 53 random bits */
+    NUMBER_SET_SENSOR,     /* two decimals, like the telemetry values */
+    NUMBER_SET_NUM,
+} number_set_t;
+
+typedef struct {
+    int formatted;
+    int longer;   /* more significant digits than the shortest text */
+    int inexact;  /* text does not read back as the same double */
+    size_t bytes;
+} number_check_t;
+
+static const char *s_set_names[NUMBER_SET_NUM] = {
+    "random",
+    "unit",
+    "sensor",
+};
+
+static uint64_t s_seed = 0x9E3779B97F4A7C15ULL;
+
+/* 累加扫描结果, 防止循环被优化掉 */
+static volatile double s_sink = 0;
+
+static uint64_t priv_rand(void)
+{
+    /* xorshift64, 每次运行的数据都一样 */
+    s_seed ^= s_seed << 13;
+    s_seed ^= s_seed >> 7;
+    s_seed ^= s_seed << 17;
+
+    return s_seed;
+}
+
+static double priv_make_number(number_set_t set)
+{
+    uint64_t bits = 0;
+    double d = 0;
+
+    switch (set) {
+        case NUMBER_SET_RANDOM:
+            do {
+                bits = priv_rand();
+                memcpy(&d, &bits, sizeof(d));
+            } while (!isfinite(d));
+            return d;
+        case NUMBER_SET_UNIT:
+            return (double)(priv_rand() >> 11) / 9007199254740992.0;
+        case NUMBER_SET_SENSOR:
+        default:
+            return (double)((int64_t)(priv_rand() % 20001) - 10000) / 100.0;
+    }
+}
+
+/* 替换前的 compare_double 和 print_number */
+static bool priv_legacy_compare(double a, double b)
+{
+    double max = (fabs(a) > fabs(b)) ? fabs(a) : fabs(b);
+
+    return fabs(a - b) <= (max * DBL_EPSILON);
+}
+
+static int priv_legacy_format(double d, char *buffer)
+{
+    double test = 0.0;
+    int length = 0;
+
+    length = sprintf(buffer, "%1.15g", d);
+    if ((sscanf(buffer, "%lg", &test) != 1) || !priv_legacy_compare(test, d)) {
+        length = sprintf(buffer, "%1.17g", d);
+    }
+
+    return length;
+}
+
+/* 有效数字个数: 去掉符号, 小数点, 指数, 前后的 0 */
+static int priv_digits(const char *text)
+{
+    const char *end = text + strcspn(text, "eE");
+    const char *first = NULL;
+    const char *last = NULL;
+
+    for (const char *p = text; p < end; p++) {
+        if ((*p >= '1') && (*p <= '9')) {
+            if (first == NULL) {
+                first = p;
+            }
+            last = p;
+        }
+    }
+    if (first == NULL) {
+        return 1;
+    }
+
+    return (int)(last - first + 1) - ((memchr(first, '.', last - first) != NULL) ? 1 : 0);
+}
+
+/* 最短的能还原的文本的有效数字个数 */
+static int priv_shortest_digits(double d)
+{
+    char text[NUMBER_TEXT_SIZE];
+
+    for (int precision = 1; precision < 17; precision++) {
+        snprintf(text, sizeof(text), "%.*g", precision, d);
+        if (strtod(text, NULL) == d) {
+            return precision;
+        }
+    }
+
+    return 17;
+}
+
+static void priv_check(double d, const char *text, number_check_t *check)
+{
+    double back = strtod(text, NULL);
+
+    check->formatted++;
+    check->bytes += strlen(text);
+    if (memcmp(&back, &d, sizeof(d)) != 0) {
+        check->inexact++;
+    }
+    if (priv_digits(text) > priv_shortest_digits(d)) {
+        check->longer++;
+    }
+}
+
+static int priv_bench_set(number_set_t set, int iterations)
+{
+    static double numbers[NUMBER_COUNT];
+    static char texts[NUMBER_COUNT][NUMBER_TEXT_SIZE];
+    static size_t lengths[NUMBER_COUNT];
+    number_check_t grisu = {0};
+    number_check_t legacy = {0};
+    char buffer[NUMBER_TEXT_SIZE];
+    double d = 0;
+    int64_t grisu_us = 0;
+    int64_t legacy_us = 0;
+    int64_t scan_us = 0;
+    int64_t strtod_us = 0;
+    int64_t start = 0;
+    int scan_mismatch = 0;
+    long count = (long)iterations * NUMBER_COUNT;
+
+    for (int i = 0; i < NUMBER_COUNT; i++) {
+        numbers[i] = priv_make_number(set);
+
+        lengths[i] = cJSON_FormatNumber(numbers[i], texts[i]);
+        texts[i][lengths[i]] = '\0';
+        priv_check(numbers[i], texts[i], &grisu);
+
+        priv_legacy_format(numbers[i], buffer);
+        priv_check(numbers[i], buffer, &legacy);
+
+        if (!cJSON_ScanNumber(texts[i], lengths[i], &d) || (d != strtod(texts[i], NULL))) {
+            scan_mismatch++;
+        }
+    }
+
+    start = bench_now_us();
+    for (int n = 0; n < iterations; n++) {
+        for (int i = 0; i < NUMBER_COUNT; i++) {
+            cJSON_FormatNumber(numbers[i], buffer);
+        }
+    }
+    grisu_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int n = 0; n < iterations; n++) {
+        for (int i = 0; i < NUMBER_COUNT; i++) {
+            priv_legacy_format(numbers[i], buffer);
+        }
+    }
+    legacy_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int n = 0; n < iterations; n++) {
+        for (int i = 0; i < NUMBER_COUNT; i++) {
+            cJSON_ScanNumber(texts[i], lengths[i], &d);
+            s_sink += d;
+        }
+    }
+    scan_us = bench_now_us() - start;
+
+    start = bench_now_us();
+    for (int n = 0; n < iterations; n++) {
+        for (int i = 0; i < NUMBER_COUNT; i++) {
+            s_sink += strtod(texts[i], NULL);
+        }
+    }
+    strtod_us = bench_now_us() - start;
+
+    printf("%-8s | format grisu2 %7.1f ns %5.2f B longer %4d inexact %4d, sprintf %7.1f ns %5.2f B longer %4d inexact %4d | "
+           "scan cJSON %7.1f ns, strtod %7.1f ns\n",
+           s_set_names[set],
+           (double)grisu_us * 1000.0 / count, (double)grisu.bytes / grisu.formatted, grisu.longer, grisu.inexact,
+           (double)legacy_us * 1000.0 / count, (double)legacy.bytes / legacy.formatted, legacy.longer, legacy.inexact,
+           (double)scan_us * 1000.0 / count, (double)strtod_us * 1000.0 / count);
+
+    /* Grisu2 必须总能还原, 扫描结果必须和 strtod 一致 */
+    if ((grisu.inexact != 0) || (scan_mismatch != 0)) {
+        printf("%-8s grisu2 inexact %d, scan mismatch %d\n", s_set_names[set], grisu.inexact, scan_mismatch);
+        return -1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 0;
+    int ret = 0;
+
+    bench_parse_args(argc, argv, &iterations);
+
+    printf("%d numbers per set, %d iterations\n", NUMBER_COUNT, iterations);
+
+    for (int set = 0; set < NUMBER_SET_NUM; set++) {
+        if (priv_bench_set((number_set_t)set, iterations) != 0) {
+            ret = 1;
+        }
+    }
+
+    return ret;
+}
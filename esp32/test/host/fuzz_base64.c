@@ -0,0 +1,57 @@
+/*
+ * fuzz_base64.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ *
+ * b64_to_bin on raw input, and bin_to_b64 followed by b64_to_bin must give back the input.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base64.h"
+
+#define FUZZ_BASE64_MAX     65536
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    uint8_t *bin = NULL;
+    char *text = NULL;
+    int text_max = 0;
+    int text_len = 0;
+    int len = 0;
+
+    if (size > FUZZ_BASE64_MAX) {
+        return 0;
+    }
+
+    /* 解码结果不会超过输入长度 */
+    bin = (uint8_t *)malloc(size + 1);
+    if (bin == NULL) {
+        return 0;
+    }
+    len = b64_to_bin((const char *)data, (int)size, bin, (int)size + 1);
+    if (len > (int)size) {
+        abort();
+    }
+
+    text_max = ((size + 2) / 3) * 4 + 1;
+    text = (char *)malloc(text_max);
+    if (text == NULL) {
+        free(bin);
+        return 0;
+    }
+    text_len = bin_to_b64(data, (int)size, text, text_max);
+    if (text_len < 0) {
+        abort();
+    }
+    if ((b64_to_bin(text, text_len, bin, (int)size + 1) != (int)size) || (memcmp(bin, data, size) != 0)) {
+        abort();
+    }
+
+    free(text);
+    free(bin);
+
+    return 0;
+}
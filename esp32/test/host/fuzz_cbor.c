@@ -0,0 +1,78 @@
+/*
+ * fuzz_cbor.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ *
+ * cJSON_CborDecode on raw input. A decoded item must encode, decode and encode again to the same
+ * bytes. The encodings are compared rather than the trees because cJSON_Compare does not handle
+ * duplicate map keys. The streaming CBOR writer must produce a document that decodes to the same encoding.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "cJSON_Cbor.h"
+#include "cJSON_Writer.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    cJSON *item = NULL;
+    cJSON *copy = NULL;
+    unsigned char *buf = NULL;
+    unsigned char *again = NULL;
+    unsigned char *stream = NULL;
+    cJSON *streamed = NULL;
+    cJSON_Writer writer;
+    size_t consumed = 0;
+    size_t len = 0;
+
+    item = cJSON_CborDecode(data, size, &consumed);
+    if (item == NULL) {
+        return 0;
+    }
+    if (consumed > size) {
+        abort();
+    }
+
+    len = cJSON_CborEncode(item, NULL, 0);
+    if (len > 0) {
+        buf = (unsigned char *)malloc(len);
+        if ((buf != NULL) && (cJSON_CborEncode(item, buf, len) == len)) {
+            copy = cJSON_CborDecode(buf, len, &consumed);
+            if ((copy == NULL) || (consumed != len)) {
+                abort();
+            }
+            again = (unsigned char *)malloc(len);
+            if ((again != NULL) &&
+                ((cJSON_CborEncode(copy, again, len) != len) || (memcmp(buf, again, len) != 0))) {
+                abort();
+            }
+
+            /* 不定长容器每个最多多一个字节 */
+            stream = (unsigned char *)malloc(len * 2);
+            if (stream != NULL) {
+                cJSON_WriterInitCbor(&writer, (char *)stream, len * 2, NULL, NULL);
+                if (!cJSON_WriterItem(&writer, item) || !cJSON_WriterFinish(&writer)) {
+                    abort();
+                }
+                streamed = cJSON_CborDecode(stream, writer.length, &consumed);
+                if ((streamed == NULL) || (consumed != writer.length) || (again == NULL) ||
+                    (cJSON_CborEncode(streamed, again, len) != len) || (memcmp(buf, again, len) != 0)) {
+                    abort();
+                }
+            }
+        }
+    }
+
+    cJSON_Delete(streamed);
+    free(stream);
+    free(again);
+    cJSON_Delete(copy);
+    free(buf);
+    cJSON_Delete(item);
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * fuzz_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ *
+ * Replays files (or all files of directories) through a fuzz target when libFuzzer is not available,
+ * so every target also runs as a regression test on its seed corpus.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static int priv_run_file(const char *path)
+{
+    FILE *fp = NULL;
+    uint8_t *buf = NULL;
+    long size = 0;
+
+    fp = fopen(path, "rb");
+    if (fp == NULL) {
+        fprintf(stderr, "open %s failed\n", path);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    /* 按实际大小申请, 越界读能被 ASan 发现 */
+    buf = (uint8_t *)malloc((size > 0) ? size : 1);
+    if ((buf == NULL) || (fread(buf, 1, size, fp) != (size_t)size)) {
+        fprintf(stderr, "read %s failed\n", path);
+        free(buf);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+
+    LLVMFuzzerTestOneInput(buf, size);
+    free(buf);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    char path[512];
+    struct dirent *entry = NULL;
+    struct stat st;
+    DIR *dp = NULL;
+    int count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if ((stat(argv[i], &st) == 0) && S_ISDIR(st.st_mode)) {
+            dp = opendir(argv[i]);
+            while ((dp != NULL) && ((entry = readdir(dp)) != NULL)) {
+                snprintf(path, sizeof(path), "%s/%s", argv[i], entry->d_name);
+                if ((stat(path, &st) == 0) && S_ISREG(st.st_mode)) {
+                    if (priv_run_file(path) != 0) {
+                        closedir(dp);
+                        return 1;
+                    }
+                    count++;
+                }
+            }
+            if (dp != NULL) {
+                closedir(dp);
+            }
+        } else {
+            if (priv_run_file(argv[i]) != 0) {
+                return 1;
+            }
+            count++;
+        }
+    }
+
+    printf("%d inputs\n", count);
+
+    return (count > 0) ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+/*
+ * fuzz_minify.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ *
+ * cJSON_Minify in place. Minifying never grows the text, and a document that parsed before
+ * still parses afterwards and prints to the same text as before.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    cJSON *before = NULL;
+    cJSON *after = NULL;
+    char *text = NULL;
+    char *out_before = NULL;
+    char *out_after = NULL;
+
+    text = (char *)malloc(size + 1);
+    if (text == NULL) {
+        return 0;
+    }
+    memcpy(text, data, size);
+    text[size] = '\0';
+
+    before = cJSON_Parse(text);
+    cJSON_Minify(text);
+    if (strlen(text) > size) {
+        abort();
+    }
+
+    if (before != NULL) {
+        after = cJSON_Parse(text);
+        if (after == NULL) {
+            abort();
+        }
+        out_before = cJSON_PrintUnformatted(before);
+        out_after = cJSON_PrintUnformatted(after);
+        if ((out_before != NULL) && (out_after != NULL) && (strcmp(out_before, out_after) != 0)) {
+            abort();
+        }
+    }
+
+    cJSON_free(out_after);
+    cJSON_free(out_before);
+    cJSON_Delete(after);
+    cJSON_Delete(before);
+    free(text);
+
+    return 0;
+}
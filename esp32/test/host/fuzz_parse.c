@@ -0,0 +1,61 @@
+/*
+ * fuzz_parse.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ *
+ * cJSON_ParseWithLength on raw input, cJSON_Parse on a terminated copy. A parsed document must
+ * print to text that parses and prints to the same text. The printed text is compared rather than
+ * the trees: numbers out of double range print as null, and cJSON_Compare does not handle
+ * duplicate object keys.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    cJSON *item = NULL;
+    cJSON *copy = NULL;
+    char *text = NULL;
+    char *out = NULL;
+    char *again = NULL;
+
+    item = cJSON_ParseWithLength((const char *)data, size);
+
+    text = (char *)malloc(size + 1);
+    if (text == NULL) {
+        cJSON_Delete(item);
+        return 0;
+    }
+    memcpy(text, data, size);
+    text[size] = '\0';
+    cJSON_Delete(cJSON_Parse(text));
+    free(text);
+
+    if (item == NULL) {
+        return 0;
+    }
+
+    out = cJSON_PrintUnformatted(item);
+    if (out != NULL) {
+        copy = cJSON_Parse(out);
+        if (copy == NULL) {
+            abort();
+        }
+        again = cJSON_PrintUnformatted(copy);
+        if ((again != NULL) && (strcmp(out, again) != 0)) {
+            abort();
+        }
+    }
+
+    cJSON_free(again);
+    cJSON_Delete(copy);
+    cJSON_free(out);
+    cJSON_Delete(item);
+
+    return 0;
+}
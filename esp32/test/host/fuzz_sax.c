@@ -0,0 +1,116 @@
+/*
+ * fuzz_sax.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * SPDX-FileCopyrightText: 2026 Zeepunt
+ *
+ * cJSON_SaxFeed with all callbacks set. The first byte picks a chunk size, the result must not depend
+ * on how the input is split. Long strings arrive in pieces that must fit the token buffer.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON_Sax.h"
+
+static cJSON_bool priv_event(void *user)
+{
+    (*(size_t *)user)++;
+    return true;
+}
+
+static cJSON_bool priv_string(void *user, const char *value, size_t length)
+{
+    /* 长度必须和终止符一致 */
+    if (value[length] != '\0') {
+        abort();
+    }
+    (*(size_t *)user)++;
+    return true;
+}
+
+static cJSON_bool priv_string_part(void *user, const char *value, size_t length, cJSON_bool more)
+{
+    if ((value[length] != '\0') || (length > CJSON_SAX_TOKEN_SIZE) || (more && (length == 0))) {
+        abort();
+    }
+    (*(size_t *)user)++;
+    return true;
+}
+
+static cJSON_bool priv_number(void *user, double value, const char *text, size_t length)
+{
+    (void)value;
+    (void)text;
+    (void)length;
+    (*(size_t *)user)++;
+    return true;
+}
+
+static cJSON_bool priv_boolean(void *user, cJSON_bool value)
+{
+    (void)value;
+    (*(size_t *)user)++;
+    return true;
+}
+
+static const cJSON_SaxCallbacks s_callbacks = {
+    priv_event,
+    priv_event,
+    priv_event,
+    priv_event,
+    priv_string,
+    priv_string,
+    priv_number,
+    priv_boolean,
+    priv_event,
+    priv_string_part,
+};
+
+static cJSON_SaxStatus priv_feed(const char *data, size_t size, size_t chunk, size_t *events)
+{
+    cJSON_SaxParser parser;
+    cJSON_SaxStatus status = cJSON_SaxOk;
+    size_t offset = 0;
+    size_t len = 0;
+
+    cJSON_SaxInit(&parser, &s_callbacks, events);
+
+    while ((offset < size) && (status >= 0)) {
+        len = ((size - offset) < chunk) ? (size - offset) : chunk;
+        status = cJSON_SaxFeed(&parser, data + offset, len);
+        offset += len;
+    }
+
+    if (status >= 0) {
+        status = cJSON_SaxFinish(&parser);
+    }
+
+    return status;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    cJSON_SaxStatus whole = cJSON_SaxOk;
+    cJSON_SaxStatus split = cJSON_SaxOk;
+    size_t whole_events = 0;
+    size_t split_events = 0;
+    size_t chunk = 0;
+
+    if (size == 0) {
+        return 0;
+    }
+
+    chunk = (data[0] % 16) + 1;
+    data++;
+    size--;
+
+    whole = priv_feed((const char *)data, size, (size > 0) ? size : 1, &whole_events);
+    split = priv_feed((const char *)data, size, chunk, &split_events);
+    if ((whole != split) || ((whole == cJSON_SaxDone) && (whole_events != split_events))) {
+        abort();
+    }
+
+    return 0;
+}